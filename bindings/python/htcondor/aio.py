@@ -0,0 +1,204 @@
+# Copyright 2021 HTCondor Team, Computer Sciences Department,
+# University of Wisconsin-Madison, WI.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+:mod:`asyncio` front-ends for :class:`htcondor.Schedd` and
+:class:`htcondor.Collector`.
+
+Every call into the bindings, including the ones that only check on a
+query in progress, is made on a pool of background I/O threads, so the event
+loop never waits on the module lock.  Schedd queries are streamed: once the
+query has been sent, the event loop watches the query's socket and only asks
+an I/O thread to read ads when some have arrived, so the results from many
+schedds are read concurrently.  The bindings release the module lock while a
+query waits for its schedd or collector to answer, so other calls made
+meanwhile run in parallel with it; calls that change the queue, such as
+submit, act and edit, still take turns.
+"""
+
+import asyncio
+import concurrent.futures
+import functools
+import logging
+from typing import Any, AsyncIterator, Iterable, List, Optional
+
+import classad
+import htcondor
+
+__all__ = ["AsyncSchedd", "AsyncCollector"]
+
+logger = logging.getLogger(__name__)
+
+# Each coroutine awaits its own calls one at a time, so they stay in order;
+# calls from different coroutines may run at once, and the bindings only
+# serialize them where they must.
+_MAX_WORKERS = 8
+_EXECUTOR = concurrent.futures.ThreadPoolExecutor(
+    max_workers=_MAX_WORKERS, thread_name_prefix="htcondor-aio"
+)
+
+
+def _run(func, *args, **kwargs) -> "asyncio.Future":
+    loop = asyncio.get_running_loop()
+    return loop.run_in_executor(_EXECUTOR, functools.partial(func, *args, **kwargs))
+
+
+async def _readable(fd: int) -> None:
+    loop = asyncio.get_running_loop()
+    ready = loop.create_future()
+
+    def on_ready():
+        if not ready.done():
+            ready.set_result(None)
+
+    loop.add_reader(fd, on_ready)
+    try:
+        await ready
+    finally:
+        loop.remove_reader(fd)
+
+
+def _next_batch(query: "htcondor.QueryIterator"):
+    # runs on an I/O thread, since done() and watch() are binding calls too
+    ads = query.nextAdsNonBlocking()
+    done = query.done()
+    fd = -1 if done or ads else query.watch()
+    return ads, done, fd
+
+
+async def _stream(query: "htcondor.QueryIterator") -> AsyncIterator[List[classad.ClassAd]]:
+    """
+    Yield batches of ads from a query iterator as they arrive, without
+    blocking the event loop while the schedd is still producing them.
+    """
+    while True:
+        ads, done, fd = await _run(_next_batch, query)
+        if ads:
+            yield ads
+        if done:
+            return
+        if not ads:
+            await _readable(fd)
+
+
+class AsyncSchedd:
+    """
+    An :mod:`asyncio` wrapper around a :class:`htcondor.Schedd`.
+
+    :param schedd: The schedd to talk to.  If omitted, the local
+        schedd is used.
+    """
+
+    def __init__(self, schedd: Optional["htcondor.Schedd"] = None):
+        self._schedd = schedd
+
+    async def _get_schedd(self) -> "htcondor.Schedd":
+        if self._schedd is None:
+            self._schedd = await _run(htcondor.Schedd)
+        return self._schedd
+
+    async def xquery(
+        self,
+        constraint: Any = "true",
+        projection: Iterable[str] = (),
+        limit: int = -1,
+        opts: "htcondor.QueryOpts" = htcondor.QueryOpts.Default,
+    ) -> AsyncIterator[classad.ClassAd]:
+        """
+        Query the schedd for job ads, yielding each ad as it arrives.
+        The arguments are the same as for :meth:`htcondor.Schedd.xquery`.
+        """
+        schedd = await self._get_schedd()
+        query = await _run(schedd.xquery, constraint, list(projection), limit, opts)
+        async for ads in _stream(query):
+            for ad in ads:
+                yield ad
+
+    async def query(
+        self,
+        constraint: Any = "true",
+        projection: Iterable[str] = (),
+        limit: int = -1,
+        opts: "htcondor.QueryOpts" = htcondor.QueryOpts.Default,
+    ) -> List[classad.ClassAd]:
+        """
+        Query the schedd for job ads and return them all as a list.
+        The arguments are the same as for :meth:`htcondor.Schedd.query`.
+        """
+        schedd = await self._get_schedd()
+        query = await _run(schedd.xquery, constraint, list(projection), limit, opts)
+        results = []
+        async for ads in _stream(query):
+            results.extend(ads)
+        return results
+
+    async def submit(self, *args, **kwargs) -> "htcondor.SubmitResult":
+        """
+        Submit jobs; see :meth:`htcondor.Schedd.submit`.
+        """
+        schedd = await self._get_schedd()
+        return await _run(schedd.submit, *args, **kwargs)
+
+    async def act(self, *args, **kwargs) -> classad.ClassAd:
+        """
+        Change the status of jobs; see :meth:`htcondor.Schedd.act`.
+        """
+        schedd = await self._get_schedd()
+        return await _run(schedd.act, *args, **kwargs)
+
+    async def edit(self, *args, **kwargs) -> Any:
+        """
+        Edit job attributes; see :meth:`htcondor.Schedd.edit`.
+        """
+        schedd = await self._get_schedd()
+        return await _run(schedd.edit, *args, **kwargs)
+
+
+class AsyncCollector:
+    """
+    An :mod:`asyncio` wrapper around a :class:`htcondor.Collector`.
+
+    :param collector: The collector to talk to.  If omitted, the pool's
+        collector is used.
+    """
+
+    def __init__(self, collector: Optional["htcondor.Collector"] = None):
+        self._collector = collector
+
+    async def _get_collector(self) -> "htcondor.Collector":
+        if self._collector is None:
+            self._collector = await _run(htcondor.Collector)
+        return self._collector
+
+    async def query(self, *args, **kwargs) -> List[classad.ClassAd]:
+        """
+        Query the collector; see :meth:`htcondor.Collector.query`.
+        """
+        collector = await self._get_collector()
+        return await _run(collector.query, *args, **kwargs)
+
+    async def locate(self, *args, **kwargs) -> classad.ClassAd:
+        """
+        Locate a daemon; see :meth:`htcondor.Collector.locate`.
+        """
+        collector = await self._get_collector()
+        return await _run(collector.locate, *args, **kwargs)
+
+    async def locateAll(self, *args, **kwargs) -> List[classad.ClassAd]:
+        """
+        Locate all daemons of a type; see :meth:`htcondor.Collector.locateAll`.
+        """
+        collector = await self._get_collector()
+        return await _run(collector.locateAll, *args, **kwargs)
@@ -318,6 +318,8 @@ void CollectorDaemon::Init()
 	collectorsToUpdate = NULL;
 	Config();
 
+	daemonCore->Register_Metrics_Pool("", &collectorStats.global.Pool);
+
 	// install command handlers for queries
 	daemonCore->Register_CommandWithPayload(QUERY_STARTD_ADS,"QUERY_STARTD_ADS",
 		receive_query_cedar,"receive_query_cedar",READ);
@@ -64,6 +64,7 @@
 #include <vector>
 #include <memory>
 #include <deque>
+#include <unordered_map>
 
 #include "../condor_procd/proc_family_io.h"
 class ProcFamilyInterface;
@@ -217,12 +218,18 @@ struct FamilyInfo {
 	const char* glexec_proxy;
 	bool want_pid_namespace;
 	const char* cgroup;
+#if defined(LINUX)
+		// directory of a cgroup on the unified (v2) hierarchy that the
+		// child moves itself into before exec
+	const char* cgroup_v2_dir;
+#endif
 
 	FamilyInfo() {
 		max_snapshot_interval = -1;
 		login = NULL;
 #if defined(LINUX)
 		group_ptr = NULL;
+		cgroup_v2_dir = NULL;
 #endif
 		glexec_proxy = NULL;
 		want_pid_namespace = false;
@@ -1607,6 +1614,7 @@ class DaemonCore : public Service
 	   //stats_entry_recent<int64_t> SockBytes;      //  number of bytes passed though the socket (can we do this?)
 	   //stats_entry_recent<int64_t> PipeBytes;      //  number of bytes passed though the socket
 	   stats_entry_recent<int> DebugOuts;      //  number of dprintf calls that were written to output.
+	   stats_entry_recent<int> DebugDrops;     //  number of dprintf calls dropped because the DEBUG_ASYNC buffer was full.
       #ifdef WIN32
 	   stats_entry_recent<int> AsyncPipe;      //  number of times async_pipe was signalled
       #endif
@@ -1619,6 +1627,18 @@ class DaemonCore : public Service
        StatisticsPool          Pool;          // pool of statistics probes and Publish attrib names
        classy_counted_ptr<stats_ema_config> ema_config;	// Exponential moving average config for this pool.
 
+       // per-handler runtime probes, keyed by the probe that AddRuntime updates,
+       // so that we can keep a latency histogram for each one and rank them.
+       struct HandlerProbe {
+          std::string name;   // category and handler name, e.g. "Command_QUERY_JOB_ADS"
+          stats_entry_probe<double> * runtime;
+          stats_entry_recent_histogram<double> * latency;
+          double max_runtime;
+       };
+       std::unordered_map<const void*, HandlerProbe> Handlers;
+       double SlowHandlerThreshold; // log handlers that run at least this many seconds, 0 to disable
+       int    TopHandlersToPublish; // number of handlers to publish in DCTopHandlers
+
 	   time_t InitTime;            // last time we init'ed the structure
 	   time_t RecentStatsTickTime; // time of the latest recent buffer Advance
 	   int    RecentWindowMax;     // size of the time window over which RecentXXX values are calculated.
@@ -1646,9 +1666,20 @@ class DaemonCore : public Service
        double AddSample(const char * name, int as, double val);
        double AddRuntime(const char * name, double before); // returns current time.
        double AddRuntimeSample(const char * name, int as, double before);
+       void PublishTopHandlers(ClassAd & ad) const;
 
 	} dc_stats;
 
+	/** Add a statistics pool to the OpenMetrics output that the daemon
+		serves when METRICS_PORT is set.  The DaemonCore pool is always
+		included.
+		@param prefix Prepended to the pool's attribute names
+		@param pool The pool, which must stay valid until it is removed
+			with Cancel_Metrics_Pool()
+	*/
+	void Register_Metrics_Pool(const char * prefix, const StatisticsPool * pool);
+	void Cancel_Metrics_Pool(const StatisticsPool * pool);
+
 	bool wants_dc_udp_self() const { return m_wants_dc_udp_self;}
   private:      
 
@@ -2186,6 +2217,7 @@ class DaemonCore : public Service
 
 	class CCBListeners *m_ccb_listeners;
 	class SharedPortEndpoint *m_shared_port_endpoint;
+	class MetricsServer *m_metrics_server;
 	MyString m_daemon_sock_name;
 	Sinful m_sinful;     // full contact info (public, private, ccb, etc.)
 	bool m_dirty_sinful; // true if m_sinful needs to be reinitialized
@@ -91,6 +91,7 @@ CRITICAL_SECTION Big_fat_mutex; // coarse grained mutex for debugging purposes
 #include "basename.h"
 #include "condor_threads.h"
 #include "shared_port_endpoint.h"
+#include "metrics_server.h"
 #include "condor_open.h"
 #include "filename_tools.h"
 #include "authentication.h"
@@ -106,6 +107,10 @@ CRITICAL_SECTION Big_fat_mutex; // coarse grained mutex for debugging purposes
 #include <sched.h>
 #endif
 
+#if defined(LINUX)
+#include "cgroup_v2.linux.h"
+#endif
+
 #if !defined(CLONE_NEWPID)
 #define CLONE_NEWPID 0x20000000
 #endif
@@ -464,6 +469,7 @@ DaemonCore::DaemonCore(int ComSize,int SigSize,
 
 	m_ccb_listeners = NULL;
 	m_shared_port_endpoint = NULL;
+	m_metrics_server = NULL;
 	nRegisteredSocks = 0;
 	m_iMaxUdpMsgsPerCycle = 1;
 }
@@ -489,6 +495,11 @@ DaemonCore::~DaemonCore()
 		m_shared_port_endpoint = NULL;
 	}
 
+	if( m_metrics_server ) {
+		delete m_metrics_server;
+		m_metrics_server = NULL;
+	}
+
 #ifndef WIN32
 	close(async_pipe[1]);
 	close(async_pipe[0]);
@@ -2980,6 +2991,24 @@ DaemonCore::thread_switch_callback(void* & incoming_contextVP)
 	last_tid = current_tid;
 }
 
+void
+DaemonCore::Register_Metrics_Pool(const char * prefix, const StatisticsPool * pool)
+{
+	if( !m_metrics_server ) {
+		m_metrics_server = new MetricsServer;
+		m_metrics_server->AddPool("", &dc_stats.Pool);
+	}
+	m_metrics_server->AddPool(prefix, pool);
+}
+
+void
+DaemonCore::Cancel_Metrics_Pool(const StatisticsPool * pool)
+{
+	if( m_metrics_server ) {
+		m_metrics_server->RemovePool(pool);
+	}
+}
+
 void
 DaemonCore::reconfig(void) {
 	// NOTE: this function is always called on initial startup, as well
@@ -2996,6 +3025,12 @@ DaemonCore::reconfig(void) {
     // publication and window size of daemon core stats are controlled by params
     dc_stats.Reconfig();
 
+	if( !m_metrics_server ) {
+		m_metrics_server = new MetricsServer;
+		m_metrics_server->AddPool("", &dc_stats.Pool);
+	}
+	m_metrics_server->Reconfig();
+
 	m_dirty_command_sock_sinfuls = true;
 	DaemonCore::InfoCommandSinfulStringsMyself();
 	m_dirty_sinful = true; // refresh our address in case config changes it
@@ -6427,6 +6462,19 @@ void CreateProcessForkit::exec() {
 		// This _must_ be called before calling exec().
 	writeTrackingGid(tracking_gid);
 
+#if defined(LINUX)
+		// Join the cgroup made for us on the unified hierarchy before
+		// exec, so that everything the child starts is counted there.
+	if ( m_family_info && m_family_info->cgroup_v2_dir ) {
+		priv_state prev_priv = set_priv_no_memory_changes(PRIV_ROOT);
+		if ( ! cgroup_v2_enter(m_family_info->cgroup_v2_dir)) {
+			dprintf(D_ALWAYS, "Create_Process: failed to enter cgroup %s: %s\n",
+				m_family_info->cgroup_v2_dir, strerror(errno));
+		}
+		set_priv_no_memory_changes(prev_priv);
+	}
+#endif
+
 		// Create new filesystem namespace if wanted
 
 	int openfds = getdtablesize();
@@ -840,6 +840,8 @@ DC_Exit( int status, const char *shutdown_program )
 		  cleared out our config hashtable, too.  Derek 2004-11-23
 		*/
 	if ( shutdown_program ) {
+			// exec doesn't run atexit handlers, so write out the debug log now
+		dprintf_async_shutdown();
 #     if (HAVE_EXECL)
 		dprintf( D_ALWAYS, "**** %s (%s_%s) pid %lu EXITING BY EXECING %s\n",
 				 myName, myDistro->Get(), get_mySubSystem()->getName(), pid,
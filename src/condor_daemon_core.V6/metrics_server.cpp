@@ -0,0 +1,298 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_config.h"
+#include "condor_daemon_core.h"
+#include "condor_rw.h"
+#include "condor_ipverify.h"
+#include "authentication.h"
+#include "subsystem_info.h"
+#include "metrics_server.h"
+#include <algorithm>
+
+	// requests larger than this are refused; scrapers send a few hundred bytes
+static const size_t METRICS_MAX_REQUEST = 8192;
+	// and we don't hold more than this many connections open at once
+static const size_t METRICS_MAX_CONNECTIONS = 16;
+	// connections that haven't finished in this many seconds are dropped
+	// to make room for new ones
+static const time_t METRICS_CONNECTION_TIMEOUT = 30;
+
+MetricsServer::MetricsServer()
+	: m_listener(NULL)
+	, m_port(0)
+	, m_loopback_only(true)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+	CloseListener();
+	for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
+		daemonCore->Cancel_Socket(it->first);
+		delete it->first;
+	}
+	m_connections.clear();
+}
+
+void
+MetricsServer::Reconfig()
+{
+	int port = param_integer("METRICS_PORT", 0, 0, 65535);
+	bool loopback_only = param_boolean("METRICS_LOOPBACK_ONLY", true);
+
+	if (m_listener && port == m_port && loopback_only == m_loopback_only) {
+		return;
+	}
+	CloseListener();
+	m_port = port;
+	m_loopback_only = loopback_only;
+	if ( ! m_port) {
+		return;
+	}
+
+	m_listener = new ReliSock();
+	if ( ! m_listener->bind(CP_IPV4, false, m_port, m_loopback_only) || ! m_listener->listen()) {
+		dprintf(D_ALWAYS, "MetricsServer: failed to listen on port %d\n", m_port);
+		delete m_listener;
+		m_listener = NULL;
+		return;
+	}
+
+	int rc = daemonCore->Register_Socket(m_listener, "Metrics listener",
+			(SocketHandlercpp)&MetricsServer::HandleAccept,
+			"MetricsServer::HandleAccept", this);
+	if (rc < 0) {
+		dprintf(D_ALWAYS, "MetricsServer: failed to register listen socket\n");
+		delete m_listener;
+		m_listener = NULL;
+		return;
+	}
+	dprintf(D_ALWAYS, "MetricsServer: serving OpenMetrics on %s\n", m_listener->get_sinful());
+}
+
+void
+MetricsServer::CloseListener()
+{
+	if (m_listener) {
+		daemonCore->Cancel_Socket(m_listener);
+		delete m_listener;
+		m_listener = NULL;
+	}
+}
+
+void
+MetricsServer::AddPool(const char * prefix, const StatisticsPool * pool)
+{
+	RemovePool(pool);
+	m_pools.push_back(std::make_pair(std::string(prefix ? prefix : ""), pool));
+}
+
+void
+MetricsServer::RemovePool(const StatisticsPool * pool)
+{
+	for (auto it = m_pools.begin(); it != m_pools.end(); ++it) {
+		if (it->second == pool) {
+			m_pools.erase(it);
+			return;
+		}
+	}
+}
+
+void
+MetricsServer::DropStaleConnections()
+{
+	time_t now = time(NULL);
+	for (auto it = m_connections.begin(); it != m_connections.end(); ) {
+		if (now - it->second.started < METRICS_CONNECTION_TIMEOUT) {
+			++it;
+			continue;
+		}
+		dprintf(D_FULLDEBUG, "MetricsServer: dropping stalled connection from %s\n", it->first->peer_description());
+		daemonCore->Cancel_Socket(it->first);
+		delete it->first;
+		it = m_connections.erase(it);
+	}
+}
+
+int
+MetricsServer::HandleAccept(Stream * sock)
+{
+	ReliSock * conn = ((ReliSock *)sock)->accept();
+	if ( ! conn) {
+		dprintf(D_ALWAYS, "MetricsServer: accept() failed\n");
+		return KEEP_STREAM;
+	}
+
+		// The requests aren't authenticated, so off the loopback interface
+		// the client's host must be allowed READ access.
+	if ( ! m_loopback_only &&
+		daemonCore->Verify("metrics", READ, conn->peer_addr(), UNAUTHENTICATED_FQU) != USER_AUTH_SUCCESS)
+	{
+		dprintf(D_ALWAYS, "MetricsServer: refusing connection from %s, which is not allowed READ access\n", conn->peer_description());
+		delete conn;
+		return KEEP_STREAM;
+	}
+
+	if (m_connections.size() >= METRICS_MAX_CONNECTIONS) {
+		DropStaleConnections();
+	}
+	if (m_connections.size() >= METRICS_MAX_CONNECTIONS) {
+		dprintf(D_ALWAYS, "MetricsServer: too many open connections, dropping %s\n", conn->peer_description());
+		delete conn;
+		return KEEP_STREAM;
+	}
+
+	int rc = daemonCore->Register_Socket(conn, "Metrics connection",
+			(SocketHandlercpp)&MetricsServer::HandleRequest,
+			"MetricsServer::HandleRequest", this);
+	if (rc < 0) {
+		delete conn;
+		return KEEP_STREAM;
+	}
+	m_connections[conn] = Connection();
+	return KEEP_STREAM;
+}
+
+// Read whatever part of the request has arrived.  Once we have the whole
+// header, build the response and start sending it.
+int
+MetricsServer::HandleRequest(Stream * sock)
+{
+	Connection & connection = m_connections[sock];
+	std::string & request = connection.data;
+	ReliSock * conn = (ReliSock *)sock;
+
+	char buf[1024];
+	int nr = condor_read(conn->peer_description(), conn->get_file_desc(), buf, sizeof(buf), 0, 0, true);
+	if (nr < 0) {
+		m_connections.erase(sock);
+		return FALSE;
+	}
+	request.append(buf, nr);
+
+	size_t eoh = request.find("\r\n\r\n");
+	if (eoh == std::string::npos) {
+		eoh = request.find("\n\n");
+	}
+	if (eoh == std::string::npos) {
+		if (request.size() > METRICS_MAX_REQUEST) {
+			dprintf(D_ALWAYS, "MetricsServer: request from %s is too large\n", conn->peer_description());
+			m_connections.erase(sock);
+			return FALSE;
+		}
+		return KEEP_STREAM;
+	}
+
+	std::string status = "200 OK";
+	std::string content_type = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+	std::string body;
+	if (request.compare(0, 4, "GET ") != 0) {
+		status = "405 Method Not Allowed";
+		content_type = "text/plain";
+		body = "only GET is supported\n";
+	} else {
+		size_t end = request.find(' ', 4);
+		std::string path = request.substr(4, end == std::string::npos ? std::string::npos : end - 4);
+		if (path == "/" || path == "/metrics") {
+			GenerateMetrics(body);
+		} else {
+			status = "404 Not Found";
+			content_type = "text/plain";
+			body = "not found\n";
+		}
+	}
+	std::string & response = connection.data;
+	formatstr(response, "HTTP/1.0 %s\r\nContent-Type: %s\r\nContent-Length: %d\r\nConnection: close\r\n\r\n",
+		status.c_str(), content_type.c_str(), (int)body.size());
+	response += body;
+	connection.sent = 0;
+	connection.responding = true;
+
+		// Usually the whole response fits in the socket buffer.  If it
+		// doesn't, wait for the socket to become writable for the rest.
+	int rc = SendResponse(sock);
+	if (rc != KEEP_STREAM) {
+		return rc;
+	}
+	daemonCore->Cancel_Socket(sock);
+	if (daemonCore->Register_Socket(sock, "Metrics response",
+			(SocketHandlercpp)&MetricsServer::HandleResponse,
+			"MetricsServer::HandleResponse", this, ALLOW, HANDLE_WRITE) < 0)
+	{
+		dprintf(D_ALWAYS, "MetricsServer: failed to register response to %s\n", conn->peer_description());
+		m_connections.erase(sock);
+			// already cancelled, so DaemonCore won't delete it for us
+		delete sock;
+	}
+	return KEEP_STREAM;
+}
+
+int
+MetricsServer::HandleResponse(Stream * sock)
+{
+	return SendResponse(sock);
+}
+
+// Send as much of the response as the socket will take without blocking.
+// Returns KEEP_STREAM if there is more to send, or FALSE (so that DaemonCore
+// closes and deletes the connection) when it has all been sent or the
+// client has gone away.
+int
+MetricsServer::SendResponse(Stream * sock)
+{
+	auto it = m_connections.find(sock);
+	if (it == m_connections.end() || ! it->second.responding) {
+		return FALSE;
+	}
+	Connection & connection = it->second;
+	ReliSock * conn = (ReliSock *)sock;
+
+	while (connection.sent < connection.data.size()) {
+		int nw = condor_write(conn->peer_description(), conn->get_file_desc(),
+			connection.data.c_str() + connection.sent,
+			(int)(connection.data.size() - connection.sent), 0, 0, true);
+		if (nw < 0) {
+			dprintf(D_FULLDEBUG, "MetricsServer: failed to send response to %s\n", conn->peer_description());
+			m_connections.erase(it);
+			return FALSE;
+		}
+		if (nw == 0) {
+			return KEEP_STREAM;
+		}
+		connection.sent += nw;
+	}
+
+	m_connections.erase(it);
+	return FALSE;
+}
+
+void
+MetricsServer::GenerateMetrics(std::string & buf) const
+{
+	std::string subsys = get_mySubSystem()->getName();
+	std::transform(subsys.begin(), subsys.end(), subsys.begin(), ::tolower);
+	std::string prefix;
+	for (auto it = m_pools.begin(); it != m_pools.end(); ++it) {
+		formatstr(prefix, "condor_%s_%s", subsys.c_str(), it->first.c_str());
+		it->second->PublishMetrics(buf, prefix.c_str(), IF_PUBLEVEL);
+	}
+	buf += "# EOF\n";
+}
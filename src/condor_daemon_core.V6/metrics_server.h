@@ -0,0 +1,85 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _METRICS_SERVER_H
+#define _METRICS_SERVER_H
+
+#include "condor_daemon_core.h"
+#include <map>
+
+/**
+   A minimal HTTP listener that serves the daemon's statistics pools in
+   OpenMetrics text format, so that they can be scraped by Prometheus
+   without going through the collector or building ClassAds.
+
+   It is off unless METRICS_PORT is set (usually per daemon, e.g.
+   SCHEDD.METRICS_PORT), and listens on the loopback interface unless
+   METRICS_LOOPBACK_ONLY is false, in which case each connection must
+   pass the READ host authorization (ALLOW_READ / DENY_READ).  Every GET
+   request is answered with the metrics; the response is written as the
+   socket becomes writable, so a slow client never blocks the daemon,
+   and the connection is closed after each response.
+*/
+
+class MetricsServer : public Service
+{
+ public:
+	MetricsServer();
+	~MetricsServer();
+
+		/** Read METRICS_PORT and friends, and open, move or close
+			the listen socket to match.
+		*/
+	void Reconfig();
+
+		/** Add a statistics pool to the metrics output.  The metric
+			names are condor_<subsystem>_<prefix><attribute>.  The pool
+			must stay valid until RemovePool() is called.
+		*/
+	void AddPool(const char * prefix, const StatisticsPool * pool);
+	void RemovePool(const StatisticsPool * pool);
+
+ private:
+	int HandleAccept(Stream * sock);
+	int HandleRequest(Stream * sock);
+	int HandleResponse(Stream * sock);
+	int SendResponse(Stream * sock);
+	void DropStaleConnections();
+	void CloseListener();
+	void GenerateMetrics(std::string & buf) const;
+
+	ReliSock * m_listener;
+	int m_port;
+	bool m_loopback_only;
+
+		// An open connection: the partial request read so far, then
+		// the response and how much of it has been sent.
+	struct Connection {
+		Connection() : sent(0), responding(false), started(time(NULL)) {}
+		std::string data;
+		size_t sent;
+		bool responding;
+		time_t started;
+	};
+	std::map<Stream*, Connection> m_connections;
+
+	std::vector< std::pair<std::string, const StatisticsPool*> > m_pools;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include "condor_config.h"   // for param
 #include "../condor_procapi/procapi.h"
 #include <limits>
+#include <algorithm>
 
 int configured_statistics_window_quantum() {
     int quantum = param_integer("STATISTICS_WINDOW_QUANTUM_DAEMONCORE", INT_MAX, 1, INT_MAX);
@@ -41,6 +42,11 @@ static void self_monitor()
     daemonCore->monitor_data.CollectData();
     daemonCore->dc_stats.Tick(daemonCore->monitor_data.last_sample_time);
     daemonCore->dc_stats.DebugOuts += dprintf_getCount();
+
+    static long long last_debug_drops = 0;
+    long long debug_drops = dprintf_async_dropped();
+    daemonCore->dc_stats.DebugDrops += (int)(debug_drops - last_debug_drops);
+    last_debug_drops = debug_drops;
 }
 
 SelfMonitorData::SelfMonitorData()
@@ -161,6 +167,11 @@ bool SelfMonitorData::ExportData(ClassAd *ad, bool verbose /*=false*/) const
 //------------------------------------------------------------------------------------------
 //                          DaemonCore Statistics
 
+// upper bounds (in seconds) of the buckets of the per-handler latency histograms
+static const double handler_latency_levels[] = {
+   0.001, 0.01, 0.1, 0.5, 1.0, 5.0, 10.0, 60.0,
+};
+
 
 void DaemonCore::Stats::Reconfig()
 {
@@ -194,6 +205,9 @@ void DaemonCore::Stats::Reconfig()
     }
 
     this->Commands.ConfigureEMAHorizons(ema_config);
+
+    this->SlowHandlerThreshold = param_double("DC_SLOW_HANDLER_THRESHOLD", 0.0, 0.0, 1e9);
+    this->TopHandlersToPublish = param_integer("DC_STATS_TOP_HANDLERS", 5, 0, 100);
 }
 
 void DaemonCore::Stats::SetWindowSize(int window)
@@ -216,6 +230,8 @@ void DaemonCore::Stats::Init(bool enable)
    this->RecentWindowQuantum = configured_statistics_window_quantum();
    this->RecentWindowMax = this->RecentWindowQuantum; 
    this->PublishFlags    = -1;
+   this->SlowHandlerThreshold = 0.0;
+   this->TopHandlersToPublish = 0;
    if ( ! enable) return;
 
    // insert static items into the stats pool so we can use the pool 
@@ -235,6 +251,7 @@ void DaemonCore::Stats::Init(bool enable)
    //DC_STATS_ADD_RECENT(Pool, SockBytes,     IF_BASICPUB);
    //DC_STATS_ADD_RECENT(Pool, PipeBytes,     IF_BASICPUB);
    DC_STATS_ADD_RECENT(Pool, DebugOuts,     IF_VERBOSEPUB);
+   DC_STATS_ADD_RECENT(Pool, DebugDrops,    IF_VERBOSEPUB);
    DC_STATS_ADD_RECENT(Pool, PumpCycle,     IF_VERBOSEPUB);
    STATS_POOL_ADD_VAL(Pool, "DC", UdpQueueDepth,  IF_BASICPUB);
    STATS_POOL_PUB_PEAK(Pool, "DC", UdpQueueDepth,  IF_BASICPUB);
@@ -303,6 +320,9 @@ void DaemonCore::Stats::Clear()
    this->RecentStatsTickTime = 0;
    this->RecentStatsLifetime = 0;
    Pool.Clear();
+   for (auto it = this->Handlers.begin(); it != this->Handlers.end(); ++it) {
+      it->second.max_runtime = 0.0;
+   }
 }
 
 void DaemonCore::Stats::Publish(ClassAd & ad) const
@@ -353,9 +373,50 @@ void DaemonCore::Stats::Publish(ClassAd & ad, int flags) const
    }
    ad.Assign("RecentDaemonCoreDutyCycle", dDutyCycle);
 
+   if ((flags & IF_PUBLEVEL) > 0 && this->TopHandlersToPublish > 0) {
+      PublishTopHandlers(ad);
+   }
+   if ((flags & IF_PUBLEVEL) >= IF_VERBOSEPUB && ! this->Handlers.empty()) {
+      std::string buckets;
+      for (size_t ix = 0; ix < COUNTOF(handler_latency_levels); ++ix) {
+         if (ix) buckets += ", ";
+         formatstr_cat(buckets, "%g", handler_latency_levels[ix]);
+      }
+      ad.Assign("DCHandlerLatencyHistogramBuckets", buckets);
+   }
+
    Pool.Publish(ad, flags);
 }
 
+// publish the handlers that have used the most time since the daemon started,
+// as "name total max" triples, worst first.  This is meant to show at a glance
+// which command, timer or socket handler is responsible for a busy Driver loop.
+//
+void DaemonCore::Stats::PublishTopHandlers(ClassAd & ad) const
+{
+   std::vector<const HandlerProbe*> top;
+   top.reserve(this->Handlers.size());
+   for (auto it = this->Handlers.begin(); it != this->Handlers.end(); ++it) {
+      if (it->second.runtime->Count() > 0) {
+         top.push_back(&it->second);
+      }
+   }
+
+   size_t count = std::min(top.size(), (size_t)this->TopHandlersToPublish);
+   std::partial_sort(top.begin(), top.begin() + count, top.end(),
+      [](const HandlerProbe * a, const HandlerProbe * b) {
+         return a->runtime->Total() > b->runtime->Total();
+      });
+
+   std::string str;
+   for (size_t ix = 0; ix < count; ++ix) {
+      if (ix) str += ", ";
+      formatstr_cat(str, "%s %.3f %.3f", top[ix]->name.c_str(),
+                    top[ix]->runtime->Total(), top[ix]->max_runtime);
+   }
+   ad.Assign("DCTopHandlers", str);
+}
+
 void DaemonCore::Stats::Unpublish(ClassAd & ad) const
 {
    ad.Delete("DCStatsLifetime");
@@ -365,6 +426,8 @@ void DaemonCore::Stats::Unpublish(ClassAd & ad) const
    ad.Delete("DCRecentWindowMax");
    ad.Delete("DaemonCoreDutyCycle");
    ad.Delete("RecentDaemonCoreDutyCycle");
+   ad.Delete("DCTopHandlers");
+   ad.Delete("DCHandlerLatencyHistogramBuckets");
    Pool.Unpublish(ad);
 }
 
@@ -457,8 +520,23 @@ double DaemonCore::Stats::AddRuntime(const char * name, double before)
    double now = _condor_debug_get_time_double();
    if ( ! this->enabled) return now;
    stats_entry_probe<double> * probe = Pool.GetProbe< stats_entry_probe<double> >(name);
-   if (probe)
-      probe->Add(now - before);
+   if (probe) {
+      double runtime = now - before;
+      probe->Add(runtime);
+
+      auto it = this->Handlers.find(probe);
+      if (it != this->Handlers.end()) {
+         it->second.latency->Add(runtime);
+         if (runtime > it->second.max_runtime) it->second.max_runtime = runtime;
+         if (this->SlowHandlerThreshold > 0.0 && runtime >= this->SlowHandlerThreshold) {
+            dprintf(D_ALWAYS | D_BACKTRACE,
+               "Slow handler: %s took %.3f seconds (threshold %.3f); "
+               "%d calls, average %.3f, max %.3f, total %.3f seconds\n",
+               it->second.name.c_str(), runtime, this->SlowHandlerThreshold,
+               (int)probe->Count(), probe->Avg(), it->second.max_runtime, probe->Total());
+         }
+      }
+   }
    return now;
 }
 
@@ -612,6 +690,25 @@ void* DaemonCore::Stats::NewProbe(const char * category, const char * name, int
          stats_entry_probe<double> * probe =
          Pool.NewProbe< stats_entry_probe<double> >(name, attr.Value(), as);
          ret = probe;
+
+         // and a latency histogram for the same handler
+         if (probe && this->Handlers.find(probe) == this->Handlers.end()) {
+            MyString hist_name(name);
+            hist_name += "Latency";
+            MyString hist_attr(attr);
+            hist_attr += "Latency";
+            int hist_as = IF_VERBOSEPUB | IF_NONZERO | stats_entry_recent< stats_histogram<double> >::PubValueAndRecent;
+            stats_entry_recent_histogram<double> * latency =
+               Pool.NewProbe< stats_entry_recent_histogram<double> >(hist_name.Value(), hist_attr.Value(), hist_as);
+            latency->set_levels(handler_latency_levels, COUNTOF(handler_latency_levels));
+            latency->SetRecentMax(this->RecentWindowMax / this->RecentWindowQuantum);
+
+            HandlerProbe & hp = this->Handlers[probe];
+            hp.name = attr.Value() + 2; // skip the "DC" prefix
+            hp.runtime = probe;
+            hp.latency = latency;
+            hp.max_runtime = 0.0;
+         }
          }
          break;
 #else
@@ -49,6 +49,7 @@
 #include <set>
 #include "dagman_metrics.h"
 #include "enum_utils.h"
+#include "utc_time.h"
 
 using namespace std;
 
@@ -197,6 +198,9 @@ Dag::Dag( /* const */ std::list<std::string> &dagFiles,
 
 	_nextSubmitTime = 0;
 	_nextSubmitDelay = 1;
+	_submitOneAtATime = false;
+	_replayingNodeJournal = false;
+	_lastJournalCheckpoint = 0;
 	_recovery = false;
 	_abortOnScarySubmit = true;
 	_configFile = NULL;
@@ -316,7 +320,28 @@ bool Dag::Bootstrap (bool recovery)
     
 	_recovery = recovery;
 
-	(void) MonitorLogFile();
+		// In recovery mode, if we have a node state journal that matches
+		// this DAG and its node log, we start reading the node log where
+		// the journal leaves off, and get the earlier events from the
+		// journal.  Otherwise we start a new journal.
+	bool useJournal = param_boolean( "DAGMAN_NODE_JOURNAL", true );
+	bool replayJournal = false;
+	if ( useJournal && recovery ) {
+		replayJournal = OpenNodeJournal();
+	}
+	if ( !replayJournal ) {
+		(void) MonitorLogFile();
+		if ( useJournal ) {
+			MyString journalFile( _defaultNodeLog );
+			journalFile += ".journal";
+			_nodeJournal.Create( journalFile.Value(), _jobs.Number(),
+						NodeSignature() );
+		} else {
+				// don't leave a journal that no longer matches the node
+				// log for a later run that has the journal turned on
+			RemoveNodeJournal();
+		}
+	}
 
     if (recovery) {
         debug_printf( DEBUG_NORMAL, "Running in RECOVERY mode... "
@@ -334,6 +359,13 @@ bool Dag::Bootstrap (bool recovery)
 
 		debug_cache_start_caching();
 
+		if ( replayJournal && !ReplayNodeJournal() ) {
+			_recovery = false;
+			debug_cache_stop_caching();
+			_jobstateLog.WriteRecoveryFailure();
+			return false;
+		}
+
 		if( CondorLogFileCount() > 0 ) {
 			if( !ProcessLogEvents( recovery ) ) {
 				_recovery = false;
@@ -342,6 +374,7 @@ bool Dag::Bootstrap (bool recovery)
 				return false;
 			}
 		}
+		CheckpointNodeJournal( true );
 
 		// all jobs stuck in STATUS_POSTRUN need their scripts run
 		jobs.ToBeforeFirst();
@@ -494,6 +527,10 @@ bool Dag::ProcessLogEvents (bool recovery) {
 		}
 	}
 
+	if ( !recovery ) {
+		CheckpointNodeJournal( false );
+	}
+
 	if (DEBUG_LEVEL(DEBUG_VERBOSE) && recovery) {
 		const char *name = "HTCondor";
 		debug_printf( DEBUG_NORMAL, "    ------------------------------\n");
@@ -577,6 +614,9 @@ bool Dag::ProcessOneEvent (ULogEventOutcome outcome,
 					// event is for a job outside this DAG; ignore it
 				break;
 			}
+			if ( !_replayingNodeJournal ) {
+				_nodeJournal.WriteEvent( event, job );
+			}
 			if( !EventSanityCheck( event, job, &result ) ) {
 					// this event is "impossible"; we will either
 					// abort the DAG (if result was set to false) or
@@ -1376,6 +1416,23 @@ Job * Dag::FindNodeByName (const char * jobName) const {
 	return job;
 }
 
+//---------------------------------------------------------------------------
+Job * Dag::LookupNodeByName (const MyString &jobName) const {
+	Job *	job = NULL;
+	if ( _nodeNameHash.lookup(jobName, job) != 0 ) {
+		return NULL;
+	}
+
+	if ( job ) {
+		if ( strcmp( jobName.Value(), job->GetJobName() ) != 0 ) {
+			EXCEPT( "Searched for node %s; got %s!!", jobName.Value(),
+						job->GetJobName() );
+		}
+	}
+
+	return job;
+}
+
 //---------------------------------------------------------------------------
 Job *
 Dag::FindAllNodesByName( const char* nodeName,
@@ -1631,6 +1688,7 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 	PrioritySimpleList<Job*> deferredJobs;
 
 	int numSubmitsThisCycle = 0;
+	double submitTime = 0.0;
 
 		// Check whether we have to wait longer before submitting again
 		// (if a previous submit attempt failed).
@@ -1683,6 +1741,20 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 		}
 	}
 
+		// When submitting directly to the schedd, the jobs of all of
+		// the nodes submitted in this cycle go to the schedd in a single
+		// transaction.  We don't do this if we are supposed to sleep
+		// between submits.
+	DirectSubmitBatch *batch = NULL;
+	std::vector<Job*> batchedNodes;
+	std::vector<CondorID> batchedIDs;
+	Job *failedNode = NULL;
+	if ( !_dry_run && dm.submit_delay == 0 && !_submitOneAtATime &&
+				!param_boolean( "DAGMAN_USE_CONDOR_SUBMIT", false ) ) {
+		batch = new DirectSubmitBatch();
+	}
+	_submitOneAtATime = false;
+
 	while( numSubmitsThisCycle < dm.max_submits_per_interval ) {
 
 //		PrintReadyQ( DEBUG_DEBUG_4 );
@@ -1762,7 +1834,10 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 				// Note:  I'm not sure why we don't just use the default
 				// constructor here.  wenger 2015-09-25
 			CondorID condorID( 0, 0, 0 );
-			submit_result_t submit_result = SubmitNodeJob( dm, job, condorID );
+			double submitStart = condor_gettimestamp_double();
+			submit_result_t submit_result = SubmitNodeJob( dm, job, condorID,
+						batch );
+			submitTime += condor_gettimestamp_double() - submitStart;
 	
 				// Note: if instead of switch here so we can use break
 				// to break out of while loop.
@@ -1770,8 +1845,28 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 				ProcessSuccessfulSubmit( job, condorID );
     			numSubmitsThisCycle++;
 
+			} else if ( submit_result == SUBMIT_RESULT_BATCHED ) {
+					// Count the node against the throttles now, so
+					// that we don't batch more than we're allowed to
+					// submit.
+				UpdateJobCounts( job, 1 );
+				batchedNodes.push_back( job );
+				batchedIDs.push_back( condorID );
+    			numSubmitsThisCycle++;
+
 			} else if ( submit_result == SUBMIT_RESULT_FAILED || submit_result == SUBMIT_RESULT_NO_SUBMIT ) {
-				ProcessFailedSubmit( job, dm.max_submit_attempts );
+					// If the failure cost us the batch transaction,
+					// the nodes already in it have to be tried again.
+				if ( batch && batch->Aborted() ) {
+					numSubmitsThisCycle -= (int)batchedNodes.size();
+					RequeueBatchedNodes( batchedNodes );
+					batchedNodes.clear();
+					batchedIDs.clear();
+				}
+					// Deal with the failure after committing what we
+					// have, so that the successful submits don't cancel
+					// the delay before the next attempt.
+				failedNode = job;
 				break; // break out of while loop
 			} else {
 				EXCEPT( "Illegal submit_result_t value: %d", submit_result );
@@ -1779,6 +1874,46 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 		}
 	}
 
+	if ( batch ) {
+		if ( !batchedNodes.empty() ) {
+			double commitStart = condor_gettimestamp_double();
+			bool committed = batch->Commit();
+			submitTime += condor_gettimestamp_double() - commitStart;
+
+			if ( committed ) {
+				debug_printf( DEBUG_VERBOSE, "Submitted %d node%s in one "
+							"transaction\n", (int)batchedNodes.size(),
+							batchedNodes.size() == 1 ? "" : "s" );
+				for ( size_t i = 0; i < batchedNodes.size(); i++ ) {
+					UpdateJobCounts( batchedNodes[i], -1 );
+					ProcessSuccessfulSubmit( batchedNodes[i], batchedIDs[i] );
+				}
+			} else if ( batchedNodes.size() == 1 ) {
+				numSubmitsThisCycle--;
+				UpdateJobCounts( batchedNodes[0], -1 );
+				ProcessFailedSubmit( batchedNodes[0], dm.max_submit_attempts );
+			} else {
+					// We can't tell which node the schedd objected to,
+					// so submit them one at a time next time around.
+				debug_printf( DEBUG_NORMAL, "Submit of %d nodes in one "
+							"transaction failed; will submit them one at "
+							"a time\n", (int)batchedNodes.size() );
+				numSubmitsThisCycle -= (int)batchedNodes.size();
+				RequeueBatchedNodes( batchedNodes );
+				_submitOneAtATime = true;
+			}
+		}
+		delete batch;
+	}
+
+	if ( failedNode ) {
+		ProcessFailedSubmit( failedNode, dm.max_submit_attempts );
+	}
+
+	if ( numSubmitsThisCycle > 0 && _metrics ) {
+		_metrics->NodesSubmitted( numSubmitsThisCycle, submitTime );
+	}
+
 	// if we didn't actually invoke condor_submit, and we submitted any jobs
 	// we should now send a reschedule command
 	if (numSubmitsThisCycle > 0 && !_dry_run)
@@ -2173,6 +2308,50 @@ Dag::NumNodesDone( bool includeFinal ) const
 	return result;
 }
 
+//---------------------------------------------------------------------------
+void
+Dag::GetReportedNodeCounts( int &total, int &done, int &queued, int &ready,
+			int &unready )
+{
+	total = NumNodes( true );
+	done = NumNodesDone( true );
+	queued = NumJobsSubmitted();
+	ready = NumNodesReady();
+	unready = NumNodesUnready( true );
+
+		// Join nodes never have scripts, so they can only be waiting
+		// for their parents, ready, queued (as NOOP jobs) or done.
+	int joinTotal = 0;
+	ListIterator<Job> it( _jobs );
+	Job *node;
+	while ( it.Next( node ) ) {
+		if ( !node->IsJoinNode() ) {
+			continue;
+		}
+		joinTotal++;
+		if ( node->GetStatus() == Job::STATUS_DONE ) {
+			done--;
+		} else if ( node->GetStatus() == Job::STATUS_SUBMITTED ) {
+			queued--;
+		} else if ( node->CanSubmit() ) {
+			ready--;
+		} else {
+			unready--;
+		}
+	}
+	total -= joinTotal;
+
+		// A join node that just became ready may not have made it into
+		// the ready queue yet.
+	if ( ready < 0 ) {
+		unready += ready;
+		ready = 0;
+	}
+	if ( unready < 0 ) {
+		unready = 0;
+	}
+}
+
 //---------------------------------------------------------------------------
 // Note: the HTCondor part of this method essentially duplicates functionality
 // that is now in schedd.cpp.  We are keeping this here for now in case
@@ -2605,7 +2784,9 @@ Dag::TerminateJob( Job* job, bool recovery, bool bootstrap )
 		// careful not to double-count...
 	if( job->countedAsDone == false ) {
 		_numNodesDone++;
-		_metrics->NodeFinished( job->GetDagFile() != NULL, true );
+		if ( !job->IsJoinNode() ) {
+			_metrics->NodeFinished( job->GetDagFile() != NULL, true );
+		}
 		job->countedAsDone = true;
 		ASSERT( _numNodesDone <= _jobs.Number() );
 	} else {
@@ -3211,8 +3392,10 @@ Dag::DumpNodeStatus( bool held, bool removed )
 	fprintf( outfile, "  DagStatus = %d; /* %s */\n", dagJobStatus,
 				EscapeClassadString( statusStr.Value() ) );
 
+	int nodesTotal, nodesDone, nodesQueued, nodesReady, nodesUnready;
+	GetReportedNodeCounts( nodesTotal, nodesDone, nodesQueued, nodesReady,
+				nodesUnready );
 	int nodesPre = PreRunNodeCount();
-	int nodesQueued = NumJobsSubmitted();
 	int nodesPost = PostRunNodeCount();
 	int nodesFailed = NumNodesFailed();
 	int nodesHeld = NumHeldJobProcs();
@@ -3229,13 +3412,13 @@ Dag::DumpNodeStatus( bool held, bool removed )
 		nodesHeld = 0;
 		nodesIdle = 0;
 	}
-	fprintf( outfile, "  NodesTotal = %d;\n", NumNodes( true ) );
-	fprintf( outfile, "  NodesDone = %d;\n", NumNodesDone( true ) );
+	fprintf( outfile, "  NodesTotal = %d;\n", nodesTotal );
+	fprintf( outfile, "  NodesDone = %d;\n", nodesDone );
 	fprintf( outfile, "  NodesPre = %d;\n", nodesPre );
 	fprintf( outfile, "  NodesQueued = %d;\n", nodesQueued );
 	fprintf( outfile, "  NodesPost = %d;\n", nodesPost );
-	fprintf( outfile, "  NodesReady = %d;\n", NumNodesReady() );
-	fprintf( outfile, "  NodesUnready = %d;\n",NumNodesUnready( true ) );
+	fprintf( outfile, "  NodesReady = %d;\n", nodesReady );
+	fprintf( outfile, "  NodesUnready = %d;\n", nodesUnready );
 	fprintf( outfile, "  NodesFailed = %d;\n", nodesFailed );
 	fprintf( outfile, "  JobProcsHeld = %d;\n", nodesHeld );
 	fprintf( outfile, "  JobProcsIdle = %d; /* includes held */\n", nodesIdle );
@@ -3247,6 +3430,9 @@ Dag::DumpNodeStatus( bool held, bool removed )
 	ListIterator<Job> it ( _jobs );
 	Job *node;
 	while ( it.Next( node ) ) {
+		if ( node->IsJoinNode() ) {
+			continue;
+		}
 		fprintf( outfile, "[\n" );
 		fprintf( outfile, "  Type = \"NodeStatus\";\n" );
 
@@ -3426,6 +3612,137 @@ Dag::UnmonitorLogFile()
 	return result;
 }
 
+//---------------------------------------------------------------------------
+uint64_t
+Dag::NodeSignature() const
+{
+		// 64-bit FNV-1a over the node IDs and names, in node list order.
+	uint64_t hash = 14695981039346656037ULL;
+	const uint64_t prime = 1099511628211ULL;
+
+	ListIterator<Job> iList( _jobs );
+	Job *job;
+	while ( (job = iList.Next()) ) {
+		JobID_t id = job->GetJobID();
+		for ( size_t i = 0; i < sizeof(id); i++ ) {
+			hash = (hash ^ ((id >> (8 * i)) & 0xff)) * prime;
+		}
+		for ( const char *p = job->GetJobName(); *p; p++ ) {
+			hash = (hash ^ (unsigned char)*p) * prime;
+		}
+		hash = (hash ^ 0) * prime;
+	}
+
+	return hash;
+}
+
+//---------------------------------------------------------------------------
+bool
+Dag::OpenNodeJournal()
+{
+	MyString journalFile( _defaultNodeLog );
+	journalFile += ".journal";
+
+	ReadUserLog::FileState state;
+	if ( !ReadUserLog::InitFileState( state ) ) {
+		return false;
+	}
+
+	bool result = _nodeJournal.Open( journalFile.Value(), _jobs.Number(),
+				NodeSignature(), _defaultNodeLog, state );
+	if ( result ) {
+		CondorError errstack;
+		if ( !_condorLogRdr.monitorLogFile( _defaultNodeLog, state,
+					errstack ) ) {
+			debug_printf( DEBUG_NORMAL, "Unable to resume reading node log "
+						"%s from node state journal %s (%s); will re-read "
+						"the whole node log\n", _defaultNodeLog,
+						journalFile.Value(), errstack.getFullText().c_str() );
+			_nodeJournal.Close();
+			result = false;
+		}
+	}
+
+	ReadUserLog::UninitFileState( state );
+	return result;
+}
+
+//---------------------------------------------------------------------------
+bool
+Dag::ReplayNodeJournal()
+{
+	bool result = true;
+	bool done = false;
+	int count = 0;
+
+	_replayingNodeJournal = true;
+
+	ULogEvent *event = NULL;
+	while ( !done && _nodeJournal.ReadEvent( *this, event ) ) {
+		bool tmpResult = ProcessOneEvent( ULOG_OK, event, true, done );
+		result = result && tmpResult;
+		delete event;
+		event = NULL;
+		count++;
+	}
+
+	_replayingNodeJournal = false;
+
+	if ( _nodeJournal.Error() ) {
+		result = false;
+	}
+
+	debug_printf( DEBUG_NORMAL, "Replayed %d events from the node state "
+				"journal\n", count );
+
+	return result;
+}
+
+//---------------------------------------------------------------------------
+void
+Dag::CheckpointNodeJournal( bool force )
+{
+		// Minimum time between checkpoints in normal operation.  A
+		// checkpoint only costs a few KB, but there's no point in writing
+		// one every time we read the node log.
+	const time_t checkpointInterval = 30;
+
+	if ( !_nodeJournal.IsOpen() || _nodeJournal.PendingEvents() == 0 ) {
+		return;
+	}
+
+	time_t now = time( NULL );
+	if ( !force && now - _lastJournalCheckpoint < checkpointInterval ) {
+		return;
+	}
+
+	ReadUserLog::FileState state;
+	if ( !ReadUserLog::InitFileState( state ) ) {
+		return;
+	}
+
+	CondorError errstack;
+	if ( _condorLogRdr.getFileState( _defaultNodeLog, state, errstack ) ) {
+		if ( _nodeJournal.WriteCheckpoint( _defaultNodeLog, state ) ) {
+			_lastJournalCheckpoint = now;
+		}
+	} else {
+		debug_printf( DEBUG_NORMAL, "Warning: unable to checkpoint node "
+					"state journal: %s\n", errstack.getFullText().c_str() );
+	}
+
+	ReadUserLog::UninitFileState( state );
+}
+
+//---------------------------------------------------------------------------
+void
+Dag::RemoveNodeJournal()
+{
+	MyString journalFile( _defaultNodeLog );
+	journalFile += ".journal";
+	_nodeJournal.Remove( journalFile.Value() );
+}
+
 //-------------------------------------------------------------------------
 void
 Dag::SetReject( const MyString &location )
@@ -4336,10 +4653,11 @@ Dag::GetEventIDHash(bool isNoop) const
 //---------------------------------------------------------------------------
 
 Dag::submit_result_t
-Dag::SubmitNodeJob( const Dagman &dm, Job *node, CondorID &condorID )
+Dag::SubmitNodeJob( const Dagman &dm, Job *node, CondorID &condorID,
+			DirectSubmitBatch *batch )
 {
 	submit_result_t result = SUBMIT_RESULT_NO_SUBMIT;
-	bool use_condor_submit = param_boolean("DAGMAN_USE_CONDOR_SUBMIT", true);
+	bool use_condor_submit = param_boolean("DAGMAN_USE_CONDOR_SUBMIT", false);
 	// If a submit description is already set, override the DAGMAN_USE_CONDOR_SUBMIT knob
 	if (node->GetSubmitDesc()) { use_condor_submit = false; }
 
@@ -4461,8 +4779,15 @@ Dag::SubmitNodeJob( const Dagman &dm, Job *node, CondorID &condorID )
 			batchId = dm._batchId.c_str();
 		}
 
-		submit_success = direct_condor_submit(dm, node,
-			_defaultNodeLog, parents.c_str(), batchName, batchId, condorID);
+		if ( batch ) {
+			if ( batch->Add( dm, node, _defaultNodeLog, parents.c_str(),
+						batchName, batchId, condorID ) ) {
+				return SUBMIT_RESULT_BATCHED;
+			}
+		} else {
+			submit_success = direct_condor_submit(dm, node,
+				_defaultNodeLog, parents.c_str(), batchName, batchId, condorID);
+		}
 	}
 
 	result = submit_success ? SUBMIT_RESULT_OK : SUBMIT_RESULT_FAILED;
@@ -4506,6 +4831,22 @@ Dag::ProcessSuccessfulSubmit( Job *node, const CondorID &condorID )
 				  condorID._subproc );
 }
 
+//---------------------------------------------------------------------------
+void
+Dag::RequeueBatchedNodes( std::vector<Job*> &nodes )
+{
+		// Prepend in reverse so the nodes keep their order at the
+		// front of the ready queue.
+	for ( auto it = nodes.rbegin(); it != nodes.rend(); ++it ) {
+		Job *node = *it;
+		debug_printf( DEBUG_NORMAL, "Returning node %s to the ready queue; "
+					"its jobs were not submitted\n", node->GetJobName() );
+		node->_submitTries--;
+		UpdateJobCounts( node, -1 );
+		_readyQ->Prepend( node, -node->_effectivePriority );
+	}
+}
+
 //---------------------------------------------------------------------------
 void
 Dag::ProcessFailedSubmit( Job *node, int max_submit_attempts )
@@ -37,6 +37,7 @@
 #include "MyString.h"
 #include "../condor_utils/dagman_utils.h"
 #include "jobstate_log.h"
+#include "node_journal.h"
 #include "dagman_classad.h"
 
 #include <queue>
@@ -51,6 +52,7 @@ class Dagman;
 class MyString;
 class DagmanMetrics;
 class CondorID;
+class DirectSubmitBatch;
 
 // used for RelinquishNodeOwnership and AssumeOwnershipofNodes
 // This class owns the containers with which it was constructed, but
@@ -157,6 +159,11 @@ class Dag {
 		*/
 	void ReportMetrics( int exitCode );
 
+	/** Delete the node state journal, when the DAG is finished and it
+		can't be recovered any more.
+	*/
+	void RemoveNodeJournal();
+
 	/** Set the _abortOnScarySubmit value -- controls whether we abort
 		the DAG on "scary" submit events.
 		@param The abortOnScarySubmit value
@@ -307,6 +314,14 @@ class Dag {
     */
     Job * FindNodeByName (const char * jobName) const;
 
+    /** Like FindNodeByName(), but doesn't print anything if the node
+        doesn't exist, so it can be called from the parser's worker
+        threads once all of the nodes have been added.
+        @param jobName the name of the job in the DAG
+        @return address of Job object, or NULL if not found
+    */
+    Job * LookupNodeByName (const MyString &jobName) const;
+
     /** Get pointer to job with condor ID condorID
         @param condorID the HTCondorID of the job in the DAG
         @return address of Job object, or NULL if not found
@@ -384,6 +399,14 @@ class Dag {
 				NumJobsSubmitted() + PostRunNodeCount() +
 				NumNodesReady() + NumNodesFailed() ) ); }
 
+    /** Get the node counts that we report to the user (in dagman.out,
+		the DAGMan job ad and the node status file).  These leave out
+		the join nodes we inserted into the DAG (see Job::IsJoinNode()).
+		@param total, done, queued, ready, unready the counts
+	*/
+	void GetReportedNodeCounts( int &total, int &done, int &queued,
+				int &ready, int &unready );
+
     /** @return the number of PRE scripts currently running
      */
     inline int NumPreScriptsRunning() const
@@ -927,6 +950,7 @@ class Dag {
 		SUBMIT_RESULT_OK,
 		SUBMIT_RESULT_FAILED,
 		SUBMIT_RESULT_NO_SUBMIT,
+		SUBMIT_RESULT_BATCHED,
 	} submit_result_t;
 
 	/** Submit the HTCondor job for a node, including doing
@@ -935,10 +959,21 @@ class Dag {
 		@param the appropriate Dagman object
 		@param the node for which to submit a job
 		@param reference to hold the HTCondor ID the job is assigned
-		@return submit_result_t (see above)
+		@param if not NULL, direct submits are added to this batch
+			instead of being committed right away
+		@return submit_result_t (see above); SUBMIT_RESULT_BATCHED means
+			the job is in the batch, and is not submitted until the
+			batch is committed
 	*/
 	submit_result_t SubmitNodeJob( const Dagman &dm, Job *node,
-				CondorID &condorID );
+				CondorID &condorID, DirectSubmitBatch *batch = NULL );
+
+	/** Put nodes whose jobs were in a direct submit batch that was
+		not committed back into the ready queue, without counting
+		this as a submit attempt.
+		@param the nodes, in the order they were taken from the ready queue
+	*/
+	void RequeueBatchedNodes( std::vector<Job*> &nodes );
 
 	/** Do the post-processing of a successful submit of a HTCondor job.
 		@param the node for which the job was just submitted
@@ -1079,6 +1114,32 @@ class Dag {
 	*/
 	bool UnmonitorLogFile();
 
+	/** Compute a hash of the IDs and names of all of the nodes, so that
+		a node state journal is only replayed for the same DAG.
+		@return:  the node signature
+	*/
+	uint64_t NodeSignature() const;
+
+	/** Open the node state journal for recovery, and monitor the
+		workflow log file starting at the journal's last checkpoint.
+		@return:  true if the journal can be replayed, false otherwise
+			(in which case the workflow log file is not monitored)
+	*/
+	bool OpenNodeJournal();
+
+	/** Process the events recorded in the node state journal (in
+		recovery mode).
+		@return:  true if the DAG should continue, false if we should abort
+	*/
+	bool ReplayNodeJournal();
+
+	/** Write a checkpoint to the node state journal, if there are new
+		events in it and enough time has passed since the last one.
+		@param force:  if true, write a checkpoint whenever there are
+			new events, regardless of the time.
+	*/
+	void CheckpointNodeJournal( bool force );
+
 protected:
     // List of Job objects
     List<Job>     _jobs;
@@ -1239,6 +1300,11 @@ private:
 		// seconds).
 	int			_nextSubmitDelay;
 
+		// Set when the commit of a direct submit batch fails, so that
+		// the next submit cycle submits nodes one at a time and the
+		// failure can be pinned on a node.
+	bool		_submitOneAtATime;
+
 		// Whether we're in recovery mode.  We only need this here for
 		// the PR 554 fix in PostScriptReaper -- otherwise it gets passed
 		// down thru the call stack.
@@ -1308,6 +1374,16 @@ private:
 		// The object for logging to the jobstate.log file (for Pegasus).
 	JobstateLog _jobstateLog;
 
+		// The node state journal (see node_journal.h).
+	NodeJournal _nodeJournal;
+
+		// True while we're processing events from the node state journal
+		// (so we don't write them to the journal again).
+	bool _replayingNodeJournal;
+
+		// The last time we wrote a node state journal checkpoint.
+	time_t _lastJournalCheckpoint;
+
 	// If true, run the POST script, regardless of the exit status of the PRE script
 	// Defaults to true
 	bool _alwaysRunPost;
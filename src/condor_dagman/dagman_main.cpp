@@ -119,6 +119,10 @@ Dagman::Dagman() :
 	max_submits_per_interval (MAX_SUBMITS_PER_INT_DEFAULT), // so Coverity is happy
 	aggressive_submit (false),
 	m_user_log_scan_interval (LOG_SCAN_INT_DEFAULT),
+	m_event_timer_id (-1),
+	_nodeLogTrigger (NULL),
+	_nodeLogPipe (-1),
+	_nodeLogWatchFailed (false),
 	schedd_update_interval (SCHEDD_UPDATE_INTERVAL_DEFAULT),
 	primaryDagFile (""),
 	multiDags (false),
@@ -377,7 +381,7 @@ Dagman::Config()
 	} else {
 		debug_printf(DEBUG_NORMAL, "DAGMAN_CONDOR_SUBMIT_EXE setting: %s\n", condorSubmitExe);
 	}
-	bool _use_condor_submit = param_boolean("DAGMAN_USE_CONDOR_SUBMIT", true);
+	bool _use_condor_submit = param_boolean("DAGMAN_USE_CONDOR_SUBMIT", false);
 	debug_printf( DEBUG_NORMAL, "DAGMAN_USE_CONDOR_SUBMIT setting: %s\n",
 		_use_condor_submit ? "True" : "False");
 
@@ -498,6 +502,83 @@ Dagman::LocateSchedd()
 	}
 }
 
+	// Set when the node log has been written to since condor_event_timer()
+	// last ran.
+static bool nodeLogNotified = false;
+
+static int
+node_log_changed( int /* pipe_end */ )
+{
+	if ( dagman._nodeLogTrigger->read_notifications() == -1 ) {
+		debug_printf( DEBUG_NORMAL, "Error reading notifications for node "
+					"log %s; falling back to scanning it every %d seconds\n",
+					dagman.dag->DefaultNodeLog(),
+					dagman.m_user_log_scan_interval );
+		daemonCore->Cancel_Pipe( dagman._nodeLogPipe );
+		daemonCore->Close_Pipe( dagman._nodeLogPipe );
+		dagman._nodeLogPipe = -1;
+		delete dagman._nodeLogTrigger;
+		dagman._nodeLogTrigger = NULL;
+		dagman._nodeLogWatchFailed = true;
+		return TRUE;
+	}
+
+		// Read the new events now rather than at the next scan.
+	nodeLogNotified = true;
+	daemonCore->Reset_Timer( dagman.m_event_timer_id, 0,
+				dagman.m_user_log_scan_interval );
+	return TRUE;
+}
+
+void
+Dagman::WatchNodeLog()
+{
+	if ( _nodeLogTrigger || _nodeLogWatchFailed || m_event_timer_id == -1 ||
+				!dag || !dag->DefaultNodeLog() ) {
+		return;
+	}
+
+		// The node log is created when the first node job is submitted.
+	struct stat statbuf;
+	if ( stat( dag->DefaultNodeLog(), &statbuf ) != 0 ) {
+		return;
+	}
+
+	FileModifiedTrigger *trigger =
+				new FileModifiedTrigger( dag->DefaultNodeLog() );
+	int fd = trigger->isInitialized() ? trigger->notify_fd() : -1;
+		// DaemonCore closes the pipe it's given, so give it a copy.
+	if ( fd != -1 ) {
+		fd = dup( fd );
+	}
+	if ( fd == -1 ) {
+		debug_printf( DEBUG_VERBOSE, "Not watching node log %s for "
+					"changes; scanning it every %d seconds\n",
+					dag->DefaultNodeLog(), m_user_log_scan_interval );
+		delete trigger;
+		_nodeLogWatchFailed = true;
+		return;
+	}
+
+	int pipe_end = daemonCore->Inherit_Pipe( fd, false, true, true );
+	if ( daemonCore->Register_Pipe( pipe_end, "node log inotify",
+				node_log_changed, "node_log_changed" ) == -1 ) {
+		debug_printf( DEBUG_NORMAL, "Failed to register node log %s "
+					"for change notification; scanning it every %d "
+					"seconds\n", dag->DefaultNodeLog(),
+					m_user_log_scan_interval );
+		daemonCore->Close_Pipe( pipe_end );
+		delete trigger;
+		_nodeLogWatchFailed = true;
+		return;
+	}
+
+	debug_printf( DEBUG_VERBOSE, "Watching node log %s for changes\n",
+				dag->DefaultNodeLog() );
+	_nodeLogTrigger = trigger;
+	_nodeLogPipe = pipe_end;
+}
+
 
 // NOTE: this is only called on reconfig, not at startup
 void
@@ -603,7 +684,10 @@ void main_shutdown_rescue( int exitVal, DagStatus dagStatus,
 		dagman.dag->DumpNodeStatus( false, removed );
 		dagman.dag->GetJobstateLog().WriteDagmanFinished( exitVal );
 	}
-	if (dagman.dag) dagman.dag->ReportMetrics( exitVal );
+	if (dagman.dag) {
+		dagman.dag->ReportMetrics( exitVal );
+		dagman.dag->RemoveNodeJournal();
+	}
 	dagman.PublishStats();
 	dagmanUtils.tolerant_unlink( lockFileName.c_str() ); 
 	dagman.CleanUp();
@@ -628,6 +712,7 @@ void ExitSuccess() {
 	dagman.dag->DumpNodeStatus( false, false );
 	dagman.dag->GetJobstateLog().WriteDagmanFinished( EXIT_OKAY );
 	dagman.dag->ReportMetrics( EXIT_OKAY );
+	dagman.dag->RemoveNodeJournal();
 	dagman.PublishStats();
 	dagmanUtils.tolerant_unlink( lockFileName.c_str() ); 
 	dagman.CleanUp();
@@ -1454,7 +1539,8 @@ void main_init (int argc, char ** const argv) {
 	}
 
 	debug_printf( DEBUG_VERBOSE, "Registering condor_event_timer...\n" );
-	daemonCore->Register_Timer( 1, dagman.m_user_log_scan_interval, 
+	dagman.m_event_timer_id = daemonCore->Register_Timer( 1,
+				dagman.m_user_log_scan_interval,
 				condor_event_timer, "condor_event_timer" );
 
 	dagman.dag->SetPendingNodeReportInterval(
@@ -1604,14 +1690,12 @@ print_status( bool forceScheddUpdate ) {
 				dagman.dag->_dagStatus,
 				dagman.dag->GetStatusName() );
 
-	int total = dagman.dag->NumNodes( true );
-	int done = dagman.dag->NumNodesDone( true );
+	int total, done, submitted, ready, unready;
+	dagman.dag->GetReportedNodeCounts( total, done, submitted, ready,
+				unready );
 	int pre = dagman.dag->PreRunNodeCount();
-	int submitted = dagman.dag->NumJobsSubmitted();
 	int post = dagman.dag->PostRunNodeCount();
-	int ready =  dagman.dag->NumNodesReady();
 	int failed = dagman.dag->NumNodesFailed();
-	int unready = dagman.dag->NumNodesUnready( true );
 
 	debug_printf( DEBUG_VERBOSE, "Of %d nodes total:\n", total );
 
@@ -1641,15 +1725,13 @@ print_status( bool forceScheddUpdate ) {
 void
 jobad_update() {
 
-	int total = dagman.dag->NumNodes( true );
-	int done = dagman.dag->NumNodesDone( true );
+	int total, done, submitted, ready, unready;
+	dagman.dag->GetReportedNodeCounts( total, done, submitted, ready,
+				unready );
 	int pre = dagman.dag->PreRunNodeCount();
-	int submitted = dagman.dag->NumJobsSubmitted();
 	int post = dagman.dag->PostRunNodeCount();
 	int hold = dagman.dag->HoldRunNodeCount();
-	int ready =  dagman.dag->NumNodesReady();
 	int failed = dagman.dag->NumNodesFailed();
-	int unready = dagman.dag->NumNodesUnready( true );
 
 	if ( dagman._dagmanClassad ) {
 		dagman._dagmanClassad->Update( total, done, pre, submitted, post,
@@ -1739,6 +1821,10 @@ void condor_event_timer () {
 				  	justSubmitted, justSubmitted == 1 ? "" : "s" );
 	}
 
+	dagman.WatchNodeLog();
+	bool notified = nodeLogNotified;
+	nodeLogNotified = false;
+
 	// Check log status for growth. If it grew, process log events.
 	if( log_status == ReadUserLog::LOG_STATUS_GROWN ) {
 		logProcessCycleStartTime = condor_gettimestamp_double();
@@ -1751,6 +1837,15 @@ void condor_event_timer () {
 		}
 		logProcessCycleEndTime = condor_gettimestamp_double();
 		dagman._dagmanStats.LogProcessCycleTime.Add(logProcessCycleEndTime - logProcessCycleStartTime);
+
+			// If we're here because the node log was written to, submit
+			// whatever its events made ready without waiting for the next
+			// scan.  (Only once per notification, so that throttled nodes
+			// don't keep us spinning.)
+		if( notified && dagman.dag->NumNodesReady() > 0 ) {
+			daemonCore->Reset_Timer( dagman.m_event_timer_id, 0,
+						dagman.m_user_log_scan_interval );
+		}
 	}
 
 	// print status if anything's changed (or we're in a high debug level)
@@ -25,6 +25,7 @@
 #include "dagman_classad.h"
 #include "dagman_stats.h"
 #include "utc_time.h"
+#include "file_modified_trigger.h"
 #include "../condor_utils/dagman_utils.h"
 
 	// Don't change these values!  Doing so would break some DAGs.
@@ -61,6 +62,15 @@ class Dagman {
 			delete _schedd;
 			_schedd = NULL;
 		}
+		if ( _nodeLogPipe != -1 && daemonCore ) {
+			daemonCore->Cancel_Pipe( _nodeLogPipe );
+			daemonCore->Close_Pipe( _nodeLogPipe );
+			_nodeLogPipe = -1;
+		}
+		if ( _nodeLogTrigger != NULL ) {
+			delete _nodeLogTrigger;
+			_nodeLogTrigger = NULL;
+		}
 	}
 
 		// Check (based on the version from the .condor.sub file, etc.),
@@ -76,6 +86,10 @@ class Dagman {
 
 	void LocateSchedd();
 
+		// Once the default node log exists, have DaemonCore tell us as
+		// soon as it is written to (see _nodeLogTrigger).
+	void WatchNodeLog();
+
     Dag * dag;
     int maxIdle;  // Maximum number of idle DAG nodes
     int maxJobs;  // Maximum number of Jobs to run at once
@@ -109,6 +123,18 @@ class Dagman {
 		// configure that to be much faster with a minimum of 1 second.
 	int m_user_log_scan_interval;
 
+		// The timer which runs condor_event_timer().
+	int m_event_timer_id;
+
+		// Where the platform allows it, wakes us up when the default node
+		// log is written to, so that new events are read right away
+		// instead of at the next m_user_log_scan_interval.  The scan timer
+		// still runs, since inotify says nothing about writes from other
+		// hosts on a network filesystem.
+	FileModifiedTrigger *_nodeLogTrigger;
+	int _nodeLogPipe;
+	bool _nodeLogWatchFailed;
+
 		// How long dagman waits before updating the schedd with its metrics
 		// and statistics. These are not essential updates, so typically we
 		// will want to keep them infrequent to reduce load on the schedd.
@@ -65,6 +65,8 @@ DagmanMetrics::DagmanMetrics( /*const*/ Dag *dag,
 	_simpleNodesFailed( 0 ),
 	_subdagNodesSuccessful( 0 ),
 	_subdagNodesFailed( 0 ), 
+	_nodesSubmitted( 0 ),
+	_submitTime( 0.0 ),
 	_graphHeight( 0 ),
 	_graphWidth( 0 ),
 	_graphNumEdges( 0 ),
@@ -99,7 +101,7 @@ DagmanMetrics::DagmanMetrics( /*const*/ Dag *dag,
 #endif
 		if ( node->GetDagFile() ) {
 			_subdagNodes++;
-		} else {
+		} else if ( !node->IsJoinNode() ) {
 			_simpleNodes++;
 		}
 	}
@@ -132,6 +134,14 @@ DagmanMetrics::NodeFinished( bool isSubdag, bool successful )
 	}
 }
 
+//---------------------------------------------------------------------------
+void
+DagmanMetrics::NodesSubmitted( int count, double duration )
+{
+	_nodesSubmitted += count;
+	_submitTime += duration;
+}
+
 //---------------------------------------------------------------------------
 bool
 DagmanMetrics::Report( int exitCode, DagStatus status )
@@ -183,6 +193,10 @@ DagmanMetrics::WriteMetricsFile( int exitCode, DagStatus status )
 	int totalNodesRun = _simpleNodesSuccessful + _simpleNodesFailed +
 				_subdagNodesSuccessful + _subdagNodesFailed;
 	fprintf( fp, "    \"total_jobs_run\":%d,\n", totalNodesRun );
+	fprintf( fp, "    \"total_jobs_submitted\":%d,\n", _nodesSubmitted );
+	fprintf( fp, "    \"submit_time\":%.3lf,\n", _submitTime );
+	double submitRate = _submitTime > 0.0 ? _nodesSubmitted / _submitTime : 0.0;
+	fprintf( fp, "    \"submit_rate\":%.3lf,\n", submitRate );
 
 	bool report_graph_metrics = param_boolean( "DAGMAN_REPORT_GRAPH_METRICS", false );
 	if ( report_graph_metrics == true ) {
@@ -70,6 +70,12 @@ public:
 		*/
 	void NodeFinished( bool isSubdag, bool successful );
 
+		/** Add the node jobs submitted in a submit cycle to the metrics.
+			@param count The number of nodes whose jobs were submitted.
+			@param duration The time spent submitting them, in seconds.
+		*/
+	void NodesSubmitted( int count, double duration );
+
 		/** Report the metrics to the Pegasus metrics server(s), assuming
 			that reporting is enabled.
 			@param exitCode The exit code of this DAGMan.
@@ -165,6 +171,10 @@ private:
 	int _subdagNodesSuccessful;
 	int _subdagNodesFailed;
 
+		// Submit throughput.
+	int _nodesSubmitted;
+	double _submitTime;
+
 		// Graph metrics
 	int _graphHeight;
 	int _graphWidth;
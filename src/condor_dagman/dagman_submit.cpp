@@ -561,8 +561,138 @@ static void init_dag_vars(SubmitHash * submitHash,
 }
 
 //-------------------------------------------------------------------------
+// A submit file parsed up to its queue statement.  If the queue statement
+// has no itemdata the parse is kept for the life of the batch, and each node
+// that uses the file gets a copy of it to add its own variables to.
+struct DirectSubmitBatch::SubmitFile {
+	SubmitHash hash;
+	MacroStreamFile ms;
+	std::string queue_args;
+	bool shareable;
+	bool warned;
+	SubmitFile() : shareable(false), warned(false) {}
+};
+
+static void
+init_submit_hash(SubmitHash &submitHash)
+{
+	// Start by populating the hash with some parameters
+	submitHash.init();
+	submitHash.setDisableFileChecks(true);
+	submitHash.setScheddVersion(CondorVersion());
+	// if (myproxy_password) submitHash.setMyProxyPassword(myproxy_password);
+}
+
+// Copy a parsed submit description into a freshly initialized hash.
+static void
+copy_submit_hash(SubmitHash &to, SubmitHash &from, const char *cmdFile)
+{
+	init_submit_hash(to);
+	HASHITER it = hash_iter_begin(from.macros(), HASHITER_NO_DEFAULTS);
+	for ( ; ! hash_iter_done(it); hash_iter_next(it)) {
+		to.set_submit_param(hash_iter_key(it), hash_iter_value(it));
+	}
+	hash_iter_delete(&it);
+
+	// set submit filename into the submit hash so that $(SUBMIT_FILE) works
+	MACRO_SOURCE source = { false, false, 0, 0, -1, -2 };
+	to.insert_submit_filename(cmdFile, source);
+}
+
+DirectSubmitBatch::DirectSubmitBatch()
+	: m_qmgr(NULL)
+	, m_aborted(false)
+	, m_numNodes(0)
+{
+	auto_free_ptr owner(my_username());
+	if (owner) { m_owner = owner.ptr(); }
+}
+
+DirectSubmitBatch::~DirectSubmitBatch()
+{
+	abort();
+	for (auto it = m_submitFiles.begin(); it != m_submitFiles.end(); ++it) {
+		delete it->second;
+	}
+	m_submitFiles.clear();
+}
+
+void
+DirectSubmitBatch::abort()
+{
+	if (m_qmgr) {
+		// cancel the pending transaction and disconnect
+		DisconnectQ(m_qmgr, false);
+		m_qmgr = NULL;
+		if (m_numNodes > 0) {
+			debug_printf(DEBUG_NORMAL, "Aborted direct submission of %d node%s\n",
+				m_numNodes, m_numNodes == 1 ? "" : "s");
+		}
+		m_aborted = true;
+	}
+}
+
+// Returns the parsed submit file for a node; the caller must be in the
+// node's directory.  Returns NULL on failure.
+DirectSubmitBatch::SubmitFile *
+DirectSubmitBatch::getSubmitFile(const char *cmdFile, const char *directory,
+	std::string &errmsg, int &line)
+{
+	std::string key(directory ? directory : "");
+	key += '\n';
+	key += cmdFile;
+	auto found = m_submitFiles.find(key);
+	if (found != m_submitFiles.end()) {
+		line = found->second->ms.source().line;
+		return found->second;
+	}
+
+	SubmitFile *sf = new SubmitFile();
+	init_submit_hash(sf->hash);
+
+	// open the submit file
+	if ( ! sf->ms.open(cmdFile, false, sf->hash.macros(), errmsg)) {
+		debug_printf(DEBUG_QUIET, "ERROR: submit attempt failed, errno=%d %s\n", errno, strerror(errno));
+		debug_printf(DEBUG_QUIET, "could not open submit file : %s - %s\n", cmdFile, errmsg.c_str());
+		delete sf;
+		return NULL;
+	}
+
+	// set submit filename into the submit hash so that $(SUBMIT_FILE) works
+	sf->hash.insert_submit_filename(cmdFile, sf->ms.source());
+
+	// read the submit file until we get to the queue statement or end of file
+	char * qline = NULL;
+	const char * queue_args = NULL;
+	if (sf->hash.parse_up_to_q_line(sf->ms, errmsg, &qline) == 0) {
+		if (qline) {
+			queue_args = sf->hash.is_queue_statement(qline);
+		}
+		if ( ! queue_args) {
+			// submit file had no queue statement
+			errmsg = "no QUEUE statement";
+		}
+	}
+	line = sf->ms.source().line;
+	if ( ! queue_args) {
+		delete sf;
+		return NULL;
+	}
+	sf->queue_args = queue_args;
+
+	// Only a queue statement without itemdata can be shared; itemdata may
+	// follow it in the file and has to be read again for each node.
+	SubmitForeachArgs fea;
+	std::string qerr;
+	if (sf->hash.parse_q_args(queue_args, fea, qerr) == 0 && fea.foreach_mode == foreach_not) {
+		sf->shareable = true;
+		m_submitFiles[key] = sf;
+	}
+	return sf;
+}
+
 bool
-direct_condor_submit(const Dagman &dm, Job* node,
+DirectSubmitBatch::Add(const Dagman &dm, Job* node,
 	const char *workflowLogFile,
 	const MyString & parents,
 	const char *batchName,
@@ -571,11 +701,6 @@ direct_condor_submit(const Dagman &dm, Job* node,
 {
 	const char* cmdFile = node->GetCmdFile();
 
-	// Setup a SubmitHash object
-	// If this was defined inline in the dag file, it's already been parsed, set the pointer
-	// Otherwise we'll initialize and parse it in from the submit file later
-	SubmitHash* submitHash = node->GetSubmitDesc();
-
 	TmpDir		tmpDir;
 	MyString	errMsg;
 	const char* directory = node->GetDirectory();
@@ -588,60 +713,63 @@ direct_condor_submit(const Dagman &dm, Job* node,
 	int rval = 0;
 	bool success = false;
 	std::string errmsg;
-	Qmgr_connection * qmgr = NULL;
-	auto_free_ptr owner(my_username());
-	char * qline = NULL;
 	const char * queue_args = NULL;
-	MacroStreamFile ms;
+	MacroStreamFile no_items;
+	MacroStream * items = &no_items;
+	int line = 0;
 
-	// If the submitDesc hash is not set, we need to parse it from the file
-	if (!node->GetSubmitDesc()) {
-		debug_printf(DEBUG_NORMAL, "Submitting node %s from file %s using direct job submission\n", node->GetJobName(), node->GetCmdFile());
-		submitHash = new SubmitHash();
-		// Start by populating the hash with some parameters
-		submitHash->init();
-		submitHash->setDisableFileChecks(true);
-		submitHash->setScheddVersion(CondorVersion());
-		// if (myproxy_password) submitHash.setMyProxyPassword(myproxy_password);
-
-		// open the submit file
-		if (! ms.open(cmdFile, false, submitHash->macros(), errmsg)) {
-			debug_printf(DEBUG_QUIET, "ERROR: submit attempt failed, errno=%d %s\n", errno, strerror(errno));
-			debug_printf(DEBUG_QUIET, "could not open submit file : %s - %s\n", cmdFile, errmsg.c_str());
-			goto finis;
-		}
-
-		// set submit filename into the submit hash so that $(SUBMIT_FILE) works
-		submitHash->insert_submit_filename(cmdFile, ms.source());
-
-		// read the submit file until we get to the queue statement or end of file
-		rval = submitHash->parse_up_to_q_line(ms, errmsg, &qline);
-		if (rval) {
-			goto finis;
-		}
-
-		if (qline) {
-			queue_args = submitHash->is_queue_statement(qline);
-		}
-		if ( ! queue_args) {
-			// submit file had no queue statement
-			errmsg = "no QUEUE statement";
+	// Setup a SubmitHash object
+	// If this was defined inline in the dag file, it's already been parsed, use it.
+	// Otherwise use the parse of the submit file, copying it if it is shared.
+	SubmitHash* submitHash = node->GetSubmitDesc();
+	SubmitHash nodeHash;
+	SubmitFile* sf = NULL;
+	bool owns_sf = false;
+	bool sent = false;
+
+	if ( ! submitHash) {
+		debug_printf(DEBUG_NORMAL, "Submitting node %s from file %s using direct job submission\n", node->GetJobName(), cmdFile);
+		sf = getSubmitFile(cmdFile, directory, errmsg, line);
+		if ( ! sf) {
 			rval = -1;
 			goto finis;
 		}
+		queue_args = sf->queue_args.c_str();
+		if (sf->shareable) {
+			copy_submit_hash(nodeHash, sf->hash, cmdFile);
+			submitHash = &nodeHash;
+		} else {
+			owns_sf = true;
+			submitHash = &sf->hash;
+			items = &sf->ms;
+		}
 	}
 	else {
 		debug_printf(DEBUG_NORMAL, "Submitting node %s from inline description using direct job submission\n", node->GetJobName());
-		submitHash = node->GetSubmitDesc();
 	}
 
 	// set submit keywords defined by dagman and VARS
 	init_dag_vars(submitHash, dm, node, workflowLogFile, parents, batchName, batchId);
 
-	submitHash->init_base_ad(time(NULL), owner);
+	submitHash->init_base_ad(time(NULL), m_owner.empty() ? NULL : m_owner.c_str());
+
+	if ( ! m_qmgr) {
+		if (m_aborted) {
+			errmsg = "the submit transaction was aborted";
+			goto finis;
+		}
+		m_qmgr = ConnectQ(NULL);
+		if ( ! m_qmgr) {
+			errmsg = "failed to connect to the schedd";
+			goto finis;
+		}
+	}
 
-	qmgr = ConnectQ(NULL);
-	if (qmgr) {
+	{
+		// From here on a failure leaves the schedd with part of this
+		// node's jobs in the transaction, so the whole transaction
+		// has to be aborted.
+		sent = true;
 		int cluster_id = NewCluster();
 		if (cluster_id <= 0) {
 			errmsg = "failed to get a ClusterId";
@@ -658,7 +786,7 @@ direct_condor_submit(const Dagman &dm, Job* node,
 			goto finis;
 		}
 
-		rval = ssi.load_items(ms, false, errmsg);
+		rval = ssi.load_items(*items, false, errmsg);
 		if (rval < 0) {
 			goto finis;
 		}
@@ -698,28 +826,23 @@ direct_condor_submit(const Dagman &dm, Job* node,
 				goto finis;
 			}
 		}
-		// commit transaction and disconnect queue
-		CondorError errstack;
-		success = DisconnectQ(qmgr, true, &errstack); qmgr = NULL;
-		if (!success) {
-			debug_printf(DEBUG_NORMAL, "Failed to submit job %s: %s\n", node->GetJobName(), errstack.getFullText().c_str());
+		if (rval == 0) {
+			success = true;
+			++m_numNodes;
 		}
 	}
 
 finis:
-	if (qmgr) {
-		// if qmanager object is still open, cancel any pending transaction and disconnnect it.
-		CondorError errstack;
-		success = DisconnectQ(qmgr, true, &errstack); qmgr = NULL;
-		if (!success) {
-			debug_printf(DEBUG_NORMAL, "Failed to submit job %s: %s\n", node->GetJobName(), errstack.getFullText().c_str());
-		}
+	if ( ! success && sent) {
+		abort();
 	}
 	// report errors from submit
 	//
-	if (rval < 0) {
-		debug_printf(DEBUG_QUIET, "ERROR: on Line %d of submit file: %s\n", ms.source().line, errmsg.c_str());
-		if (submitHash->error_stack()) {
+	if (rval < 0 || ! success) {
+		if ( ! errmsg.empty()) {
+			debug_printf(DEBUG_QUIET, "ERROR: on Line %d of submit file: %s\n", line, errmsg.c_str());
+		}
+		if (submitHash && submitHash->error_stack()) {
 			std::string errstk(submitHash->error_stack()->getFullText());
 			if (! errstk.empty()) {
 				debug_printf(DEBUG_QUIET, "submit error: %s", errstk.c_str());
@@ -728,9 +851,14 @@ finis:
 		}
 	}
 	else {
-		// If submit succeeded, we still need to log any warning messages
+		// If submit succeeded, we still need to log any warning messages.
+		// A shared submit file only needs to be checked for unused
+		// keywords once.
 		if (submitHash->error_stack()) {
-			submitHash->warn_unused(stderr, "DAGMAN");
+			if ( ! sf || ! sf->shareable || ! sf->warned) {
+				submitHash->warn_unused(stderr, "DAGMAN");
+				if (sf) { sf->warned = true; }
+			}
 			std::string errstk(submitHash->error_stack()->getFullText());
 			if (!errstk.empty()) {
 				debug_printf(DEBUG_QUIET, "Submit warning: %s", errstk.c_str());
@@ -739,6 +867,10 @@ finis:
 		}
 	}
 
+	if (owns_sf) {
+		delete sf;
+	}
+
 	if (!tmpDir.Cd2MainDir(errMsg)) {
 		debug_printf(DEBUG_QUIET,
 			"Could not change to original directory: %s\n",
@@ -749,9 +881,44 @@ finis:
 	return success;
 }
 
+bool
+DirectSubmitBatch::Commit()
+{
+	if ( ! m_qmgr) {
+		return false;
+	}
+
+	// commit transaction and disconnect queue
+	CondorError errstack;
+	bool success = DisconnectQ(m_qmgr, true, &errstack);
+	m_qmgr = NULL;
+	if (!success) {
+		debug_printf(DEBUG_NORMAL, "Failed to submit %d node%s: %s\n",
+			m_numNodes, m_numNodes == 1 ? "" : "s", errstack.getFullText().c_str());
+		m_aborted = true;
+	}
+	return success;
+}
+
+//-------------------------------------------------------------------------
+bool
+direct_condor_submit(const Dagman &dm, Job* node,
+	const char *workflowLogFile,
+	const MyString & parents,
+	const char *batchName,
+	const char *batchId,
+	CondorID& condorID)
+{
+	DirectSubmitBatch batch;
+	if ( ! batch.Add(dm, node, workflowLogFile, parents, batchName, batchId, condorID)) {
+		return false;
+	}
+	return batch.Commit();
+}
+
 bool send_reschedule(const Dagman & /*dm*/)
 {
-	if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", true))
+	if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", false))
 		return true; // submit already did it
 
 	DCSchedd schedd;
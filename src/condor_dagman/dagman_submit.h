@@ -22,6 +22,9 @@
 #define DAGMAN_SUBMIT_H
 
 #include "condor_id.h"
+#include "condor_qmgr.h"
+#include <map>
+#include <string>
 
 /** Submits a job to condor using popen().  This is a very primitive method
     to submitting a job, and SHOULD be replacable by a HTCondor Submit API.
@@ -69,6 +72,54 @@ bool direct_condor_submit(const Dagman &dm, Job* node,
 	const char *batchId,
 	CondorID& condorID);
 
+/** Submits the jobs of several nodes directly to the schedd over a single
+	qmgmt connection and in a single transaction, so that none of them are
+	visible in the queue until Commit() succeeds.  Nodes that use the same
+	submit file share one parse of it.
+*/
+class DirectSubmitBatch {
+public:
+	DirectSubmitBatch();
+
+		/// Aborts the transaction if it has not been committed.
+	~DirectSubmitBatch();
+
+	/** Queue the jobs for a node in the open transaction, connecting
+		to the schedd first if necessary.
+		@param condorID will hold the ID of the node's first job
+		@return true on success, false on failure; after a failure
+			Aborted() tells whether the transaction, including the jobs
+			of the nodes added before, had to be discarded
+	*/
+	bool Add(const Dagman &dm, Job* node,
+		const char *workflowLogFile,
+		const MyString &parents,
+		const char *batchName,
+		const char *batchId,
+		CondorID& condorID);
+
+	/** Commit the transaction and disconnect from the schedd.
+		@return true if the schedd accepted the jobs of all added nodes
+	*/
+	bool Commit();
+
+	bool Aborted() const { return m_aborted; }
+	int NumNodes() const { return m_numNodes; }
+
+	struct SubmitFile;
+
+private:
+	SubmitFile * getSubmitFile(const char *cmdFile, const char *directory,
+		std::string &errmsg, int &line);
+	void abort();
+
+	Qmgr_connection *m_qmgr;
+	bool m_aborted;
+	int m_numNodes;
+	std::string m_owner;
+	std::map<std::string, SubmitFile*> m_submitFiles;
+};
+
 bool send_reschedule(const Dagman &dm);
 
 void set_fake_condorID( int subprocID );
@@ -248,6 +248,10 @@ class Job {
 	NodeType GetType() const { return _type; }
 	void SetNoop( bool value ) { _noop = value; }
 	bool GetNoop( void ) const { return _noop; }
+		// Join nodes are NOOP nodes that DAGMan inserts between the
+		// parents and children of a PARENT ... CHILD statement.
+	void SetJoinNode( bool value ) { _joinNode = value; }
+	bool IsJoinNode( void ) const { return _joinNode; }
 
 	Script * _scriptPre;
 	Script * _scriptPost;
@@ -575,6 +579,9 @@ private:
 		// Whether this is a noop job (shouldn't actually be submitted
 		// to HTCondor).
 	bool _noop;
+		// Whether this node was inserted by DAGMan to stand in for
+		// the edges of a many-PARENT-many-CHILD statement.
+	bool _joinNode;
 		// What type of node (job, final, provisioner)
 	NodeType _type;
 public:
@@ -0,0 +1,560 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "node_journal.h"
+#include "dag.h"
+#include "debug.h"
+#include "safe_fopen.h"
+#include "stat_wrapper.h"
+
+static const char JOURNAL_MAGIC[] = "DAGNJRN2";
+static const size_t JOURNAL_MAGIC_LEN = 8;
+static const char CHECKPOINT_END[] = "CKPT";
+static const size_t CHECKPOINT_END_LEN = 4;
+
+static const char RECORD_EVENT = 'E';
+static const char RECORD_CHECKPOINT = 'C';
+
+	// Size of an event record, including the record type.
+static const size_t EVENT_RECORD_SIZE = 1 + 2 + 4 + 4 + 4 + 4 + 8 + 1 + 4 + 4;
+
+	// Size of the fixed part of a checkpoint, not counting the record
+	// type, the reader state or the end marker, and the offsets of its
+	// fields.
+static const size_t CHECKPOINT_FIXED_SIZE = 8 + 8 + 8 + 8 + 8 + 4;
+static const size_t CKPT_INODE = 0;
+static const size_t CKPT_SIZE = 8;
+static const size_t CKPT_HEAD_HASH = 16;
+static const size_t CKPT_TAIL_HASH = 24;
+static const size_t CKPT_EVENTS = 32;
+static const size_t CKPT_STATE_SIZE = 40;
+
+	// How much of the node log at its start, and just before the
+	// checkpointed position, is hashed to tell whether it is still the
+	// same log.
+static const size_t NODE_LOG_HASH_BYTES = 4096;
+
+//---------------------------------------------------------------------------
+static void
+put_u16( std::string &buf, unsigned int val )
+{
+	buf += (char)(val & 0xff);
+	buf += (char)((val >> 8) & 0xff);
+}
+
+static void
+put_u32( std::string &buf, uint32_t val )
+{
+	for ( int i = 0; i < 4; i++ ) {
+		buf += (char)((val >> (8 * i)) & 0xff);
+	}
+}
+
+static void
+put_u64( std::string &buf, uint64_t val )
+{
+	for ( int i = 0; i < 8; i++ ) {
+		buf += (char)((val >> (8 * i)) & 0xff);
+	}
+}
+
+static unsigned int
+get_u16( const unsigned char *p )
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t
+get_u32( const unsigned char *p )
+{
+	uint32_t val = 0;
+	for ( int i = 3; i >= 0; i-- ) {
+		val = (val << 8) | p[i];
+	}
+	return val;
+}
+
+static uint64_t
+get_u64( const unsigned char *p )
+{
+	uint64_t val = 0;
+	for ( int i = 7; i >= 0; i-- ) {
+		val = (val << 8) | p[i];
+	}
+	return val;
+}
+
+//---------------------------------------------------------------------------
+static bool
+stat_node_log( const char *nodeLog, uint64_t &inode, uint64_t &size )
+{
+	StatWrapper swrap( nodeLog );
+	if ( !swrap.IsBufValid() ) {
+		return false;
+	}
+	inode = (uint64_t)swrap.GetBuf()->st_ino;
+	size = (uint64_t)swrap.GetBuf()->st_size;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+static uint64_t
+hash_bytes( uint64_t hash, const unsigned char *p, size_t len )
+{
+		// 64-bit FNV-1a
+	for ( size_t i = 0; i < len; i++ ) {
+		hash = (hash ^ p[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+	// Hash the first bytes of the node log, and the bytes just before
+	// size, so that a node log that was removed and rewritten (even if it
+	// got the same inode back) doesn't match a checkpoint.
+static bool
+hash_node_log( const char *nodeLog, uint64_t size, uint64_t &headHash,
+			uint64_t &tailHash )
+{
+	FILE *fp = safe_fopen_wrapper_follow( nodeLog, "rb" );
+	if ( !fp ) {
+		return false;
+	}
+
+	unsigned char buf[NODE_LOG_HASH_BYTES];
+	size_t len = size < NODE_LOG_HASH_BYTES ? (size_t)size : NODE_LOG_HASH_BYTES;
+	bool ok = fread( buf, 1, len, fp ) == len;
+	headHash = hash_bytes( 14695981039346656037ULL, buf, len );
+
+	if ( ok && fseek( fp, (long)(size - len), SEEK_SET ) == 0 ) {
+		ok = fread( buf, 1, len, fp ) == len;
+		tailHash = hash_bytes( 14695981039346656037ULL, buf, len );
+	} else {
+		ok = false;
+	}
+
+	fclose( fp );
+	return ok;
+}
+
+//---------------------------------------------------------------------------
+NodeJournal::NodeJournal() :
+	_fp( NULL ),
+	_numEvents( 0 ),
+	_pendingEvents( 0 ),
+	_replayEvents( 0 ),
+	_error( false )
+{
+}
+
+//---------------------------------------------------------------------------
+NodeJournal::~NodeJournal()
+{
+	Close();
+}
+
+//---------------------------------------------------------------------------
+void
+NodeJournal::Close()
+{
+	if ( _fp ) {
+		fclose( _fp );
+		_fp = NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+void
+NodeJournal::Remove( const char *filename )
+{
+	Close();
+	if ( unlink( filename ) != 0 && errno != ENOENT ) {
+		debug_printf( DEBUG_NORMAL, "Warning: unable to remove node state "
+					"journal %s (errno %d, %s)\n", filename, errno,
+					strerror( errno ) );
+	}
+}
+
+//---------------------------------------------------------------------------
+bool
+NodeJournal::Create( const char *filename, int numNodes, uint64_t signature )
+{
+	Close();
+	_filename = filename;
+	_numEvents = 0;
+	_pendingEvents = 0;
+	_replayEvents = 0;
+	_error = false;
+
+	_fp = safe_fopen_wrapper_follow( filename, "wb" );
+	if ( !_fp ) {
+		debug_printf( DEBUG_QUIET, "Warning: unable to create node state "
+					"journal %s (errno %d, %s); recovery will re-read the "
+					"node log\n", filename, errno, strerror( errno ) );
+		return false;
+	}
+
+	if ( !WriteHeader( numNodes, signature ) ) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+bool
+NodeJournal::WriteHeader( int numNodes, uint64_t signature )
+{
+	std::string buf( JOURNAL_MAGIC, JOURNAL_MAGIC_LEN );
+	put_u32( buf, (uint32_t)numNodes );
+	put_u64( buf, signature );
+	if ( fwrite( buf.data(), buf.size(), 1, _fp ) != 1 || fflush( _fp ) != 0 ) {
+		debug_printf( DEBUG_QUIET, "Warning: error (%d, %s) writing node "
+					"state journal %s\n", errno, strerror( errno ),
+					_filename.c_str() );
+		return false;
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+bool
+NodeJournal::Open( const char *filename, int numNodes, uint64_t signature,
+			const char *nodeLog, ReadUserLog::FileState &state )
+{
+	Close();
+	_filename = filename;
+	_numEvents = 0;
+	_pendingEvents = 0;
+	_replayEvents = 0;
+	_error = false;
+
+	_fp = safe_fopen_wrapper_follow( filename, "r+b" );
+	if ( !_fp ) {
+		debug_printf( DEBUG_NORMAL, "No usable node state journal %s "
+					"(errno %d, %s)\n", filename, errno, strerror( errno ) );
+		return false;
+	}
+
+	unsigned char header[JOURNAL_MAGIC_LEN + 4 + 8];
+	if ( fread( header, sizeof(header), 1, _fp ) != 1 ||
+				memcmp( header, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN ) != 0 ) {
+		debug_printf( DEBUG_NORMAL, "Node state journal %s has a bad "
+					"header; ignoring it\n", filename );
+		Close();
+		return false;
+	}
+	if ( get_u32( header + JOURNAL_MAGIC_LEN ) != (uint32_t)numNodes ||
+				get_u64( header + JOURNAL_MAGIC_LEN + 4 ) != signature ) {
+		debug_printf( DEBUG_NORMAL, "Node state journal %s was written for "
+					"different DAG nodes; ignoring it\n", filename );
+		Close();
+		return false;
+	}
+
+		// Find the last complete checkpoint.  Anything after it (including
+		// a partly-written record) is thrown away.
+	long checkpointEnd = -1;
+	uint64_t checkpointEvents = 0;
+	uint64_t logInode = 0;
+	uint64_t logSize = 0;
+	uint64_t logHeadHash = 0;
+	uint64_t logTailHash = 0;
+	uint64_t events = 0;
+	std::string readerState;
+
+	int type;
+	while ( (type = fgetc( _fp )) != EOF ) {
+		if ( type == RECORD_EVENT ) {
+			unsigned char rec[EVENT_RECORD_SIZE - 1];
+			if ( fread( rec, sizeof(rec), 1, _fp ) != 1 ) {
+				break;
+			}
+			events++;
+
+		} else if ( type == RECORD_CHECKPOINT ) {
+			unsigned char fixed[CHECKPOINT_FIXED_SIZE];
+			if ( fread( fixed, sizeof(fixed), 1, _fp ) != 1 ) {
+				break;
+			}
+			uint32_t stateSize = get_u32( fixed + CKPT_STATE_SIZE );
+			if ( (int)stateSize != state.size ) {
+				break;
+			}
+			std::string buf( stateSize + CHECKPOINT_END_LEN, '\0' );
+			if ( fread( &buf[0], buf.size(), 1, _fp ) != 1 ||
+						memcmp( buf.data() + stateSize, CHECKPOINT_END,
+						CHECKPOINT_END_LEN ) != 0 ||
+						get_u64( fixed + CKPT_EVENTS ) != events ) {
+				break;
+			}
+			logInode = get_u64( fixed + CKPT_INODE );
+			logSize = get_u64( fixed + CKPT_SIZE );
+			logHeadHash = get_u64( fixed + CKPT_HEAD_HASH );
+			logTailHash = get_u64( fixed + CKPT_TAIL_HASH );
+			checkpointEvents = events;
+			readerState.assign( buf.data(), stateSize );
+			checkpointEnd = ftell( _fp );
+
+		} else {
+			break;
+		}
+	}
+
+	if ( checkpointEnd < 0 ) {
+		debug_printf( DEBUG_NORMAL, "Node state journal %s has no "
+					"checkpoint; ignoring it\n", filename );
+		Close();
+		return false;
+	}
+
+		// The checkpoint is only good if the node log is the same file,
+		// and hasn't been truncated or rewritten, since it was written.
+	uint64_t curInode = 0;
+	uint64_t curSize = 0;
+	uint64_t curHeadHash = 0;
+	uint64_t curTailHash = 0;
+	if ( !stat_node_log( nodeLog, curInode, curSize ) ||
+				curInode != logInode || curSize < logSize ||
+				!hash_node_log( nodeLog, logSize, curHeadHash, curTailHash ) ||
+				curHeadHash != logHeadHash || curTailHash != logTailHash ) {
+		debug_printf( DEBUG_NORMAL, "Node log %s has changed since node "
+					"state journal %s was written; ignoring the journal\n",
+					nodeLog, filename );
+		Close();
+		return false;
+	}
+
+	if ( ftruncate( fileno( _fp ), checkpointEnd ) != 0 ) {
+		debug_printf( DEBUG_NORMAL, "Error (%d, %s) truncating node state "
+					"journal %s; ignoring it\n", errno, strerror( errno ),
+					filename );
+		Close();
+		return false;
+	}
+
+		// Position the file for replay, or for appending if there is
+		// nothing to replay.
+	if ( fseek( _fp, checkpointEvents > 0 ? sizeof(header) : 0,
+				checkpointEvents > 0 ? SEEK_SET : SEEK_END ) != 0 ) {
+		Close();
+		return false;
+	}
+
+	memcpy( state.buf, readerState.data(), state.size );
+	_numEvents = checkpointEvents;
+	_replayEvents = checkpointEvents;
+
+	debug_printf( DEBUG_NORMAL, "Replaying %llu events from node state "
+				"journal %s\n", (unsigned long long)checkpointEvents,
+				filename );
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+bool
+NodeJournal::ReadEvent( const Dag &dag, ULogEvent *&event )
+{
+	event = NULL;
+
+	if ( !_fp || _replayEvents == 0 ) {
+		return false;
+	}
+
+	unsigned char rec[EVENT_RECORD_SIZE - 1];
+	int type;
+	while ( (type = fgetc( _fp )) == RECORD_CHECKPOINT ) {
+			// We already checked the checkpoints in Open(); just skip
+			// over them.
+		unsigned char fixed[CHECKPOINT_FIXED_SIZE];
+		if ( fread( fixed, sizeof(fixed), 1, _fp ) != 1 ||
+					fseek( _fp, get_u32( fixed + CKPT_STATE_SIZE ) + CHECKPOINT_END_LEN,
+					SEEK_CUR ) != 0 ) {
+			type = EOF;
+			break;
+		}
+	}
+	if ( type != RECORD_EVENT || fread( rec, sizeof(rec), 1, _fp ) != 1 ) {
+		debug_printf( DEBUG_QUIET, "ERROR: unexpected end of node state "
+					"journal %s\n", _filename.c_str() );
+		_error = true;
+		return false;
+	}
+
+	ULogEventNumber eventNumber = (ULogEventNumber)get_u16( rec );
+	JobID_t nodeID = (JobID_t)get_u32( rec + 2 );
+	Job *node = dag.FindNodeByNodeID( nodeID );
+	event = instantiateEvent( eventNumber );
+	if ( !node || !event ) {
+		debug_printf( DEBUG_QUIET, "ERROR: bad event record (node %d, "
+					"event %d) in node state journal %s\n", nodeID,
+					eventNumber, _filename.c_str() );
+		delete event;
+		event = NULL;
+		_error = true;
+		return false;
+	}
+
+	event->cluster = (int)get_u32( rec + 6 );
+	event->proc = (int)get_u32( rec + 10 );
+	event->subproc = (int)get_u32( rec + 14 );
+	event->SetEventclock( (time_t)get_u64( rec + 18 ) );
+	bool normal = rec[26] != 0;
+	int returnValue = (int)get_u32( rec + 27 );
+	int signalNumber = (int)get_u32( rec + 31 );
+
+		// Fill in the parts of the event that DAGMan uses to match
+		// it to its node, and to decide how the node finished.
+	std::string notes;
+	formatstr( notes, "DAG Node: %s", node->GetJobName() );
+	switch ( eventNumber ) {
+	case ULOG_SUBMIT:
+		((SubmitEvent *)event)->submitEventLogNotes = strdup( notes.c_str() );
+		break;
+	case ULOG_CLUSTER_SUBMIT:
+		((ClusterSubmitEvent *)event)->submitEventLogNotes =
+					strdup( notes.c_str() );
+		break;
+	case ULOG_PRESKIP:
+		((PreSkipEvent *)event)->skipEventLogNotes = strdup( notes.c_str() );
+		break;
+	case ULOG_JOB_TERMINATED:
+		{
+			JobTerminatedEvent *term = (JobTerminatedEvent *)event;
+			term->normal = normal;
+			term->returnValue = returnValue;
+			term->signalNumber = signalNumber;
+		}
+		break;
+	case ULOG_POST_SCRIPT_TERMINATED:
+		{
+			PostScriptTerminatedEvent *term =
+						(PostScriptTerminatedEvent *)event;
+			term->normal = normal;
+			term->returnValue = returnValue;
+			term->signalNumber = signalNumber;
+			free( term->dagNodeName );
+			term->dagNodeName = strdup( node->GetJobName() );
+		}
+		break;
+	default:
+		break;
+	}
+
+	if ( --_replayEvents == 0 ) {
+			// Done replaying; new records go at the end.
+		if ( fseek( _fp, 0, SEEK_END ) != 0 ) {
+			Close();
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+void
+NodeJournal::WriteEvent( const ULogEvent *event, const Job *node )
+{
+	if ( !_fp || _replayEvents > 0 ) {
+		return;
+	}
+
+	bool normal = false;
+	int returnValue = 0;
+	int signalNumber = 0;
+	if ( event->eventNumber == ULOG_JOB_TERMINATED ) {
+		const JobTerminatedEvent *term = (const JobTerminatedEvent *)event;
+		normal = term->normal;
+		returnValue = term->returnValue;
+		signalNumber = term->signalNumber;
+	} else if ( event->eventNumber == ULOG_POST_SCRIPT_TERMINATED ) {
+		const PostScriptTerminatedEvent *term =
+					(const PostScriptTerminatedEvent *)event;
+		normal = term->normal;
+		returnValue = term->returnValue;
+		signalNumber = term->signalNumber;
+	}
+
+	std::string buf;
+	buf.reserve( EVENT_RECORD_SIZE );
+	buf += RECORD_EVENT;
+	put_u16( buf, (unsigned int)event->eventNumber );
+	put_u32( buf, (uint32_t)node->GetJobID() );
+	put_u32( buf, (uint32_t)event->cluster );
+	put_u32( buf, (uint32_t)event->proc );
+	put_u32( buf, (uint32_t)event->subproc );
+	put_u64( buf, (uint64_t)event->GetEventclock() );
+	buf += (char)(normal ? 1 : 0);
+	put_u32( buf, (uint32_t)returnValue );
+	put_u32( buf, (uint32_t)signalNumber );
+
+	if ( fwrite( buf.data(), buf.size(), 1, _fp ) != 1 ) {
+		debug_printf( DEBUG_QUIET, "Warning: error (%d, %s) writing node "
+					"state journal %s; no longer writing it\n", errno,
+					strerror( errno ), _filename.c_str() );
+		Close();
+		return;
+	}
+	_numEvents++;
+	_pendingEvents++;
+}
+
+//---------------------------------------------------------------------------
+bool
+NodeJournal::WriteCheckpoint( const char *nodeLog,
+			const ReadUserLog::FileState &state )
+{
+	if ( !_fp || _replayEvents > 0 ) {
+		return false;
+	}
+
+	uint64_t logInode = 0;
+	uint64_t logSize = 0;
+	uint64_t logHeadHash = 0;
+	uint64_t logTailHash = 0;
+	if ( !stat_node_log( nodeLog, logInode, logSize ) ||
+				!hash_node_log( nodeLog, logSize, logHeadHash, logTailHash ) ) {
+		return false;
+	}
+
+	std::string buf;
+	buf += RECORD_CHECKPOINT;
+	put_u64( buf, logInode );
+	put_u64( buf, logSize );
+	put_u64( buf, logHeadHash );
+	put_u64( buf, logTailHash );
+	put_u64( buf, _numEvents );
+	put_u32( buf, (uint32_t)state.size );
+	buf.append( (const char *)state.buf, state.size );
+	buf.append( CHECKPOINT_END, CHECKPOINT_END_LEN );
+
+	if ( fwrite( buf.data(), buf.size(), 1, _fp ) != 1 ||
+				fflush( _fp ) != 0 ) {
+		debug_printf( DEBUG_QUIET, "Warning: error (%d, %s) writing node "
+					"state journal %s; no longer writing it\n", errno,
+					strerror( errno ), _filename.c_str() );
+		Close();
+		return false;
+	}
+	_pendingEvents = 0;
+
+	return true;
+}
@@ -0,0 +1,164 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+
+#ifndef _NODE_JOURNAL_H
+#define _NODE_JOURNAL_H
+
+// This class handles the node state journal, a compact binary record of
+// the node job log events that DAGMan has processed.  It is written next
+// to the default node log (<node log>.journal), and lets DAGMan in
+// recovery mode rebuild the state of its nodes without re-reading and
+// re-parsing the whole node log.
+//
+// The journal holds one fixed-size record for each event that DAGMan
+// matched to a node, with only the fields that DAGMan itself uses (node
+// ID, event type, HTCondor ID, time, and exit status).  Every so often
+// DAGMan appends a checkpoint holding the node log reader state at that
+// point.  In recovery mode, DAGMan replays the events up to the last
+// checkpoint from the journal, then reads the rest of the node log from
+// the checkpointed position.  Anything after the last checkpoint is
+// discarded, so a journal cut short by a crash is still usable.
+//
+// File layout (all integers little endian):
+//
+//   header:     "DAGNJRN2", u32 node count, u64 node signature
+//   event:      'E', u16 event number, u32 node ID, i32 cluster,
+//               i32 proc, i32 subproc, i64 event time, u8 normal,
+//               i32 return value, i32 signal number
+//   checkpoint: 'C', u64 node log inode, u64 node log size,
+//               u64 hash of the start of the node log, u64 hash of the
+//               node log just before the checkpointed size,
+//               u64 event record count, u32 state size, reader state,
+//               "CKPT"
+//
+// The node signature is a hash of the node IDs and names, so that a
+// journal written for a different DAG is never replayed.  The node log
+// hashes keep a journal from being replayed against a node log that was
+// rewritten, even if it kept the same inode.
+//
+// All node jobs write to the default node log, which is the only log
+// DAGMan reads, so a checkpoint of that one log covers every event.
+
+#include "condor_event.h"
+#include "read_user_log.h"
+#include "job.h"
+
+class Dag;
+
+class NodeJournal {
+public:
+	/** Constructor.
+	*/
+	NodeJournal();
+
+	/** Destructor.
+	*/
+	~NodeJournal();
+
+	/** Start a new, empty journal, replacing any existing one.
+		@param filename The name of the journal file.
+		@param numNodes The number of nodes in the DAG.
+		@param signature The node signature of the DAG.
+		@return true if successful, false otherwise
+	*/
+	bool Create( const char *filename, int numNodes, uint64_t signature );
+
+	/** Open an existing journal for recovery.  This checks the journal
+		against the DAG and the node log, finds the last checkpoint,
+		and throws away anything after it.
+		@param filename The name of the journal file.
+		@param numNodes The number of nodes in the DAG.
+		@param signature The node signature of the DAG.
+		@param nodeLog The node log the journal was written for.
+		@param state (returned) The node log reader state at the last
+			checkpoint; must be set up with ReadUserLog::InitFileState().
+		@return true if the journal can be replayed, false otherwise
+	*/
+	bool Open( const char *filename, int numNodes, uint64_t signature,
+				const char *nodeLog, ReadUserLog::FileState &state );
+
+	/** Get the next event to replay from a journal that has been
+		opened with Open().
+		@param dag The DAG, used to find the node names that some
+			events need.
+		@param event (returned) A newly allocated event, which the
+			caller must delete.
+		@return true if we got an event, false when there are no more
+			(or there was an error, see Error())
+	*/
+	bool ReadEvent( const Dag &dag, ULogEvent *&event );
+
+	/** Did ReadEvent() stop because of an error?
+	*/
+	bool Error() const { return _error; }
+
+	/** Append a record of an event to the journal.
+		@param event The event.
+		@param node The node the event belongs to.
+	*/
+	void WriteEvent( const ULogEvent *event, const Job *node );
+
+	/** Append a checkpoint to the journal and flush it.
+		@param nodeLog The node log.
+		@param state The current node log reader state.
+		@return true if successful, false otherwise
+	*/
+	bool WriteCheckpoint( const char *nodeLog,
+				const ReadUserLog::FileState &state );
+
+	/** The number of events written since the last checkpoint.
+	*/
+	int PendingEvents() const { return _pendingEvents; }
+
+	/** Is the journal open?
+	*/
+	bool IsOpen() const { return _fp != NULL; }
+
+	/** Close the journal, stopping any further writes.
+	*/
+	void Close();
+
+	/** Close and delete the journal file.
+		@param filename The name of the journal file, which need not
+			be open.
+	*/
+	void Remove( const char *filename );
+
+private:
+	bool WriteHeader( int numNodes, uint64_t signature );
+
+		// The name of the journal file.
+	std::string _filename;
+
+	FILE *_fp;
+
+		// The number of event records in the journal.
+	uint64_t _numEvents;
+
+		// The number of event records written since the last checkpoint.
+	int _pendingEvents;
+
+		// While replaying: the number of event records left to replay.
+	uint64_t _replayEvents;
+
+	bool _error;
+};
+
+#endif	// _NODE_JOURNAL_H
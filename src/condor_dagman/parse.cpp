@@ -42,10 +42,18 @@
 #include "condor_string.h"  /* for strnewp() */
 #include "condor_getcwd.h"
 
+#if !defined(WIN32) && defined(HAVE_PTHREADS)
+#include <pthread.h>
+#endif
+
 static const char   COMMENT    = '#';
 static const char * DELIMITERS = " \t";
 static const char * ILLEGAL_CHARS = "+";
 
+	// Prefix of the names of the join nodes we insert for
+	// many-PARENT-many-CHILD statements.
+#define JOIN_NODE_PREFIX "_condor_join_node"
+
 static ExtArray<char*> _spliceScope;
 static bool _useDagDir = false;
 
@@ -73,7 +81,7 @@ static bool pre_parse_node(MyString & nodename, const char * &submitFile);
 
 static bool parse_script(const char *endline, Dag *dag, 
 		const char *filename, int lineNumber);
-static bool parse_parent(Dag *dag, 
+static bool parse_parent(Dag *dag, char *rest,
 		const char *filename, int lineNumber);
 static bool parse_retry(Dag *dag, 
 		const char *filename, int lineNumber);
@@ -103,6 +111,44 @@ static bool parse_pin_in_out( Dag  *dag, const char *filename,
 static bool parse_include( Dag  *dag, const char *filename, int  lineNumber );
 static MyString munge_job_name(const char *jobName);
 
+	// Result codes for resolve_parent().
+enum {
+	PARENT_OK = 0,
+	PARENT_ERR_UNKNOWN_NODE,
+	PARENT_ERR_NO_PARENTS,
+	PARENT_ERR_NO_CHILD_TOKEN,
+	PARENT_ERR_NO_CHILDREN
+};
+
+	// A PARENT ... CHILD line from the second pass.  The node names are
+	// looked up by resolve_parent(), and the dependencies are added to
+	// the dag by apply_parent().
+struct ParentStatement {
+	int lineNumber;
+	std::string line; // the rest of the line after the PARENT token
+	std::forward_list<Job*> parents;
+	std::forward_list<Job*> children;
+	std::vector<std::string> childSplices; // for debug output only
+	int error;
+	std::string badName; // for PARENT_ERR_UNKNOWN_NODE
+	ParentStatement() : lineNumber(0), error(PARENT_OK) {}
+};
+
+	// Consecutive PARENT lines are collected into batches of up to this
+	// many lines, so that their node names can be looked up in parallel.
+static const size_t PARENT_BATCH_SIZE = 8192;
+	// Don't start a thread to look up fewer lines than this.
+static const size_t MIN_PARENTS_PER_THREAD = 512;
+	// Upper limit for DAGMAN_PARSE_THREADS = 0.
+static const int MAX_AUTO_PARSE_THREADS = 8;
+
+static int parse_thread_count(void);
+static void resolve_parent(Dag *dag, ParentStatement &stmt);
+static bool apply_parent(Dag *dag, ParentStatement &stmt,
+		const char *filename);
+static bool flush_parents(Dag *dag, std::vector<ParentStatement> &batch,
+		const char *filename, int numThreads);
+
 static MyString current_splice_scope(void);
 
 static bool get_next_var( const char *filename, int lineNumber, char *&str,
@@ -280,7 +326,7 @@ bool parse(Dag *dag, const char *filename, bool useDagDir,
 						   "submitfile" );
 			if (parsed_line_successfully && inline_submit) {
 				// go into inline subfile parsing mode
-				if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", true)) {
+				if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", false)) {
 					debug_printf(DEBUG_NORMAL, "ERROR: To use an inline job "
 					  "description for node %s, DAGMAN_USE_CONDOR_SUBMIT must "
 					  "be set to False. Aborting.\n", nodename.Value());
@@ -340,7 +386,7 @@ bool parse(Dag *dag, const char *filename, bool useDagDir,
 					"submitfile");
 			if (parsed_line_successfully && inline_submit) {
 				// go into inline subfile parsing mode
-				if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", true)) {
+				if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", false)) {
 					debug_printf(DEBUG_NORMAL, "ERROR: To use an inline job "
 					  "description for node %s, DAGMAN_USE_CONDOR_SUBMIT must "
 					  "be set to False. Aborting.\n", nodename.Value());
@@ -406,7 +452,7 @@ bool parse(Dag *dag, const char *filename, bool useDagDir,
 			bool is_submit_description = desc && *desc == '{';
 			if (is_submit_description) {
 				// Start parsing submit description
-				if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", true)) {
+				if (param_boolean("DAGMAN_USE_CONDOR_SUBMIT", false)) {
 					debug_printf(DEBUG_NORMAL, "ERROR: To use an inline job "
 					  "description for node %s, DAGMAN_USE_CONDOR_SUBMIT must "
 					  "be set to False. Aborting.\n", descName.Value());
@@ -463,6 +509,15 @@ bool parse(Dag *dag, const char *filename, bool useDagDir,
 	//lineNumber = 0;
 	src.line = 0;
 
+	// All of the nodes and splices of this dag were defined by the first
+	// pass, so looking up the nodes named by PARENT lines no longer
+	// changes anything.  When we have more than one parse thread, runs
+	// of consecutive PARENT lines are looked up in parallel, and their
+	// dependencies are then added in file order before the next line
+	// that isn't a PARENT line is parsed.
+	int numThreads = parse_thread_count();
+	std::vector<ParentStatement> pendingParents;
+
 	//
 	// This loop will read every line of the input file
 	//
@@ -489,8 +544,19 @@ bool parse(Dag *dag, const char *filename, bool useDagDir,
 		char *token = strtok(line, DELIMITERS);
 		if ( !token ) continue; // so Coverity is happy
 
+			// The rest of the line after the token.
+		char *rest = token + strlen(token);
+		if ( rest < endline ) rest++;
+
 		bool parsed_line_successfully;
 
+		if ( !pendingParents.empty() && strcasecmp(token, "PARENT") != 0 ) {
+			if ( !flush_parents( dag, pendingParents, filename, numThreads ) ) {
+				fclose(fp);
+				return false;
+			}
+		}
+
 		// Handle a Job spec
 		// Example Syntax is:  JOB j1 j1.condor [DONE]
 		//
@@ -578,7 +644,19 @@ bool parse(Dag *dag, const char *filename, bool useDagDir,
 		// Handle a Dependency spec
 		// Example Syntax is:  PARENT p1 p2 p3 ... CHILD c1 c2 c3 ...
 		else if (strcasecmp(token, "PARENT") == 0) {
-			parsed_line_successfully = parse_parent(dag, filename, lineNumber);
+			if ( numThreads > 1 ) {
+				pendingParents.push_back( ParentStatement() );
+				pendingParents.back().lineNumber = lineNumber;
+				pendingParents.back().line = rest;
+				parsed_line_successfully = true;
+				if ( pendingParents.size() >= PARENT_BATCH_SIZE ) {
+					parsed_line_successfully = flush_parents( dag,
+								pendingParents, filename, numThreads );
+				}
+			} else {
+				parsed_line_successfully = parse_parent(dag, rest,
+							filename, lineNumber);
+			}
 		}
 			
 		// Handle a Retry spec
@@ -750,6 +828,12 @@ bool parse(Dag *dag, const char *filename, bool useDagDir,
 		}
 	}
 
+	if ( !pendingParents.empty() &&
+				!flush_parents( dag, pendingParents, filename, numThreads ) ) {
+		fclose(fp);
+		return false;
+	}
+
 	fclose(fp);
 
 	// always remember which were the inital and final nodes for this dag.
@@ -1225,34 +1309,35 @@ parse_script(
 
 //-----------------------------------------------------------------------------
 // 
-// Function: parse_parent
-// Purpose:  parse a line of the format PARENT node-name+ CHILD node-name+
-//           where there can be one or more parent nodes and one or more
-//           children nodes.
+// Function: resolve_parent
+// Purpose:  look up the nodes named in a line of the format
+//           PARENT node-name+ CHILD node-name+
+//           without changing the dag.  This only reads the node and splice
+//           tables and doesn't print anything, so that once the first pass
+//           has defined all of the nodes it can be called for many PARENT
+//           lines at once from worker threads.  Any error is recorded in
+//           the statement and reported by apply_parent().
 //
 //-----------------------------------------------------------------------------
-static bool 
-parse_parent(
-	Dag  *dag, 
-	const char *filename, 
-	int  lineNumber)
+static void
+resolve_parent( Dag *dag, ParentStatement &stmt )
 {
-	const char * example = "PARENT p1 [p2 p3 ...] CHILD c1 [c2 c3 ...]";
-	MyString failReason = "";
+	char *save = NULL;
+	char *line = &stmt.line[0];
 	const char *jobName;
-	
+
+	stmt.error = PARENT_OK;
+
 	// get the job objects for the parents
-	std::forward_list<Job*> parents;
-	auto last_parent = parents.before_begin();
-	while ((jobName = strtok (NULL, DELIMITERS)) != NULL &&
-		   strcasecmp (jobName, "CHILD") != 0) {
-		const char *jobNameOrig = jobName; // for error output
+	auto last_parent = stmt.parents.before_begin();
+	for ( jobName = strtok_r( line, DELIMITERS, &save );
+		  jobName != NULL && strcasecmp( jobName, "CHILD" ) != 0;
+		  jobName = strtok_r( NULL, DELIMITERS, &save ) ) {
 		MyString tmpJobName = munge_job_name(jobName);
-		const char *jobName2 = tmpJobName.Value();
 
 		// if splice name then deal with that first...
 		Dag *splice_dag;
-		if (dag->LookupSplice(jobName2, splice_dag) == 0) {
+		if (dag->LookupSplice(tmpJobName, splice_dag) == 0) {
 
 			// grab all of the final nodes of the splice and make them parents
 			// for this job.
@@ -1262,102 +1347,136 @@ parse_parent(
 			// now add each final node as a parent
 			for (int i = 0; i < splice_final->length(); i++) {
 				Job *job = (*splice_final)[i];
-				last_parent = parents.insert_after(last_parent, job);
+				last_parent = stmt.parents.insert_after(last_parent, job);
 			}
 
 		} else {
 
-			// orig code
 			// if the name is not a splice, then see if it is a true node name.
-			Job *job = dag->FindNodeByName( jobName2 );
+			Job *job = dag->LookupNodeByName( tmpJobName );
 			if (job == NULL) {
 				// oops, it was neither a splice nor a parent name, bail
-				debug_printf( DEBUG_QUIET, 
-						  "ERROR: %s (line %d): Unknown Job %s\n",
-						  filename, lineNumber, jobNameOrig );
-				return false;
+				stmt.error = PARENT_ERR_UNKNOWN_NODE;
+				stmt.badName = jobName;
+				return;
 			}
-			last_parent = parents.insert_after(last_parent, job);
+			last_parent = stmt.parents.insert_after(last_parent, job);
 		}
 	}
 	
 	// There must be one or more parent job names before
 	// the CHILD token
-	if (parents.empty()) {
-		debug_printf( DEBUG_QUIET, "ERROR: %s (line %d): "
-					  "Missing Parent Job names\n",
-					  filename, lineNumber );
-		exampleSyntax (example);
-		return false;
+	if (stmt.parents.empty()) {
+		stmt.error = PARENT_ERR_NO_PARENTS;
+		return;
 	}
 
-	parents.sort(SortJobsById());
-	parents.unique(EqualJobsById());
+	stmt.parents.sort(SortJobsById());
+	stmt.parents.unique(EqualJobsById());
 	
 	if (jobName == NULL) {
-		debug_printf( DEBUG_QUIET, 
-					  "ERROR: %s (line %d): Expected CHILD token\n",
-					  filename, lineNumber );
-		exampleSyntax (example);
-		return false;
+		stmt.error = PARENT_ERR_NO_CHILD_TOKEN;
+		return;
 	}
 	
-	std::forward_list<Job*> children;
-	auto last_child = children.before_begin();
+	auto last_child = stmt.children.before_begin();
 	
 	// get the job objects for the children
-	while ((jobName = strtok (NULL, DELIMITERS)) != NULL) {
-		const char *jobNameOrig = jobName; // for error output
+	while ((jobName = strtok_r( NULL, DELIMITERS, &save )) != NULL) {
 		MyString tmpJobName = munge_job_name(jobName);
-		const char *jobName2 = tmpJobName.Value();
 
 		// if splice name then deal with that first...
 		Dag *splice_dag;
-		if (dag->LookupSplice(jobName2, splice_dag) == 0) {
+		if (dag->LookupSplice(tmpJobName, splice_dag) == 0) {
 			// grab all of the initial nodes of the splice and make them 
 			// children for this job.
-
-			debug_printf( DEBUG_DEBUG_1, "%s (line %d): "
-				"Detected splice %s as a child....\n", filename, lineNumber,
-					jobName2);
+			stmt.childSplices.push_back(tmpJobName.Value());
 
 			ExtArray<Job*> *splice_initial;
 			splice_initial = splice_dag->InitialRecordedNodes();
-			debug_printf( DEBUG_DEBUG_1, "Adding %d initial nodes\n", 
-				splice_initial->length());
 
 			// now add each initial node as a child
 			for (int i = 0; i < splice_initial->length(); i++) {
 				Job *job = (*splice_initial)[i];
 
-				last_child = children.insert_after(last_child, job);
+				last_child = stmt.children.insert_after(last_child, job);
 			}
 
 		} else {
 
-			// orig code
 			// if the name is not a splice, then see if it is a true node name.
-			Job *job = dag->FindNodeByName( jobName2 );
+			Job *job = dag->LookupNodeByName( tmpJobName );
 			if (job == NULL) {
 				// oops, it was neither a splice nor a child name, bail
-				debug_printf( DEBUG_QUIET, 
-						  "ERROR: %s (line %d): Unknown Job %s\n",
-						  filename, lineNumber, jobNameOrig );
-				return false;
+				stmt.error = PARENT_ERR_UNKNOWN_NODE;
+				stmt.badName = jobName;
+				return;
 			}
-			last_child = children.insert_after(last_child, job);
+			last_child = stmt.children.insert_after(last_child, job);
 		}
 	}
 	
-	if (children.empty()) {
+	if (stmt.children.empty()) {
+		stmt.error = PARENT_ERR_NO_CHILDREN;
+		return;
+	}
+	
+	stmt.children.sort(SortJobsById());
+	stmt.children.unique(EqualJobsById());
+}
+
+//-----------------------------------------------------------------------------
+// 
+// Function: apply_parent
+// Purpose:  report any error found by resolve_parent(), otherwise add
+//           the dependencies of a resolved PARENT ... CHILD line to the
+//           dag.  This must be called from the main thread, in the order
+//           that the lines appear in the DAG file.
+//
+//-----------------------------------------------------------------------------
+static bool
+apply_parent( Dag *dag, ParentStatement &stmt, const char *filename )
+{
+	const char * example = "PARENT p1 [p2 p3 ...] CHILD c1 [c2 c3 ...]";
+	MyString failReason = "";
+	int lineNumber = stmt.lineNumber;
+
+	switch ( stmt.error ) {
+	case PARENT_OK:
+		break;
+	case PARENT_ERR_UNKNOWN_NODE:
+		debug_printf( DEBUG_QUIET, 
+				  "ERROR: %s (line %d): Unknown Job %s\n",
+				  filename, lineNumber, stmt.badName.c_str() );
+		return false;
+	case PARENT_ERR_NO_PARENTS:
+		debug_printf( DEBUG_QUIET, "ERROR: %s (line %d): "
+					  "Missing Parent Job names\n",
+					  filename, lineNumber );
+		exampleSyntax (example);
+		return false;
+	case PARENT_ERR_NO_CHILD_TOKEN:
+		debug_printf( DEBUG_QUIET, 
+					  "ERROR: %s (line %d): Expected CHILD token\n",
+					  filename, lineNumber );
+		exampleSyntax (example);
+		return false;
+	case PARENT_ERR_NO_CHILDREN:
+	default:
 		debug_printf( DEBUG_QUIET, "ERROR: %s (line %d): Missing Child Job names\n",
 					  filename, lineNumber );
 		exampleSyntax (example);
 		return false;
 	}
-	
-	children.sort(SortJobsById());
-	children.unique(EqualJobsById());
+
+	for ( size_t i = 0; i < stmt.childSplices.size(); i++ ) {
+		debug_printf( DEBUG_DEBUG_1, "%s (line %d): "
+			"Detected splice %s as a child....\n", filename, lineNumber,
+				stmt.childSplices[i].c_str() );
+	}
+
+	std::forward_list<Job*> &parents = stmt.parents;
+	std::forward_list<Job*> &children = stmt.children;
 
 	//
 	// Now add all the dependencies
@@ -1370,38 +1489,49 @@ parse_parent(
 
 	// If this statement has multiple parent nodes and multiple child nodes, we
 	// can optimize the dag structure by creating an intermediate "join node"
-	// connecting the two sets.
+	// connecting the two sets.  A join node replaces parents*children edges
+	// with parents+children edges, so we only add one when that is fewer.
+	// The join node number is used up either way so that the names of the
+	// join nodes (which appear in rescue DAGs) don't depend on the shape of
+	// the earlier statements.
 	if (useJoinNodes && more_than_one(parents) && more_than_one(children)) {
-		// First create the join node and add it
-		std::string joinNodeName;
-		formatstr(joinNodeName, "_condor_join_node%d", ++numJoinNodes);
-		Job* joinNode = AddNode(dag, joinNodeName.c_str(), "", "noop.sub", true, 
-			false, NodeType::JOB, failReason);
-		if (!joinNode) {
-			debug_printf(DEBUG_QUIET, "ERROR: %s (line %d) while attempting to"
-				" add join node\n", failReason.Value(), lineNumber);
-		}
-		// Now connect all parents and children to the join node
-		for (auto it = parents.begin(); it != parents.end(); ++it) {
-			Job *parent = *it;
+		size_t numParents = std::distance(parents.begin(), parents.end());
+		size_t numChildren = std::distance(children.begin(), children.end());
+		int joinNodeNum = ++numJoinNodes;
+		if (numParents * numChildren > numParents + numChildren) {
+			// First create the join node and add it
+			std::string joinNodeName;
+			formatstr(joinNodeName, "%s%d", JOIN_NODE_PREFIX, joinNodeNum);
+			Job* joinNode = AddNode(dag, joinNodeName.c_str(), "", "noop.sub", true,
+				false, NodeType::JOB, failReason);
+			if (!joinNode) {
+				debug_printf(DEBUG_QUIET, "ERROR: %s (line %d) while attempting to"
+					" add join node\n", failReason.Value(), lineNumber);
+				return false;
+			}
+			joinNode->SetJoinNode(true);
+			// Now connect all parents and children to the join node
+			for (auto it = parents.begin(); it != parents.end(); ++it) {
+				Job *parent = *it;
 #ifdef DEAD_CODE
-			if (!dag->AddDependency(parent, joinNode)) {
+				if (!dag->AddDependency(parent, joinNode)) {
 #else
-			std::forward_list<Job*> lst = { joinNode };
-			if (!parent->AddChildren(lst, failReason)) {
+				std::forward_list<Job*> lst = { joinNode };
+				if (!parent->AddChildren(lst, failReason)) {
 #endif
-				debug_printf( DEBUG_QUIET, "ERROR: %s (line %d) failed"
-					" to add dependency between parent"
-					" node \"%s\" and join node \"%s\"\n",
-					filename, lineNumber,
-					parent->GetJobName(), joinNode->GetJobName() );
-				return false;
+					debug_printf( DEBUG_QUIET, "ERROR: %s (line %d) failed"
+						" to add dependency between parent"
+						" node \"%s\" and join node \"%s\"\n",
+						filename, lineNumber,
+						parent->GetJobName(), joinNode->GetJobName() );
+					return false;
+				}
 			}
+			// reset parent list to the join node and fall through to build the child edges
+			parents.clear();
+			parents.push_front(joinNode);
+			parent_type = "join";
 		}
-		// reset parent list to the join node and fall through to build the child edges
-		parents.clear();
-		parents.push_front(joinNode);
-		parent_type = "join";
 	}
 
 	for (auto it = parents.begin(); it != parents.end(); ++it) {
@@ -1434,6 +1564,137 @@ parse_parent(
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// 
+// Function: parse_parent
+// Purpose:  parse a line of the format PARENT node-name+ CHILD node-name+
+//           where there can be one or more parent nodes and one or more
+//           children nodes.  rest is the part of the line after the
+//           PARENT token.
+//
+//-----------------------------------------------------------------------------
+static bool 
+parse_parent(
+	Dag  *dag, 
+	char *rest,
+	const char *filename, 
+	int  lineNumber)
+{
+	ParentStatement stmt;
+	stmt.lineNumber = lineNumber;
+	stmt.line = rest;
+	resolve_parent( dag, stmt );
+	return apply_parent( dag, stmt, filename );
+}
+
+//-----------------------------------------------------------------------------
+// 
+// Function: parse_thread_count
+// Purpose:  return the number of threads to use to look up the nodes named
+//           by PARENT lines, from DAGMAN_PARSE_THREADS.
+//
+//-----------------------------------------------------------------------------
+static int
+parse_thread_count(void)
+{
+#if !defined(WIN32) && defined(HAVE_PTHREADS)
+	int numThreads = param_integer( "DAGMAN_PARSE_THREADS", 0 );
+	if ( numThreads <= 0 ) {
+		int num_cpus = 1;
+		int num_hyperthread_cpus = 1;
+		sysapi_ncpus_raw( &num_cpus, &num_hyperthread_cpus );
+		numThreads = MIN( num_cpus, MAX_AUTO_PARSE_THREADS );
+	}
+	return MAX( numThreads, 1 );
+#else
+	return 1;
+#endif
+}
+
+#if !defined(WIN32) && defined(HAVE_PTHREADS)
+struct ResolveParentsWork {
+	Dag *dag;
+	ParentStatement *begin;
+	ParentStatement *end;
+};
+
+static void *
+resolve_parents_thread( void *arg )
+{
+	ResolveParentsWork *work = (ResolveParentsWork *)arg;
+	for ( ParentStatement *stmt = work->begin; stmt != work->end; ++stmt ) {
+		resolve_parent( work->dag, *stmt );
+	}
+	return NULL;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// 
+// Function: flush_parents
+// Purpose:  look up the nodes for a batch of consecutive PARENT lines,
+//           using up to numThreads threads, then add their dependencies
+//           to the dag in order.  Stops at the first line with an error,
+//           just as parsing the lines one at a time would.  The batch is
+//           empty on return.
+//
+//-----------------------------------------------------------------------------
+static bool
+flush_parents( Dag *dag, std::vector<ParentStatement> &batch,
+			const char *filename, int numThreads )
+{
+	size_t count = batch.size();
+	size_t resolved = 0;
+
+#if !defined(WIN32) && defined(HAVE_PTHREADS)
+	size_t threads = MIN( (size_t)numThreads, count / MIN_PARENTS_PER_THREAD );
+	if ( threads > 1 ) {
+		size_t chunk = (count + threads - 1) / threads;
+		std::vector<ResolveParentsWork> work( threads );
+		std::vector<pthread_t> tids( threads );
+		std::vector<bool> started( threads, false );
+		for ( size_t t = 0; t < threads; t++ ) {
+			size_t first = MIN( count, t * chunk );
+			size_t last = MIN( count, first + chunk );
+			work[t].dag = dag;
+			work[t].begin = batch.data() + first;
+			work[t].end = batch.data() + last;
+				// This thread does the first chunk itself.
+			if ( t > 0 && pthread_create( &tids[t], NULL,
+						resolve_parents_thread, &work[t] ) == 0 ) {
+				started[t] = true;
+			}
+		}
+		resolve_parents_thread( &work[0] );
+		for ( size_t t = 1; t < threads; t++ ) {
+			if ( started[t] ) {
+				pthread_join( tids[t], NULL );
+			} else {
+				resolve_parents_thread( &work[t] );
+			}
+		}
+		resolved = count;
+		debug_printf( DEBUG_VERBOSE, "%s: looked up the nodes of %zu PARENT "
+					"lines with %zu threads\n", filename, count, threads );
+	}
+#endif
+
+	for ( ; resolved < count; resolved++ ) {
+		resolve_parent( dag, batch[resolved] );
+	}
+
+	bool result = true;
+	for ( size_t i = 0; i < count; i++ ) {
+		if ( !apply_parent( dag, batch[i], filename ) ) {
+			result = false;
+			break;
+		}
+	}
+
+	batch.clear();
+	return result;
+}
+
 //-----------------------------------------------------------------------------
 // 
 // Function: parse_retry
@@ -2611,6 +2872,18 @@ parse_done(
 
 	Job *job = dag->FindNodeByName( jobName );
 	if( job == NULL ) {
+			// A rescue DAG written when different PARENT ... CHILD
+			// statements got join nodes may name join nodes that we
+			// didn't create this time; their children carry their own
+			// DONE lines, so these can be ignored.
+		if ( strncmp( jobName, JOIN_NODE_PREFIX,
+					sizeof(JOIN_NODE_PREFIX) - 1 ) == MATCH ) {
+			debug_printf( DEBUG_NORMAL,
+						  "%s (line %d): Ignoring DONE for join node %s, "
+						  "which is not in this DAG\n",
+						  filename, lineNumber, jobNameOrig );
+			return true;
+		}
 		debug_printf( DEBUG_QUIET, 
 					  "Warning: %s (line %d): Unknown Job %s\n",
 					  filename, lineNumber, jobNameOrig );
@@ -2830,7 +3103,7 @@ static MyString munge_job_name(const char *jobName)
 	MyString newName;
 
 	if ( _mungeNames ) {
-		newName = std::to_string(_thisDagNum) + "." + jobName;
+		newName.formatstr( "%d.%s", _thisDagNum, jobName );
 	} else {
 		newName = jobName;
 	}
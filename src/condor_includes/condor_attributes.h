@@ -131,6 +131,8 @@
 #define ATTR_CPU_MODEL_NUMBER  "CpuModelNumber"
 #define ATTR_CPU_FAMILY  "CpuFamily"
 #define ATTR_CPU_CACHE_SIZE  "CpuCacheSize"
+#define ATTR_CPU_PRESSURE  "CpuPressure"
+#define ATTR_CGROUP_MEMORY_KB  "CgroupMemoryKb"
 #define ATTR_CURRENT_HOSTS  "CurrentHosts"
 #define ATTR_CURRENT_JOBS_RUNNING  "CurrentJobsRunning"
 #define ATTR_CURRENT_RANK  "CurrentRank"
@@ -295,6 +297,7 @@
 #define ATTR_IDLE_JOBS  "IdleJobs"
 #define ATTR_IMAGE_SIZE  "ImageSize"
 #define ATTR_IO_WAIT  "IOWait"
+#define ATTR_IO_PRESSURE  "IOPressure"
 #define ATTR_RESIDENT_SET_SIZE  "ResidentSetSize"
 #define ATTR_PROPORTIONAL_SET_SIZE  "ProportionalSetSizeKb"
 #define ATTR_INTERACTIVE  "Interactive"
@@ -490,6 +493,7 @@
 #define ATTR_CURB_MATCHMAKING "CurbMatchmaking"
 #define ATTR_MEMORY  "Memory"
 #define ATTR_MEMORY_USAGE  "MemoryUsage"
+#define ATTR_MEMORY_PRESSURE  "MemoryPressure"
 #define ATTR_DETECTED_MEMORY  "DetectedMemory"
 #define ATTR_DETECTED_CPUS  "DetectedCpus"
 #define ATTR_MIN_HOSTS  "MinHosts"
@@ -697,6 +701,9 @@
 #define ATTR_TOTAL_JOB_RUN_TIME  "TotalJobRunTime"
 #define ATTR_TOTAL_JOB_SUSPEND_TIME  "TotalJobSuspendTime"
 #define ATTR_TOTAL_LOAD_AVG  "TotalLoadAvg"
+#define ATTR_TOTAL_CPU_PRESSURE  "TotalCpuPressure"
+#define ATTR_TOTAL_MEMORY_PRESSURE  "TotalMemoryPressure"
+#define ATTR_TOTAL_IO_PRESSURE  "TotalIOPressure"
 #define ATTR_TOTAL_MEMORY  "TotalMemory"
 #define ATTR_TOTAL_SLOT_MEMORY  "TotalSlotMemory"
 #define ATTR_TOTAL_RUNNING_JOBS  "TotalRunningJobs"
@@ -79,14 +79,14 @@ typedef struct macro_meta {
 	short int    source_line;  // line number for files, param.in entry for internal
 	short int    source_meta_id;   // metaknob id
 	short int    source_meta_off;  // statement offset within metaknob   (i.e. 0 based line number)
-	short int    use_count;
+	int          use_count;    // int rather than short so that hot knobs do not overflow
 	short int    ref_count;
 } MACRO_META;
 typedef struct macro_defaults {
 	int size;
 	MACRO_DEF_ITEM * table; // points to const table[size] key/default-value pairs
 	struct META {
-		short int use_count;
+		int       use_count;
 		short int ref_count;
 	} * metat; // optional, points to metat[size] of use counts parallel to table[]
 } MACRO_DEFAULTS;
@@ -241,6 +241,52 @@ typedef struct macro_eval_context_ex : macro_eval_context {
 	// A convenience function for use with trinary parameters.
 	bool param_false( const char * name );
 
+	// Returns a number that changes each time the config is reloaded, or a param
+	// is changed in-process with param_insert() or set_live_param_value().
+	int param_config_generation();
+
+	// Typed, cached lookups for knobs that are read in frequently called code.
+	// The knob is looked up and converted on the first call to value(), and again
+	// only when the config generation has changed, so a reconfig still takes effect.
+	// The name must outlive the object (a string literal is the usual case).
+	// The intended use is:
+	//   static param_cached_bool advertise_rollup("ADVERTISE_PSLOT_ROLLUP_INFORMATION", true);
+	//   if (advertise_rollup.value()) { ... }
+	//
+	class param_cached_int {
+	public:
+		param_cached_int(const char * name, int def_value = 0, int min_value = INT_MIN, int max_value = INT_MAX)
+			: m_name(name), m_def(def_value), m_min(min_value), m_max(max_value), m_val(def_value), m_gen(-1) {}
+		int value() {
+			if (m_gen != param_config_generation()) {
+				m_val = param_integer(m_name, m_def, m_min, m_max);
+				m_gen = param_config_generation();
+			}
+			return m_val;
+		}
+	private:
+		const char * m_name;
+		int m_def, m_min, m_max, m_val;
+		int m_gen;
+	};
+
+	class param_cached_bool {
+	public:
+		param_cached_bool(const char * name, bool def_value = false)
+			: m_name(name), m_def(def_value), m_val(def_value), m_gen(-1) {}
+		bool value() {
+			if (m_gen != param_config_generation()) {
+				m_val = param_boolean(m_name, m_def);
+				m_gen = param_config_generation();
+			}
+			return m_val;
+		}
+	private:
+		const char * m_name;
+		bool m_def, m_val;
+		int m_gen;
+	};
+
 	const char * param_append_location(const MACRO_META * pmet, MyString & value);
 	const char * param_get_location(const MACRO_META * pmet, MyString & value);
 
@@ -363,6 +409,7 @@ extern "C" {
 	#define CONFIG_OPT_USE_THIS_ROOT_CONFIG 0x800 // use the root config file specified in the last argument of real_config
 	#define CONFIG_OPT_SUBMIT_SYNTAX 0x1000 // allow +Attr and -Attr syntax like submit files do.
 	#define CONFIG_OPT_NO_INCLUDE_FILE 0x2000 // don't allow includes from files (late materialization)
+	#define CONFIG_OPT_CONTEXT_DEPENDENT 0x4000 // set (not read) by the parser when what it read depends on the subsys/localname it was read for
 	bool config();
 	int set_priv_initialize(void); // duplicated here for 8.8.0 to minimize code churn. actual function is in uids.cpp
 	bool config_ex(int opt);
@@ -191,6 +191,19 @@ void _condor_parse_merge_debug_flags(
 
 bool dprintf_to_term_check();
 
+// configure asynchronous logging (DEBUG_ASYNC), this takes effect at the next call to dprintf_set_outputs
+void dprintf_async_config(bool enable, long long buffer_size, int flush_interval_ms);
+
+// when DEBUG_ASYNC is enabled, write all queued messages to the log before returning
+void dprintf_async_flush(void);
+
+// stop the DEBUG_ASYNC writer thread, writing everything it has queued. later messages are
+// written synchronously. this is also done at exit(), but not before exec() or _exit().
+void dprintf_async_shutdown(void);
+
+// number of messages dropped because a DEBUG_ASYNC buffer was full
+long long dprintf_async_dropped(void);
+
 #endif
 void _condor_dprintf_va ( int flags, DPF_IDENT ident, const char* fmt, va_list args );
 int _condor_open_lock_file(const char *filename,int flags, mode_t perm);
@@ -54,6 +54,7 @@ typedef enum
     ENV_DAEMON_DEATHTIME,
 	ENV_PARENT_ID,
 	ENV_PRIVATE,
+	ENV_CONFIG_SNAPSHOT,
 	// ....
 } CONDOR_ENVIRON;
 
@@ -106,6 +107,7 @@ static CONDOR_ENVIRON_ELEM CondorEnvironList[] =
 	{ ENV_DAEMON_DEATHTIME,	"DAEMON_DEATHTIME",     ENV_FLAG_NONE, NULL },
 	{ ENV_PARENT_ID,		"%s_PARENT_ID",			ENV_FLAG_DISTRO_UC, NULL },
 	{ ENV_PRIVATE,			"%s_PRIVATE_INHERIT",	ENV_FLAG_DISTRO_UC, NULL },
+	{ ENV_CONFIG_SNAPSHOT,	"%s_CONFIG_SNAPSHOT",	ENV_FLAG_DISTRO_UC, NULL },
 };
 #endif		// _CONDOR_ENV_MAIN
 
@@ -138,7 +138,7 @@ int SetJobFactory(int cluster_id, int qnum, const char * factory_filename, const
 // spool the materialize item data, getting back the filename of the spooled file and number of items that were sent.
 int SendMaterializeData(int cluster_id, int flags, int (*next)(void* pv, std::string&item), void* pv, MyString & filename, int* pnum_items);
 
-// send a cluster ad or proc ad as a series of SetAttribute calls.
+// send a cluster ad or proc ad with a single SetJobAttributes call.
 // this function does a *shallow* iterate of the given ad, ignoring attributes in the chained parent ad (if any)
 // since the chained parent attributes should be sent only once, and using a different key.
 // To use this function to sent the cluster ad, pass a key with -1 as the proc id, and pass the cluster ad as the ad argument.
@@ -187,6 +187,18 @@ int SetAttributeExprByConstraint(const char *constraint, const char *attr,
 */
 int SetAttribute(int cluster, int proc, const char *attr, const char *value, SetAttributeFlags_t flags=0, CondorError *err=nullptr );
 
+/** Set a list of attr = value pairs for job with specified cluster and proc.
+	The values should be valid ClassAd values, as for SetAttribute.  Against
+	a remote schedd that supports it, this sends the whole list in a single
+	message rather than one message per attribute.  Attributes are set in
+	order, stopping at the first failure.
+	@param failed_index If not NULL, set to the index in attrs of the
+		attribute that failed, or -1 if the failure wasn't in a single
+		attribute (or isn't known, as in NoAck mode).
+	@return -1 on failure; 0 on success
+*/
+int SetJobAttributes(int cluster, int proc, const std::vector<std::pair<std::string, std::string> > & attrs, SetAttributeFlags_t flags=0, int * failed_index=NULL );
+
 /** Set attr = value for job with specified cluster and proc.  The value
 	will be a ClassAd integer literal.
 	@return -1 on failure; 0 on success
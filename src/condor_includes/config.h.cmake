@@ -454,6 +454,9 @@
 /* Define to 1 if you have the <sys/procfs.h> header file. (USED)*/
 #cmakedefine HAVE_SYS_PROCFS_H 1
 
+/* Define to 1 if you have the <zlib.h> header file and libz. (USED)*/
+#cmakedefine HAVE_ZLIB_H 1
+
 /* Define to 1 if you have the 'vasprintf' function. (USED)*/
 #cmakedefine HAVE_VASPRINTF 1
 
@@ -139,6 +139,10 @@ void dprintf_set_outputs(const struct dprintf_output_settings *p_info, int c_inf
 
 void * dprintf_get_onerror_data();
 
+// start and stop the DEBUG_ASYNC writer thread, these are called by dprintf_set_outputs
+void _dprintf_async_start();
+void _dprintf_async_stop();
+
 const char* _format_global_header(int cat_and_flags, int hdr_flags, DebugHeaderInfo & info);
 //Global dprint functions meant as fallbacks.
 void _dprintf_global_func(int cat_and_flags, int hdr_flags, DebugHeaderInfo & info, const char* message, DebugFileInfo* dbgInfo);
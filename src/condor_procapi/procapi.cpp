@@ -38,6 +38,7 @@ HashTable <pid_t, procHashNode *> * ProcAPI::procHash =
     new HashTable <pid_t, procHashNode *> ( pidHashFunc );
 
 piPTR ProcAPI::allProcInfos = NULL;
+bool ProcAPI::parallelReads = false;
 
 // counters for measuring the performance of GetProcInfoList
 //
@@ -168,6 +169,32 @@ ProcAPI::getProcInfo( pid_t pid, piPTR& pi, int &status )
 		return PROCAPI_FAILURE;
 	}
 
+	if( convertProcInfoRaw(procRaw, pi, status) != PROCAPI_SUCCESS ) {
+		return PROCAPI_FAILURE;
+	}
+
+		/* grab out the environment, if possible. I've noticed that
+		   under linux it appears that once the /proc/<pid>/environ
+		   file is made, it never changes. Luckily, we're only looking
+		   for specific stuff the parent only puts into the child's
+		   environment.
+
+		   We don't care if it fails, its optional
+		*/
+	fillProcInfoEnv(pi);
+
+		// success
+	return PROCAPI_SUCCESS;
+}
+
+/* Everything getProcInfo() does with the raw data except for reading
+   the environment.  Unlike reading /proc, this uses static state (the
+   boot time and the usage sampling table), so buildProcInfoListParallel()
+   only calls it from the main thread.
+*/
+int
+ProcAPI::convertProcInfoRaw( const procInfoRaw& procRaw, piPTR pi, int &status )
+{
 		/* clean up and convert the raw data */
 
 		// if the page size has not yet been found, get it.
@@ -244,17 +271,6 @@ ProcAPI::getProcInfo( pid_t pid, piPTR& pi, int &status )
 	do_usage_sampling ( pi, cpu_time, procRaw.majfault, procRaw.minfault );
 		// Note: sanity checking done in above call.
 
-		/* grab out the environment, if possible. I've noticed that
-		   under linux it appears that once the /proc/<pid>/environ
-		   file is made, it never changes. Luckily, we're only looking
-		   for specific stuff the parent only puts into the child's
-		   environment.
-
-		   We don't care if it fails, its optional
-		*/
-	fillProcInfoEnv(pi);
-
-		// success
 	return PROCAPI_SUCCESS;
 }
 
@@ -2082,6 +2098,143 @@ ProcAPI::buildPidList() {
 }
 #endif
 
+#if defined(LINUX)
+
+/* Reading /proc costs a few system calls per process, plus a copy of its
+   environment, so on a machine running thousands of processes a single
+   thread spends most of each procd snapshot waiting on the kernel.  When
+   there are enough processes to make it worthwhile, we spread the reads
+   across several threads.  _CONDOR_PROCAPI_THREADS overrides the number
+   of threads; 1 disables this.  The reader threads may dprintf, so this
+   is only done by processes that call ProcAPI::setParallelReads().
+*/
+static const int PROCAPI_PARALLEL_MIN_PIDS = 1024;
+static const int PROCAPI_MAX_THREADS = 8;
+static const int PROCAPI_PIDS_PER_CHUNK = 64;
+
+static int
+procInfoListThreads( int num_pids )
+{
+	int num_threads = -1;
+	char * threads_str = getenv( "_CONDOR_PROCAPI_THREADS" );
+	if( threads_str ) {
+		char * endptr = NULL;
+		long l = strtol( threads_str, & endptr, 10 );
+		if( endptr != threads_str && *endptr == '\0' ) {
+			num_threads = (int)l;
+		}
+	}
+	if( num_threads < 0 ) {
+		if( num_pids < PROCAPI_PARALLEL_MIN_PIDS ) {
+			return 1;
+		}
+		num_threads = (int)sysconf( _SC_NPROCESSORS_ONLN );
+		if( num_threads > PROCAPI_MAX_THREADS ) {
+			num_threads = PROCAPI_MAX_THREADS;
+		}
+	}
+	// there's no point in a thread with less than a chunk of work
+	int max_useful = (num_pids + PROCAPI_PIDS_PER_CHUNK - 1) / PROCAPI_PIDS_PER_CHUNK;
+	if( num_threads > max_useful ) {
+		num_threads = max_useful;
+	}
+	return num_threads < 1 ? 1 : num_threads;
+}
+
+struct ProcInfoReadJob {
+	const std::vector<pid_t> * pids;
+	std::vector<procInfoRaw> raws;
+	std::vector<piPTR> pis;
+	int next_chunk;
+	int (*read_one)( pid_t, procInfoRaw &, piPTR & );
+};
+
+static void *
+procInfoReadThread( void * arg )
+{
+	ProcInfoReadJob * job = (ProcInfoReadJob *)arg;
+	int num_pids = (int)job->pids->size();
+	while( true ) {
+		int start = __sync_fetch_and_add( & job->next_chunk, PROCAPI_PIDS_PER_CHUNK );
+		if( start >= num_pids ) { break; }
+		int end = start + PROCAPI_PIDS_PER_CHUNK;
+		if( end > num_pids ) { end = num_pids; }
+		for( int i = start; i < end; ++i ) {
+			job->read_one( (*job->pids)[i], job->raws[i], job->pis[i] );
+		}
+	}
+	return NULL;
+}
+
+/* The part of getProcInfo() which only reads /proc, and so is safe to
+   call from several threads at once.  On success, pi holds the pid and
+   environment of the process, and procRaw the rest.
+*/
+int
+ProcAPI::readProcInfoRaw( pid_t pid, procInfoRaw& procRaw, piPTR& pi )
+{
+	int status;
+	if( getProcInfoRaw(pid, procRaw, status) != PROCAPI_SUCCESS ) {
+		pi = NULL;
+		return PROCAPI_FAILURE;
+	}
+	pi = NULL;
+	initpi( pi );
+	pi->pid = procRaw.pid;
+	fillProcInfoEnv( pi );
+	return PROCAPI_SUCCESS;
+}
+
+int
+ProcAPI::buildProcInfoListParallel( int num_threads )
+{
+	ProcInfoReadJob job;
+	job.pids = & pidList;
+	job.raws.resize( pidList.size() );
+	job.pis.assign( pidList.size(), (piPTR)NULL );
+	job.next_chunk = 0;
+	job.read_one = & ProcAPI::readProcInfoRaw;
+
+	std::vector<pthread_t> threads;
+	for( int i = 1; i < num_threads; ++i ) {
+		pthread_t tid;
+		int rc = pthread_create( & tid, NULL, procInfoReadThread, & job );
+		if( rc != 0 ) {
+			dprintf( D_ALWAYS, "ProcAPI: failed to start reader thread: %s (%d)\n",
+				strerror(rc), rc );
+			break;
+		}
+		threads.push_back( tid );
+	}
+	// this thread does its share, too
+	procInfoReadThread( & job );
+	for( size_t i = 0; i < threads.size(); ++i ) {
+		pthread_join( threads[i], NULL );
+	}
+
+	// usage sampling isn't thread-safe, so do it here, in pid order
+	piPTR * tail = & allProcInfos;
+	for( size_t i = 0; i < pidList.size(); ++i ) {
+		piPTR pi = job.pis[i];
+		if( pi == NULL ) { continue; }
+		int status;
+		if( convertProcInfoRaw( job.raws[i], pi, status ) == PROCAPI_SUCCESS ) {
+			*tail = pi;
+			tail = & pi->next;
+		} else {
+			delete pi;
+		}
+	}
+	*tail = NULL;
+
+	dprintf( D_FULLDEBUG, "ProcAPI: read %d processes with %d threads\n",
+		(int)pidList.size(), (int)threads.size() + 1 );
+
+	return PROCAPI_SUCCESS;
+}
+
+#endif
+
 #if !defined(WIN32) && !defined(DARWIN)
 int
 ProcAPI::buildProcInfoList() {
@@ -2097,6 +2250,15 @@ ProcAPI::buildProcInfoList() {
 		return PROCAPI_FAILURE;
 	}
 
+#if defined(LINUX)
+	int num_threads = parallelReads ? procInfoListThreads( (int)pidList.size() ) : 1;
+	if( num_threads > 1 ) {
+		status = buildProcInfoListParallel( num_threads );
+		pidList.clear();
+		return status;
+	}
+#endif
+
 		// make a header node for ease of list construction:
 	allProcInfos = new procInfo;
 	current = allProcInfos;
@@ -436,6 +436,12 @@ class ProcAPI {
   */
   static procInfo* getProcInfoList();
 
+  /* allows getProcInfoList() to read /proc with several threads on Linux.
+     Only processes whose dprintf is thread-safe, such as the procd, should
+     turn this on, since the reader threads log errors.
+  */
+  static void setParallelReads(bool enable) { parallelReads = enable; }
+
   /* used to deallocate the memory for a list of procInfo structures
 
 	@param The list to deallocate
@@ -593,6 +599,13 @@ class ProcAPI {
 	  // updates the statically stored boottime variable if neccessary
 	  // something similar probably belongs in sys_api
   static int checkBootTime(long now);
+	  // converts the raw data into pi and samples its cpu usage;
+	  // everything getProcInfo() does except reading /proc
+  static int convertProcInfoRaw(const procInfoRaw& procRaw, piPTR pi, int &status);
+	  // the thread-safe part of getProcInfo(): reads /proc, but no sampling
+  static int readProcInfoRaw(pid_t pid, procInfoRaw& procRaw, piPTR& pi);
+	  // builds allProcInfos from pidList with several threads reading /proc
+  static int buildProcInfoListParallel(int num_threads);
 #endif //LINUX
 
   // works with the hashtable; finds cpuusage, maj/min page faults.
@@ -612,6 +625,7 @@ class ProcAPI {
   static long secsSinceEpoch();                   // used for wall clock age
   static double convertTimeval ( struct timeval );// convert timeval to double
   static void deallocAllProcInfos();              // respective lists.
+  static bool parallelReads;                      // see setParallelReads()
 
   public:
   static int getProcInfoListStats(double & sOverall, 
@@ -53,6 +53,48 @@ CGroupTracker::remove_mapping(ProcFamily* family)
 	return false;
 }
 
+// Rather than reading /proc/<pid>/cgroup for every process on the
+// machine, read the list of tasks in each cgroup we track, which costs
+// one file per family instead of one per process.  If any of the lists
+// can't be read, fall back to checking each process.
+void
+CGroupTracker::find_processes(procInfo*& pi_list)
+{
+	if (m_cgroup_pool.empty()) {
+		return;
+	}
+
+	std::map<pid_t, ProcFamily*> task_families;
+	std::map<std::string, ProcFamily*>::const_iterator end = m_cgroup_pool.end();
+	for (std::map<std::string, ProcFamily*>::const_iterator it = m_cgroup_pool.begin(); it != end; ++it) {
+		pid_t pid;
+		void *handle = NULL;
+		int err = cgroup_get_task_begin(it->first.c_str(), CPUACCT_CONTROLLER_STR, &handle, &pid);
+		while (err == 0) {
+			task_families[pid] = it->second;
+			err = cgroup_get_task_next(&handle, &pid);
+		}
+		if (handle) {
+			cgroup_get_task_end(&handle);
+		}
+		if (err != ECGEOF) {
+			dprintf(D_ALWAYS,
+				"CGroupTracker: unable to list tasks of cgroup %s: %u %s; "
+				"checking each process instead\n",
+				it->first.c_str(), err, cgroup_strerror(err));
+			ProcFamilyTracker::find_processes(pi_list);
+			return;
+		}
+	}
+
+	for (procInfo* curr = pi_list; curr != NULL; curr = curr->next) {
+		std::map<pid_t, ProcFamily*>::const_iterator found = task_families.find(curr->pid);
+		if (found != task_families.end()) {
+			m_monitor->add_member_to_family(found->second, curr, "CGROUP");
+		}
+	}
+}
+
 bool
 CGroupTracker::check_process(procInfo* pi)
 {
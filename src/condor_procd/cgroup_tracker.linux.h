@@ -33,6 +33,7 @@ public:
 
 	bool add_mapping(ProcFamily* family, const char * cgroup);
 	bool remove_mapping(ProcFamily* family);
+	void find_processes(procInfo*& pi_list);
 	bool check_process(procInfo* pi);
 
 private:
@@ -23,12 +23,18 @@
 
 #if !defined(WIN32)
 #include "syslog.h"
+#include <pthread.h>
 #endif
 
 FILE* debug_fp = NULL;
 char *debug_fn = NULL;
 int log_size = -1;
 
+#if !defined(WIN32)
+// ProcAPI may log from several threads while it reads /proc
+static pthread_mutex_t dprintf_lite_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 extern "C" void preserve_log_file();
 
 static char *formatTimeHeader(struct tm *tm) {
@@ -57,6 +63,9 @@ dprintf(int, const char* format, ...)
 		va_end(ap);
 #endif
 	} else if (debug_fp) {
+#if !defined(WIN32)
+		pthread_mutex_lock(&dprintf_lite_mutex);
+#endif
 		time_t clock_now;
 		(void)time( &clock_now );
 		struct tm *tm = localtime( &clock_now );
@@ -69,7 +78,9 @@ dprintf(int, const char* format, ...)
 		long pos = ftell(debug_fp);
 		if (log_size > 0 && pos > log_size)
 			preserve_log_file(); 
-		
+#if !defined(WIN32)
+		pthread_mutex_unlock(&dprintf_lite_mutex);
+#endif
 	}
 }
 
@@ -461,6 +461,11 @@ main(int argc, char* argv[])
 	}
 #endif
 
+	// our dprintf is thread-safe, so the snapshot can read /proc with
+	// several threads
+	//
+	ProcAPI::setParallelReads(true);
+
 	// initialize the "engine" for tracking process families
 	// If we specified a root pid, that means we don't want to except if it
 	// dies. If we didn't specify a root pid, it means the procd's parent
@@ -64,6 +64,8 @@ JobCluster::~JobCluster()
 void JobCluster::clear()
 {
 	cluster_map.clear();
+	cluster_index.clear();
+	cluster_hash.clear();
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
 	cluster_use.clear();
 	cluster_gone.clear();
@@ -195,7 +197,7 @@ void JobCluster::collect_garbage(bool brute_force) // free the deleted clusters
 		}
 		// advance here so that we can erase the previous entry if needed.
 		JobSigidMap::iterator last = it++;
-		if (gone) { cluster_map.erase(last); }
+		if (gone) { erase_signature(last); }
 	}
 	cluster_gone.clear();
 }
@@ -203,8 +205,243 @@ void JobCluster::collect_garbage(bool brute_force) // free the deleted clusters
 #endif
 
 extern int    last_autocluster_classad_cache_hit;
+extern int    autocluster_hash_collisions;
 
-int JobCluster::getClusterid(JobQueueJob & job, bool expand_refs, std::string * final_list)
+// 64 bit FNV-1a, fed with the parts of a job's significant values as they are walked.
+static inline void hash_bytes(uint64_t & hash, const void * data, size_t len)
+{
+	const unsigned char * p = (const unsigned char *)data;
+	for (size_t ix = 0; ix < len; ++ix) {
+		hash ^= p[ix];
+		hash *= 1099511628211ULL;
+	}
+}
+
+template <class T> static inline void hash_pod(uint64_t & hash, const T & val)
+{
+	hash_bytes(hash, &val, sizeof(val));
+}
+
+static inline void hash_string(uint64_t & hash, const std::string & str)
+{
+	hash_bytes(hash, str.data(), str.size());
+	hash_pod(hash, str.size());
+}
+
+// hash an expression by walking its tree, so that no text is generated.
+// identical trees hash the same, which is all that a lookup needs.
+static void hash_expr(uint64_t & hash, const classad::ExprTree * tree)
+{
+	if ( ! tree) {
+		hash_pod(hash, -1);
+		return;
+	}
+	tree = tree->self(); // skip the envelope of cached expressions
+	classad::ExprTree::NodeKind kind = tree->GetKind();
+	hash_pod(hash, (int)kind);
+	switch (kind) {
+	case classad::ExprTree::LITERAL_NODE: {
+		classad::Value::NumberFactor factor;
+		const classad::Value & val = ((const classad::Literal*)tree)->getValue(factor);
+		hash_pod(hash, (int)val.GetType());
+		hash_pod(hash, (int)factor);
+		long long ival;
+		bool bval;
+		double rval;
+		const char * str;
+		classad::abstime_t atime;
+		if (val.IsIntegerValue(ival)) {
+			hash_pod(hash, ival);
+		} else if (val.IsBooleanValue(bval)) {
+			hash_pod(hash, bval);
+		} else if (val.IsRealValue(rval) || val.IsRelativeTimeValue(rval)) {
+			hash_pod(hash, rval);
+		} else if (val.IsAbsoluteTimeValue(atime)) {
+			hash_pod(hash, atime.secs);
+			hash_pod(hash, atime.offset);
+		} else if (val.IsStringValue(str)) {
+			hash_bytes(hash, str, strlen(str));
+		}
+	} break;
+
+	case classad::ExprTree::ATTRREF_NODE: {
+		classad::ExprTree * expr = NULL;
+		std::string attr;
+		bool absolute = false;
+		((const classad::AttributeReference*)tree)->GetComponents(expr, attr, absolute);
+		hash_pod(hash, absolute);
+		hash_string(hash, attr);
+		hash_expr(hash, expr);
+	} break;
+
+	case classad::ExprTree::OP_NODE: {
+		classad::Operation::OpKind op;
+		classad::ExprTree *t1 = NULL, *t2 = NULL, *t3 = NULL;
+		((const classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+		hash_pod(hash, (int)op);
+		hash_expr(hash, t1);
+		hash_expr(hash, t2);
+		hash_expr(hash, t3);
+	} break;
+
+	case classad::ExprTree::FN_CALL_NODE: {
+		std::string name;
+		std::vector<classad::ExprTree*> args;
+		((const classad::FunctionCall*)tree)->GetComponents(name, args);
+		hash_string(hash, name);
+		for (size_t ix = 0; ix < args.size(); ++ix) { hash_expr(hash, args[ix]); }
+		hash_pod(hash, args.size());
+	} break;
+
+	case classad::ExprTree::CLASSAD_NODE: {
+		std::vector< std::pair<std::string, classad::ExprTree*> > attrs;
+		((const classad::ClassAd*)tree)->GetComponents(attrs);
+		for (size_t ix = 0; ix < attrs.size(); ++ix) {
+			hash_string(hash, attrs[ix].first);
+			hash_expr(hash, attrs[ix].second);
+		}
+		hash_pod(hash, attrs.size());
+	} break;
+
+	case classad::ExprTree::EXPR_LIST_NODE: {
+		std::vector<classad::ExprTree*> items;
+		((const classad::ExprList*)tree)->GetComponents(items);
+		for (size_t ix = 0; ix < items.size(); ++ix) { hash_expr(hash, items[ix]); }
+		hash_pod(hash, items.size());
+	} break;
+
+	default:
+		break;
+	}
+}
+
+// hash the names and values that make up a job's signature, in signature order,
+// without printing them.  this is what cluster_index is keyed on.
+size_t JobCluster::hash_values(const std::vector<ExprTree*> & sigset, const classad::References & exattrs)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	StringTokenIterator list(significant_attrs);
+	const std::string * attr;
+	size_t ix = 0;
+	while ((attr = list.next_string())) {
+		hash_string(hash, *attr);
+		hash_expr(hash, sigset[ix++]);
+	}
+	for (classad::References::const_iterator it = exattrs.begin(); it != exattrs.end(); ++it) {
+		hash_string(hash, *it);
+		hash_expr(hash, sigset[ix++]);
+	}
+	return (size_t)hash;
+}
+
+// print a job's signature "key1 = val1\nkey2 = val2\n" from its significant values.
+// the order of the keys is the order of significant_attrs followed by the expanded attrs.
+void JobCluster::make_signature(std::string & signature, const std::vector<ExprTree*> & sigset, const classad::References & exattrs)
+{
+	signature.clear();
+	signature.reserve(strlen(significant_attrs) + exattrs.size()*20 + sigset.size()*20); // make a guess as to how much space the signature will take.
+
+	classad::ClassAdUnParser unp;
+	unp.SetOldClassAd( true, true );
+
+	StringTokenIterator list(significant_attrs);
+	const std::string * attr;
+	size_t ix = 0;
+	while ((attr = list.next_string())) {
+		ExprTree * tree = sigset[ix++];
+		signature += *attr;
+		signature += " = ";
+		if (tree) { unp.Unparse(signature, tree); }
+		signature += '\n';
+	}
+	for (classad::References::const_iterator it = exattrs.begin(); it != exattrs.end(); ++it) {
+		ExprTree * tree = sigset[ix++];
+		signature += *it;
+		signature += " = ";
+		if (tree) { unp.Unparse(signature, tree); }
+		signature += '\n';
+	}
+}
+
+// returns true if job was put into its autocluster with the given hash, and its
+// significant values are the same as the ones in sigset.
+bool JobCluster::same_values(JobQueueJob & job, size_t hash, const std::vector<ExprTree*> & sigset, const classad::References & exattrs)
+{
+	if (job.autocluster_hash != hash) {
+		return false;
+	}
+	StringTokenIterator list(significant_attrs);
+	const std::string * attr;
+	size_t ix = 0;
+	while ((attr = list.next_string())) {
+		ExprTree * tree = job.Lookup(*attr);
+		ExprTree * sig = sigset[ix++];
+		if (tree != sig && ( ! tree || ! sig || ! sig->SameAs(tree))) {
+			return false;
+		}
+	}
+	for (classad::References::const_iterator it = exattrs.begin(); it != exattrs.end(); ++it) {
+		ExprTree * tree = job.Lookup(*it);
+		ExprTree * sig = sigset[ix++];
+		if (tree != sig && ( ! tree || ! sig || ! sig->SameAs(tree))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// lookup a job's significant values in the cluster_map via the hash index.  different
+// values can have the same hash, so each candidate must be checked.  When we keep the
+// ids of the jobs in each autocluster, a candidate is checked by comparing the values
+// with those of a job already in it; only when that is not possible (or fails) is the
+// job's signature printed and compared with the candidate's signature.
+JobCluster::JobSigidMap::iterator JobCluster::find_signature(JobQueueJob & job, size_t hash, const std::vector<ExprTree*> & sigset, const classad::References & exattrs)
+{
+	bool have_sig = false;
+	std::pair<JobSigHashIndex::iterator, JobSigHashIndex::iterator> range = cluster_index.equal_range(hash);
+	for (JobSigHashIndex::iterator it = range.first; it != range.second; ++it) {
+	#ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
+		if (keep_job_ids) {
+			JobIdSetMap::iterator jit = cluster_use.find(it->second->second);
+			JOB_ID_KEY jid;
+			if (jit != cluster_use.end() && jit->second.first(jid)) {
+				JobQueueJob * other = GetJobAd(jid);
+				if (other && other != &job && same_values(*other, hash, sigset, exattrs)) {
+					return it->second;
+				}
+			}
+		}
+	#endif
+		if ( ! have_sig) {
+			make_signature(sig_buf, sigset, exattrs);
+			have_sig = true;
+		}
+		if (it->second->first == sig_buf) {
+			return it->second;
+		}
+		++autocluster_hash_collisions;
+	}
+	return cluster_map.end();
+}
+
+// remove an entry from the cluster_map and from the hash index
+void JobCluster::erase_signature(JobSigidMap::iterator it)
+{
+	std::map<int, size_t>::iterator hit = cluster_hash.find(it->second);
+	if (hit != cluster_hash.end()) {
+		std::pair<JobSigHashIndex::iterator, JobSigHashIndex::iterator> range = cluster_index.equal_range(hit->second);
+		for (JobSigHashIndex::iterator iit = range.first; iit != range.second; ++iit) {
+			if (iit->second == it) {
+				cluster_index.erase(iit);
+				break;
+			}
+		}
+		cluster_hash.erase(hit);
+	}
+	cluster_map.erase(it);
+}
+
+int JobCluster::getClusterid(JobQueueJob & job, bool expand_refs, std::string * final_list, size_t * hash)
 {
 	int cur_id = -1;
 
@@ -253,57 +490,42 @@ int JobCluster::getClusterid(JobQueueJob & job, bool expand_refs, std::string *
 
 	// sigset now contains the values of all the attributes we need,
 	// significant attibutes are first, followed by expanded attributes
-	// we build a signature essentially by printing it all out in one big string
-	//
-	bool need_sep = false; // true after the first item, (when we need to print separators)
-	std::string signature;
-	signature.reserve(strlen(significant_attrs) + exattrs.size()*20 + sigset.size()*20); // make a guess as to how much space the signature will take.
-
-	classad::ClassAdUnParser unp;
-	unp.SetOldClassAd( true, true );
-
-	// first put the pre-defined significant attrs in the sig
-	list.rewind();
-	int ix = 0;
-	while ((attr = list.next_string())) {
-		ExprTree * tree = sigset[ix];
-		signature += *attr;
-		signature += " = ";
-		if (tree) { unp.Unparse(signature, tree); }
-		signature += '\n';
-		if (final_list) {
+	if (final_list) {
+		bool need_sep = false; // true after the first item, (when we need to print separators)
+		list.rewind();
+		while ((attr = list.next_string())) {
 			if (need_sep) { (*final_list) += ','; }
 			final_list->append(*attr);
 			need_sep = true;
 		}
-		++ix;
-	}
-
-	// now put out the expanded attribs (if any)
-	for (classad::References::iterator it = exattrs.begin(); it != exattrs.end(); ++it) {
-		ExprTree * tree = sigset[ix];
-		signature += *it;
-		signature += " = ";
-		if (tree) { unp.Unparse(signature, tree); }
-		signature += '\n';
-		if (final_list) {
+		for (classad::References::iterator it = exattrs.begin(); it != exattrs.end(); ++it) {
 			if (need_sep) { (*final_list) += ','; }
 			final_list->append(*it);
 			need_sep = true;
 		}
-		++ix;
 	}
 
-	// now check the signature against the current cluster map
+	// now check the values against the current cluster map
 	// and either return the matching cluster id, or a new cluster id.
-	JobSigidMap::iterator it;
-	it = cluster_map.find(signature);
+	// the signature string is only printed when a hash matches, or for a new cluster.
+	size_t sig_hash = hash_values(sigset, exattrs);
+	if (hash) { *hash = sig_hash; }
+	JobSigidMap::iterator it = find_signature(job, sig_hash, sigset, exattrs);
 	if (it != cluster_map.end()) {
 		cur_id = it->second;
 	}
 	else {
-		cur_id = next_id++;
-		cluster_map.insert(JobSigidMap::value_type(signature,cur_id));
+		make_signature(sig_buf, sigset, exattrs);
+		std::pair<JobSigidMap::iterator, bool> ins = cluster_map.insert(JobSigidMap::value_type(sig_buf, next_id));
+		if (ins.second) {
+			cur_id = next_id++;
+			cluster_index.insert(JobSigHashIndex::value_type(sig_hash, ins.first));
+			cluster_hash[cur_id] = sig_hash;
+		} else {
+			// the values print the same as those of an existing cluster, but do not
+			// hash the same (a real that differs past the printed precision for instance).
+			cur_id = ins.first->second;
+		}
 	}
 
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
@@ -549,7 +771,7 @@ void AutoCluster::sweep()
 		if (in_use == cluster_in_use.end()) {
 				// found an entry to remove.
 			dprintf(D_FULLDEBUG,"removing auto cluster id %d\n",id);
-			cluster_map.erase( it );
+			erase_signature( it );
 		}
 	}
 }
@@ -585,7 +807,8 @@ int AutoCluster::getAutoClusterid(JobQueueJob *job)
 
 	last_autocluster_make_sig = true;
 
-	cur_id = this->getClusterid(*job, true, &final_list);
+	size_t hash = 0;
+	cur_id = this->getClusterid(*job, true, &final_list, &hash);
 	if( cur_id < 0 ) {
 			// We've wrapped around MAX_INT!
 			// In config() we take steps to avoid this unlikely condition.
@@ -598,6 +821,7 @@ int AutoCluster::getAutoClusterid(JobQueueJob *job)
 		// put the new auto cluster id into the job ad to cache it.
 	job->Assign(ATTR_AUTO_CLUSTER_ID,cur_id);
 	job->autocluster_id = cur_id;
+	job->autocluster_hash = hash;
 
 		// for some nice feedback, place the final list of attrs used to create this
 		// signature into the job ad.
@@ -651,6 +875,7 @@ void AutoCluster::removeFromAutocluster(JobQueueJob &job)
 		job.Delete(ATTR_AUTO_CLUSTER_ID);
 		job.Delete(ATTR_AUTO_CLUSTER_ATTRS);
 		job.autocluster_id = -1;
+		job.autocluster_hash = 0;
 	}
 }
 
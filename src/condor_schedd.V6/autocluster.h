@@ -26,6 +26,7 @@
 
 #include "condor_classad.h"
 #include <generic_stats.h>
+#include <unordered_map>
 
 class JobIdSet;
 class JobAggregationResults;
@@ -40,7 +41,7 @@ public:
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
 	void keepJobIds(bool keep) { keep_job_ids = keep; }
 #endif
-	int getClusterid(JobQueueJob &job, bool expand_refs, std::string * final_list);
+	int getClusterid(JobQueueJob &job, bool expand_refs, std::string * final_list, size_t * hash=NULL);
 	int size();
 	void clear();
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
@@ -52,6 +53,15 @@ protected:
 	friend class JobAggregationResults;
 	typedef std::map<std::string,int> JobSigidMap;
 	JobSigidMap cluster_map;  // map of signature to a cluster id
+	typedef std::unordered_multimap<size_t, JobSigidMap::iterator> JobSigHashIndex;
+	JobSigHashIndex cluster_index; // map of signature hash to its entry in cluster_map
+	std::map<int, size_t> cluster_hash; // map of cluster id to the hash it is indexed under
+	std::string sig_buf; // reused by getClusterid so that building a signature does not allocate
+	size_t hash_values(const std::vector<classad::ExprTree*> & sigset, const classad::References & exattrs);
+	void make_signature(std::string & signature, const std::vector<classad::ExprTree*> & sigset, const classad::References & exattrs);
+	bool same_values(JobQueueJob & job, size_t hash, const std::vector<classad::ExprTree*> & sigset, const classad::References & exattrs);
+	JobSigidMap::iterator find_signature(JobQueueJob & job, size_t hash, const std::vector<classad::ExprTree*> & sigset, const classad::References & exattrs);
+	void erase_signature(JobSigidMap::iterator it);
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
 	typedef std::map<int, JobIdSet> JobIdSetMap;
 	JobIdSetMap cluster_use; // map clusterId to a set of jobIds
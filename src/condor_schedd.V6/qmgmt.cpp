@@ -211,6 +211,18 @@ int			N_PrioRecs = 0;
 HashTable<int,int> *PrioRecAutoClusterRejected = NULL;
 int BuildPrioRecArrayTid = -1;
 
+// The indexes into PrioRec of each submitter's records, in priority order.
+// This is rebuilt along with the PrioRec array so that FindRunnableJob and
+// negotiation look only at the records of the submitter they care about.
+// first_live is the position of the first record that FindRunnableJob has
+// not yet disabled, so that repeated claim reuse doesn't rescan them.
+struct PrioRecSubmitterIndex {
+	std::vector<int> recs;
+	size_t first_live;
+	PrioRecSubmitterIndex() : first_live(0) {}
+};
+static std::map<std::string, PrioRecSubmitterIndex> PrioRecBySubmitter;
+
 static int 	MAX_PRIO_REC=INITIAL_MAX_PRIO_REC ;	// INITIAL_MAX_* in prio_rec.h
 
 JOB_ID_KEY_BUF HeaderKey(0,0);
@@ -483,6 +495,7 @@ int GetSchedulerCapabilities(int /*mask*/, ClassAd & reply)
 {
 	reply.Assign( "LateMaterialize", scheduler.getAllowLateMaterialize() );
 	reply.Assign("LateMaterializeVersion", 2);
+	reply.Assign("SetJobAttributes", true);
 	dprintf(D_ALWAYS, "GetSchedulerCapabilities called, returning\n");
 	dPrintAd(D_ALWAYS, reply);
 	return 0;
@@ -4808,6 +4821,21 @@ SetAttribute(int cluster_id, int proc_id, const char *attr_name,
 	return 0;
 }
 
+int
+SetJobAttributes(int cluster_id, int proc_id,
+				 const std::vector<std::pair<std::string, std::string> > & attrs,
+				 SetAttributeFlags_t flags, int * failed_index)
+{
+	if (failed_index) { *failed_index = -1; }
+	for (size_t ix = 0; ix < attrs.size(); ++ix) {
+		if (SetAttribute(cluster_id, proc_id, attrs[ix].first.c_str(), attrs[ix].second.c_str(), flags) < 0) {
+			if (failed_index) { *failed_index = (int)ix; }
+			return -1;
+		}
+	}
+	return 0;
+}
+
 
 // For now this just updates counters for idle/running/held jobs
 // but in the future it could dispatch various callbacks based on the flags in triggers.
@@ -7567,7 +7595,9 @@ double last_autocluster_runtime;
 bool   last_autocluster_make_sig;
 int    last_autocluster_type=0;
 int    last_autocluster_classad_cache_hit=0;
+int    autocluster_hash_collisions=0;
 stats_entry_abs<int> SCGetAutoClusterType;
+stats_entry_abs<int> SCGetAutoClusterHashCollisions;
 
 // Returns cur_hosts so that another function in the scheduler can
 // update JobsRunning and keep the scheduler and queue manager
@@ -7616,6 +7646,7 @@ int get_job_prio(JobQueueJob *job, const JOB_ID_KEY & jid, void *)
 	else { GetAutoCluster_hit_runtime += last_autocluster_runtime; }
 	SCGetAutoClusterType = last_autocluster_type;
 	GetAutoCluster_cchit_runtime += last_autocluster_classad_cache_hit;
+	SCGetAutoClusterHashCollisions = autocluster_hash_collisions;
 
 	job->LookupInteger(ATTR_JOB_UNIVERSE, universe);
 	ASSERT(universe == job->Universe());
@@ -8092,9 +8123,18 @@ static void DoBuildPrioRecArray() {
 		// array, since that's not that expensive, and we need it for
 		// all the flocking logic at the end of this function.
 		// Discovered by Derek Wright and insure-- on 2/28/01
+	PrioRecBySubmitter.clear();
 	if( N_PrioRecs ) {
 		qsort( (char *)PrioRec, N_PrioRecs, sizeof(PrioRec[0]),
 			   (int(*)(const void*, const void*))prio_compar );
+
+		PrioRecSubmitterIndex * last = NULL;
+		for (int i = 0; i < N_PrioRecs; i++) {
+			if ( ! last || strcmp(PrioRec[i].submitter, PrioRec[last->recs.back()].submitter) != 0) {
+				last = &PrioRecBySubmitter[PrioRec[i].submitter];
+			}
+			last->recs.push_back(i);
+		}
 		BuildPrioRec_sort_runtime += rt.tick(now);
 	}
 
@@ -8106,6 +8146,19 @@ static void DoBuildPrioRecArray() {
 	}
 }
 
+/*
+ * Get the indexes into the PrioRec array of the records for the given
+ * submitter, in priority order.  Returns NULL if there are none.
+ */
+const std::vector<int> * GetPrioRecsForSubmitter(const char * submitter)
+{
+	auto found = PrioRecBySubmitter.find(submitter);
+	if (found == PrioRecBySubmitter.end()) {
+		return NULL;
+	}
+	return &found->second.recs;
+}
+
 /*
  * Force a rebuild of the PrioRec array if we're beyond the max interval
  * for a rebuild.
@@ -8269,16 +8322,31 @@ void FindRunnableJob(PROC_ID & jobid, ClassAd* my_match_ad,
 		// jobs, nicely pre-sorted in priority order.
 
 	do {
-		for (i=0; i < N_PrioRecs; i++) {
+			// When we want a job for a specific user, only look at that
+			// user's records, skipping the ones we have already disabled.
+		PrioRecSubmitterIndex * user_recs = NULL;
+		size_t ix = 0;
+		size_t num_recs = N_PrioRecs;
+		if ( !match_any_user ) {
+			auto found = PrioRecBySubmitter.find(user);
+			if (found == PrioRecBySubmitter.end()) {
+				num_recs = 0;
+			} else {
+				user_recs = &found->second;
+				ix = user_recs->first_live;
+				num_recs = user_recs->recs.size();
+			}
+		}
+
+		for ( ; ix < num_recs; ix++) {
+			i = user_recs ? user_recs->recs[ix] : (int)ix;
 
 			if ( PrioRec[i].submitter[0] == '\0' ) {
 					// This record has been disabled, because it is no longer
 					// runnable.
-				continue;
-			}
-
-			if ( !match_any_user && strcmp(PrioRec[i].submitter, user) != 0 ) {
-					// Owner doesn't match.
+				if (user_recs && ix == user_recs->first_live) {
+					user_recs->first_live++;
+				}
 				continue;
 			}
 
@@ -8304,6 +8372,9 @@ void FindRunnableJob(PROC_ID & jobid, ClassAd* my_match_ad,
 					// Prevent this job from being considered in any
 					// future iterations through the list.
 				PrioRec[i].submitter[0] = '\0';
+				if (user_recs && ix == user_recs->first_live) {
+					user_recs->first_live++;
+				}
 				dprintf(D_FULLDEBUG,
 						"record for job %d.%d skipped until PrioRec rebuild (%s)\n",
 						PrioRec[i].id.cluster, PrioRec[i].id.proc, isRunnable ? "already matched" : "no longer runnable");
@@ -186,6 +186,7 @@ public:
 	int dirty_flags;	// one or more of JQJ_CHACHE_DIRTY_ flags indicating that the job ad differs from the JobQueueJob 
 	int set_id;
 	int autocluster_id;
+	size_t autocluster_hash; // hash of the significant values that put the job in autocluster_id
 	// cached pointer into schedulers's SubmitterDataMap and OwnerInfoMap
 	// it is set by count_jobs() or by scheduler::get_submitter_and_owner()
 	// DO NOT FREE FROM HERE!
@@ -205,6 +206,7 @@ public:
 		, dirty_flags(0)
 		, set_id(0)
 		, autocluster_id(0)
+		, autocluster_hash(0)
 		, submitterdata(NULL)
 		, ownerinfo(NULL)
 		, parent(NULL)
@@ -583,6 +585,7 @@ extern prio_rec *PrioRec;
 extern int N_PrioRecs;
 extern HashTable<int,int> *PrioRecAutoClusterRejected;
 extern int grow_prio_recs(int);
+extern const std::vector<int> * GetPrioRecsForSubmitter(const char * submitter);
 
 extern void	FindRunnableJob(PROC_ID & jobid, ClassAd* my_match_ad, char const * user);
 extern int Runnable(PROC_ID*);
@@ -171,7 +171,7 @@ static int IsForcedProcAttribute(const char *attr)
 	return 0;
 }
 
-// send a cluster ad or proc ad as a series of SetAttribute calls.
+// send a cluster ad or proc ad with a single SetJobAttributes call.
 // this function does a *shallow* iterate of the given ad, ignoring attributes in the chained parent ad (if any)
 // since the chained parent attributes should be sent only once, and using a different key.
 // To use this function to sent the cluster ad, pass a key with -1 as the proc id, and pass the cluster ad as the ad argument.
@@ -180,33 +180,19 @@ int SendJobAttributes(const JOB_ID_KEY & key, const classad::ClassAd & ad, SetAt
 {
 	classad::ClassAdUnParser unparser;
 	unparser.SetOldClassAd( true, true );
-	std::string rhs; rhs.reserve(120);
 
 	if ( !  who) who = "Qmgmt";
 
-	int retval = 0;
 	bool is_cluster = key.proc < 0;
 
-	// first try and send the cluster id or proc id
+	std::vector<std::pair<std::string, std::string> > attrs;
+	attrs.reserve(ad.size() + 2);
+
+	// first the cluster id or proc id
 	if (is_cluster) {
-		if (SetAttributeInt (key.cluster, -1, ATTR_CLUSTER_ID, key.cluster, saflags) == -1) {
-			if (errstack) {
-				errstack->pushf(who, SCHEDD_ERR_SET_ATTRIBUTE_FAILED,
-					"failed to set " ATTR_CLUSTER_ID "=%d (%d)",
-					key.cluster, errno);
-			}
-			return -1;
-		}
+		attrs.push_back(std::make_pair(std::string(ATTR_CLUSTER_ID), std::to_string(key.cluster)));
 	} else {
-		if (SetAttributeInt (key.cluster, key.proc, ATTR_PROC_ID, key.proc, saflags) == -1) {
-			if (errstack) {
-				errstack->pushf(who, SCHEDD_ERR_SET_ATTRIBUTE_FAILED,
-					"job %d.%d failed to set " ATTR_PROC_ID "=%d (%d)",
-					key.cluster, key.proc,
-					key.proc, errno);
-			}
-			return -1;
-		}
+		attrs.push_back(std::make_pair(std::string(ATTR_PROC_ID), std::to_string(key.proc)));
 
 		// For now, we make sure to set the JobStatus attribute in the proc ad, note that we may actually be
 		// fetching this from a chained parent ad.  this is the ONLY attribute that we want to pick up
@@ -215,28 +201,20 @@ int SendJobAttributes(const JOB_ID_KEY & key, const classad::ClassAd & ad, SetAt
 		// and per-owner totals by state doesn't work if this attribute is missing in the proc ads.
 		int status = IDLE;
 		if ( ! ad.EvaluateAttrInt(ATTR_JOB_STATUS, status)) { status = IDLE; }
-		if (SetAttributeInt (key.cluster, key.proc, ATTR_JOB_STATUS, status, saflags) == -1) {
-			if (errstack) {
-				errstack->pushf(who, SCHEDD_ERR_SET_ATTRIBUTE_FAILED,
-					"job %d.%d failed to set " ATTR_JOB_STATUS "=%d (%d)",
-					key.cluster, key.proc,
-					status, errno);
-			}
-			return -1;
-		}
+		attrs.push_back(std::make_pair(std::string(ATTR_JOB_STATUS), std::to_string(status)));
 	}
 
-	// (shallow) iterate the attributes in this ad and send them to the schedd
+	// (shallow) iterate the attributes in this ad
 	//
 	for (auto it = ad.begin(); it != ad.end(); ++it) {
 		const char * attr = it->first.c_str();
 
-		// skip attributes that are forced into the other sort of ad, or have already been sent.
+		// skip attributes that are forced into the other sort of ad, or have already been added.
 		int forced = IsForcedProcAttribute(attr);
 		if (forced) {
-			// skip attributes not forced into the cluster ad and not already sent
+			// skip attributes not forced into the cluster ad and not already added
 			if (is_cluster && (forced != -1)) continue;
-			// skip attributes not forced into the proc ad and not already sent
+			// skip attributes not forced into the proc ad and not already added
 			if ( ! is_cluster && (forced != 1)) continue;
 		}
 
@@ -245,23 +223,29 @@ int SendJobAttributes(const JOB_ID_KEY & key, const classad::ClassAd & ad, SetAt
 				errstack->pushf(who, SCHEDD_ERR_SET_ATTRIBUTE_FAILED,
 					"job %d.%d ERROR: %s=NULL", key.cluster, key.proc, attr);
 			}
-			retval = -1;
-			break;
+			return -1;
 		}
-		rhs.clear();
-		unparser.Unparse(rhs, it->second);
+		attrs.push_back(std::make_pair(it->first, std::string()));
+		unparser.Unparse(attrs.back().second, it->second);
+	}
 
-		if (SetAttribute(key.cluster, key.proc, attr, rhs.c_str(), saflags) == -1) {
-			if (errstack) {
+	// and send them to the schedd all at once
+	int failed_index = -1;
+	if (SetJobAttributes(key.cluster, key.proc, attrs, saflags, &failed_index) == -1) {
+		if (errstack) {
+			if (failed_index >= 0 && failed_index < (int)attrs.size()) {
 				errstack->pushf(who, SCHEDD_ERR_SET_ATTRIBUTE_FAILED,
-					"job %d.%d failed to set %s=%s (%d)", key.cluster, key.proc, attr, rhs.c_str(), errno);
+					"job %d.%d failed to set %s=%s (%d)", key.cluster, key.proc,
+					attrs[failed_index].first.c_str(), attrs[failed_index].second.c_str(), errno);
+			} else {
+				errstack->pushf(who, SCHEDD_ERR_SET_ATTRIBUTE_FAILED,
+					"job %d.%d failed to set attributes (%d)", key.cluster, key.proc, errno);
 			}
-			retval = -1;
-			break;
 		}
+		return -1;
 	}
 
-	return retval;
+	return 0;
 }
 
 
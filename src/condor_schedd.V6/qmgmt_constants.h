@@ -56,3 +56,9 @@
 #define CONDOR_SetJobFactory        10037 /* tj */
 #define CONDOR_SetMaterializeData   10038 /* tj - abandoned */
 #define CONDOR_SendMaterializeData  10039 /* tj */
+#define CONDOR_SetJobAttributes     10040
+
+// The most attributes a single CONDOR_SetJobAttributes message may carry.
+// The schedd drops the connection on a larger count; the client sends
+// larger ads one attribute at a time instead.
+#define SET_JOB_ATTRIBUTES_MAX      20000
@@ -462,6 +462,98 @@ do_Q_request(QmgmtPeer &Q_PEER, bool &may_fork)
 		return 0;
 	}
 
+	case CONDOR_SetJobAttributes:
+	  {
+		int cluster_id = -1;
+		int proc_id = -1;
+		int num_attrs = 0;
+		int failed_index = -1;
+		int terrno = 0;
+		SetAttributeFlags_t flags = 0;
+		SetAttributePublicFlags_t wflags = 0;
+		std::vector<std::pair<std::string, std::string> > attrs;
+
+		assert( syscall_sock->code(cluster_id) );
+		dprintf( D_SYSCALLS, "	cluster_id = %d\n", cluster_id );
+		assert( syscall_sock->code(proc_id) );
+		dprintf( D_SYSCALLS, "	proc_id = %d\n", proc_id );
+		assert( syscall_sock->code(wflags) );
+		flags = (SetAttributeFlags_t)(wflags & SetAttribute_PublicFlagsMask);
+		assert( syscall_sock->code(num_attrs) );
+		dprintf( D_SYSCALLS, "	num_attrs = %d\n", num_attrs );
+			// The count comes from the client, so don't trust it to size
+			// anything; refuse the request (and drop the connection) if it
+			// is out of range.
+		if (num_attrs < 0 || num_attrs > SET_JOB_ATTRIBUTES_MAX) {
+			dprintf( D_ALWAYS, "SetJobAttributes: refusing request from %s "
+					 "with %d attributes (limit is %d)\n",
+					 syscall_sock->peer_description(), num_attrs,
+					 SET_JOB_ATTRIBUTES_MAX );
+			return -1;
+		}
+		attrs.reserve(num_attrs);
+		for (int ix = 0; ix < num_attrs; ++ix) {
+			attrs.emplace_back();
+			assert( syscall_sock->code(attrs.back().first) );
+			assert( syscall_sock->code(attrs.back().second) );
+		}
+		assert( syscall_sock->end_of_message() );;
+
+			// As with SetAttribute_NoAck, ignore the whole batch after the
+			// first error, since the transaction will fail at commit anyway.
+		if (g_transaction_error && !g_transaction_error->empty() &&
+			(flags & SetAttribute_NoAck))
+		{
+			dprintf( D_SYSCALLS, "\tIgnored due to previous error\n");
+			return 0;
+		}
+
+		rval = 0;
+		for (auto it = attrs.begin(); it != attrs.end(); ++it) {
+			const char * attr_name = it->first.c_str();
+			const char * attr_value = it->second.c_str();
+			dprintf(D_SYSCALLS, "\t%s = %s\n", attr_name, attr_value);
+
+			errno = 0;
+			if (strcmp(attr_name, ATTR_MYPROXY_PASSWORD) == 0) {
+				dprintf( D_SYSCALLS, "Got MyProxyPassword, stashing...\n");
+				rval = SetMyProxyPassword (cluster_id, proc_id, attr_value);
+			} else {
+				rval = SetAttribute( cluster_id, proc_id, attr_name, attr_value, flags, g_transaction_error.get() );
+				if( ( IsDebugCategory( D_AUDIT ) ) &&
+				    ( cluster_id != active_cluster_num ) &&
+				    ( rval == 0 ) &&
+				    ( ( strcmp(syscall_sock->getOwner(), get_condor_username()) &&
+				        strcmp(syscall_sock->getFullyQualifiedUser(), CONDOR_CHILD_FQU) ) ||
+				      ( flags & SHOULDLOG ) ) ) {
+
+					dprintf( D_AUDIT, *syscall_sock,
+							 "Set Attribute for job %d.%d, "
+							 "%s = %s\n",
+							 cluster_id, proc_id, attr_name, attr_value);
+				}
+			}
+			terrno = errno;
+			if (rval < 0) {
+				dprintf( D_SYSCALLS, "\trval = %d, errno = %d\n", rval, terrno );
+				failed_index = (int)(it - attrs.begin());
+				break;
+			}
+		}
+
+			// Failures in NoAck mode are deferred until we try to commit.
+		if( ! (flags & SetAttribute_NoAck) ) {
+			syscall_sock->encode();
+			assert( syscall_sock->code(rval) );
+			if( rval < 0 ) {
+				assert( syscall_sock->code(terrno) );
+				assert( syscall_sock->code(failed_index) );
+			}
+			assert( syscall_sock->end_of_message() );
+		}
+		return 0;
+	}
+
 	case CONDOR_SetJobFactory:
 	case CONDOR_SetMaterializeData:
 	{
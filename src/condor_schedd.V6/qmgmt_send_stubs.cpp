@@ -33,6 +33,7 @@
 
 static int CurrentSysCall;
 extern ReliSock *qmgmt_sock;
+extern int qmgmt_can_set_job_attributes;
 int terrno;
 
 int
@@ -255,6 +256,11 @@ bool GetScheddCapabilites(int mask, ClassAd & ad)
 	if ( ! getClassAd(qmgmt_sock, ad) ) {
 		return false;
 	}
+	if (qmgmt_can_set_job_attributes < 0) {
+		bool can_set = false;
+		ad.LookupBool("SetJobAttributes", can_set);
+		qmgmt_can_set_job_attributes = can_set ? 1 : 0;
+	}
 	return qmgmt_sock->end_of_message() != 0;
 }
 
@@ -449,6 +455,70 @@ SetAttribute( int cluster_id, int proc_id, char const *attr_name, char const *at
 	return rval;
 }
 
+int
+SetJobAttributes( int cluster_id, int proc_id, const std::vector<std::pair<std::string, std::string> > & attrs, SetAttributeFlags_t flags_in, int * failed_index )
+{
+	int	rval = 0;
+
+	if (failed_index) { *failed_index = -1; }
+
+	if (qmgmt_can_set_job_attributes < 0) {
+		ClassAd caps;
+		if ( ! GetScheddCapabilites(0, caps)) {
+			errno = ETIMEDOUT;
+			return -1;
+		}
+	}
+
+	// the schedd can't take the whole list at once, so send them one at a time.
+	if ( ! qmgmt_can_set_job_attributes || attrs.size() > SET_JOB_ATTRIBUTES_MAX) {
+		for (size_t ix = 0; ix < attrs.size(); ++ix) {
+			if (SetAttribute(cluster_id, proc_id, attrs[ix].first.c_str(), attrs[ix].second.c_str(), flags_in) < 0) {
+				if (failed_index) { *failed_index = (int)ix; }
+				return -1;
+			}
+		}
+		return 0;
+	}
+
+	SetAttributePublicFlags_t flags = (flags_in & SetAttribute_PublicFlagsMask);
+	int num_attrs = (int)attrs.size();
+
+		CurrentSysCall = CONDOR_SetJobAttributes;
+
+		qmgmt_sock->encode();
+		neg_on_error( qmgmt_sock->code(CurrentSysCall) );
+		neg_on_error( qmgmt_sock->code(cluster_id) );
+		neg_on_error( qmgmt_sock->code(proc_id) );
+		neg_on_error( qmgmt_sock->code(flags) );
+		neg_on_error( qmgmt_sock->code(num_attrs) );
+		for (auto it = attrs.begin(); it != attrs.end(); ++it) {
+			neg_on_error( qmgmt_sock->put(it->first) );
+			neg_on_error( qmgmt_sock->put(it->second) );
+		}
+		neg_on_error( qmgmt_sock->end_of_message() );
+
+		if( flags & SetAttribute_NoAck ) {
+			rval = 0;
+		}
+		else {
+			qmgmt_sock->decode();
+			neg_on_error( qmgmt_sock->code(rval) );
+			if( rval < 0 ) {
+				int failed = -1;
+				neg_on_error( qmgmt_sock->code(terrno) );
+				neg_on_error( qmgmt_sock->code(failed) );
+				neg_on_error( qmgmt_sock->end_of_message() );
+				if (failed_index) { *failed_index = failed; }
+				errno = terrno;
+				return rval;
+			}
+			neg_on_error( qmgmt_sock->end_of_message() );
+		}
+
+	return rval;
+}
+
 int
 SetTimerAttribute( int cluster_id, int proc_id, char const *attr_name, int duration )
 {
@@ -47,7 +47,9 @@ QmgrJobUpdater::QmgrJobUpdater( ClassAd* job, const char* schedd_address,
 	schedd_addr(schedd_address?strdup(schedd_address):0),
 	schedd_ver(schedd_version?strdup(schedd_version):0),
 	cluster(-1), proc(-1),
-	q_update_tid(-1) 
+	q_update_tid(-1),
+	m_last_update(0),
+	m_next_update(0)
 {
 	if( ! is_valid_sinful(schedd_address) ) {
 		EXCEPT( "schedd_addr not specified with valid address (%s)",
@@ -171,6 +173,10 @@ QmgrJobUpdater::initJobQueueAttrLists( void )
 	common_job_queue_attrs->insert( ATTR_JOB_TRANSFERRING_OUTPUT_TIME );
 	common_job_queue_attrs->insert( ATTR_NUM_JOB_COMPLETIONS );
 	common_job_queue_attrs->insert( ATTR_IO_WAIT);
+	common_job_queue_attrs->insert( ATTR_CGROUP_MEMORY_KB );
+	common_job_queue_attrs->insert( ATTR_CPU_PRESSURE );
+	common_job_queue_attrs->insert( ATTR_MEMORY_PRESSURE );
+	common_job_queue_attrs->insert( ATTR_IO_PRESSURE );
 
 	// FIXME: What I'd actually like is a way to queue all attributes
 	// not in any whitelist for delivery with the last update.
@@ -250,6 +256,7 @@ QmgrJobUpdater::startUpdateTimer( void )
     if( q_update_tid < 0 ) {
         EXCEPT( "Can't register DC timer!" );
     }
+	m_next_update = time(NULL) + q_interval;
 	dprintf( D_FULLDEBUG, "QmgrJobUpdater: started timer to update queue "
 			 "every %d seconds (tid=%d)\n", q_interval, q_update_tid );
 }
@@ -263,7 +270,27 @@ QmgrJobUpdater::resetUpdateTimer( void )
 	}
 
 	int q_interval = param_integer( "SHADOW_QUEUE_UPDATE_INTERVAL", 15*60 );
-	daemonCore->Reset_Timer( q_update_tid, 0, q_interval );
+	int min_interval = param_integer( "SHADOW_QUEUE_UPDATE_MIN_INTERVAL", 15, 0 );
+
+		// The shadow asks for an update "soon" on every file transfer
+		// state change and when the job starts its output phase.
+		// Rather than opening a new qmgmt connection and transaction
+		// for each one, push at most one update per min_interval;
+		// anything that becomes dirty in the meantime goes out with
+		// that update.  Job state changes don't come through here.
+	time_t now = time(NULL);
+	int delay = 0;
+	if( m_last_update + min_interval > now ) {
+		delay = (int)(m_last_update + min_interval - now);
+	}
+	if( m_next_update <= now + delay ) {
+			// an update is already scheduled at least that soon
+		return;
+	}
+	daemonCore->Reset_Timer( q_update_tid, delay, q_interval );
+	m_next_update = now + delay;
+	dprintf( D_FULLDEBUG, "QmgrJobUpdater: queue update scheduled in %d "
+			 "seconds\n", delay );
 }
 
 
@@ -428,6 +455,9 @@ QmgrJobUpdater::updateJob( update_t type, SetAttributeFlags_t commit_flags )
 				had_error = true;
 			}
 		}
+		if( !had_error ) {
+			m_last_update = time(NULL);
+		}
 		DisconnectQ(NULL,false);
 	} 
 	if( had_error ) {
@@ -480,6 +510,9 @@ QmgrJobUpdater::retrieveJobUpdates( void )
 void
 QmgrJobUpdater::periodicUpdateQ( void )
 {
+	int q_interval = param_integer( "SHADOW_QUEUE_UPDATE_INTERVAL", 15*60 );
+	m_next_update = time(NULL) + q_interval;
+
 		// For performance, use a NONDURABLE transaction.
 	updateJob( U_PERIODIC, NONDURABLE );
 }
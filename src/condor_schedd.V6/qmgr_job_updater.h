@@ -48,13 +48,15 @@ class QmgrJobUpdater : public Service
 {
 public:
 	QmgrJobUpdater( ClassAd* job_a, const char*schedd_address, char const *schedd_version);
-	QmgrJobUpdater( ) :  common_job_queue_attrs(0),  hold_job_queue_attrs(0), evict_job_queue_attrs(0), remove_job_queue_attrs(0), requeue_job_queue_attrs(0), terminate_job_queue_attrs(0), checkpoint_job_queue_attrs(0), x509_job_queue_attrs(0), m_pull_attrs(0), job_ad(0), schedd_addr(0), schedd_ver(0), cluster(-1), proc(-1), q_update_tid(-1) {}
+	QmgrJobUpdater( ) :  common_job_queue_attrs(0),  hold_job_queue_attrs(0), evict_job_queue_attrs(0), remove_job_queue_attrs(0), requeue_job_queue_attrs(0), terminate_job_queue_attrs(0), checkpoint_job_queue_attrs(0), x509_job_queue_attrs(0), m_pull_attrs(0), job_ad(0), schedd_addr(0), schedd_ver(0), cluster(-1), proc(-1), q_update_tid(-1), m_last_update(0), m_next_update(0) {}
 	virtual ~QmgrJobUpdater();
 
 	virtual void startUpdateTimer( void );
 
 		/** Reset the timer for periodic updates to the schedd to fire
-			immediately.
+			immediately, or as soon as SHADOW_QUEUE_UPDATE_MIN_INTERVAL
+			allows.  Requests made while an update is already pending
+			are folded into that update.
 		 */
 	virtual void resetUpdateTimer( void );
 
@@ -149,6 +151,11 @@ private:
 	int proc;
 
 	int q_update_tid;
+
+		/// When we last committed an update to the job queue
+	time_t m_last_update;
+		/// When the update timer is next due to fire
+	time_t m_next_update;
 };	
 
 // usefull if you don't want to update the job queue
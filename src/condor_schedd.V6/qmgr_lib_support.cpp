@@ -29,12 +29,18 @@
 #include "daemon.h"
 #include "my_hostname.h"
 #include "my_username.h"
+#include "condor_config.h"
+#include "condor_ver_info.h"
 
 ReliSock *qmgmt_sock = NULL;
 static Qmgr_connection connection;
 
+// does the schedd we are connected to handle CONDOR_SetJobAttributes?
+// 1 = yes, 0 = no, -1 = don't know yet, ask for its capabilities.
+int qmgmt_can_set_job_attributes = -1;
+
 Qmgr_connection *
-ConnectQ(const char *qmgr_location, int timeout, bool read_only, CondorError* errstack, const char *effective_owner, const char* /*schedd_version_str*/ )
+ConnectQ(const char *qmgr_location, int timeout, bool read_only, CondorError* errstack, const char *effective_owner, const char* schedd_version_str )
 {
 	int		rval, ok;
 	int cmd = read_only ? QMGMT_READ_CMD : QMGMT_WRITE_CMD;
@@ -171,6 +177,24 @@ ConnectQ(const char *qmgr_location, int timeout, bool read_only, CondorError* er
 		}
 	}
 
+		// Schedds before 8.9.12 don't handle CONDOR_SetJobAttributes, and
+		// the oldest ones don't handle CONDOR_GetCapabilities either, so
+		// rule those out by version.  Some 8.9.12 schedds predate the
+		// command, so for 8.9.12 and later the SetJobAttributes
+		// capability decides; it is asked for on first use.
+	qmgmt_can_set_job_attributes = -1;
+	if ( ! schedd_version_str || ! *schedd_version_str) {
+		schedd_version_str = d.version();
+	}
+	if ( ! param_boolean("SUBMIT_BULK_SET_ATTRIBUTES", true)) {
+		qmgmt_can_set_job_attributes = 0;
+	} else if (schedd_version_str && *schedd_version_str) {
+		CondorVersionInfo cvi(schedd_version_str);
+		if ( ! cvi.built_since_version(8,9,12)) {
+			qmgmt_can_set_job_attributes = 0;
+		}
+	}
+
 	return &connection;
 }
 
@@ -2472,12 +2472,14 @@ int Scheduler::command_query_job_ads(int cmd, Stream* stream)
 
 	classad::ExprTree *requirements_in = queryAd.Lookup(ATTR_REQUIREMENTS);
 	classad::ExprTree *requirements = my_jobs_expr;
+	bool trivial_requirements = true; // true when the only constraint is (at most) the only-my-jobs clause
 	if (requirements_in) {
 		bool bval = false;
 		requirements_in = SkipExprParens(requirements_in);
 		if (IsDebugCatAndVerbosity(dpf_level)) {
 			dprintf(dpf_level, "QUERY_JOB_ADS %d formal requirements without excess parens: %s\n", was_my_jobs, ExprTreeToString(requirements_in));
 		}
+		trivial_requirements = ExprTreeIsLiteralBool(requirements_in, bval) && bval;
 		if ( ! requirements) {
 			requirements = requirements_in->Copy();
 		} else if ( ! ExprTreeIsLiteralBool(requirements_in, bval) || bval) {
@@ -2507,7 +2509,8 @@ int Scheduler::command_query_job_ads(int cmd, Stream* stream)
 		iter_options |= JOB_QUEUE_ITERATOR_OPT_INCLUDE_CLUSTERS;
 	}
 
-	QueryJobAdsContinuation *continuation = new QueryJobAdsContinuation(requirements_ptr, resultLimit, 1000, iter_options);
+	int timeslice_ms = param_integer("SCHEDD_QUERY_TIMESLICE", 100, 1);
+	QueryJobAdsContinuation *continuation = new QueryJobAdsContinuation(requirements_ptr, resultLimit, timeslice_ms, iter_options);
 	int proj_err = mergeProjectionFromQueryAd(queryAd, ATTR_PROJECTION, continuation->projection, true);
 	if (proj_err < 0) {
 		delete continuation;
@@ -2526,8 +2529,29 @@ int Scheduler::command_query_job_ads(int cmd, Stream* stream)
 	bool summary_only = false;
 	if (queryAd.EvaluateAttrBoolEquiv("SummaryOnly", summary_only) && summary_only) {
 		continuation->summary_only = true;
+
+		// A totals-only query of all jobs, or of only my jobs, is answered
+		// by the live job counters, without forking or looking at any jobs.
+		LiveJobCounters * live = NULL;
+		if (trivial_requirements && ! include_cluster) {
+			if (my_jobs_name.empty()) {
+				live = &liveJobCounts;
+			} else {
+				OwnerInfo * ownerinfo = find_ownerinfo(my_jobs_name.c_str());
+				if (ownerinfo) { live = &ownerinfo->live; }
+			}
+		}
+		if (live) {
+			dprintf(dpf_level, "QUERY_JOB_ADS %d answering summary query from live job counters\n", was_my_jobs);
+			continuation->query_job_counts = *live;
+			continuation->it = GetJobQueueIteratorEnd();
+			return continuation->finish(stream);
+		}
 	}
 
+	// When we don't fork, the continuation walks the job queue in timeslices
+	// of SCHEDD_QUERY_TIMESLICE milliseconds, going back to DaemonCore in between,
+	// and waits for the socket to be writable whenever the client falls behind.
 	ForkStatus fork_status = schedd_forker.NewJob();
 	if (fork_status == FORK_PARENT)
 	{ // Successfully forked a child - as far as the schedd cares, this worked.
@@ -2756,6 +2780,7 @@ clear_autocluster_id(JobQueueJob *job, const JOB_ID_KEY & /*jid*/, void *)
 {
 	job->Delete(ATTR_AUTO_CLUSTER_ID);
 	job->autocluster_id = -1;
+	job->autocluster_hash = 0;
 	return 0;
 }
 
@@ -3941,18 +3966,94 @@ For all of the jobs in the queue, evaluate the
 periodic user policy expressions.
 */
 
+
+// State of a pass over the job queue that evaluates periodic expressions
+// a slice at a time, going back to DaemonCore in between slices.
+struct PeriodicExprSweep {
+	classad_shared_ptr<classad::ExprTree> requirements;
+	JobQueueLogType::filter_iterator it;
+	UserPolicy policy;
+	double busy_time;	// time spent evaluating, not counting the time between slices
+	int num_jobs;
+	int num_slices;
+
+	PeriodicExprSweep(classad::ExprTree * req, int slice_ms)
+		: requirements(req)
+		, it(GetJobQueueIterator(*req, slice_ms))
+		, busy_time(0)
+		, num_jobs(0)
+		, num_slices(0)
+	{
+#ifdef USE_NON_MUTATING_USERPOLICY
+		policy.Init();
+#endif
+	}
+};
+static PeriodicExprSweep * periodic_expr_sweep = NULL;
+
 void
 Scheduler::PeriodicExprHandler( void )
 {
-	PeriodicExprInterval.setStartTimeNow();
+	int slice_ms = param_integer("PERIODIC_EXPR_YIELD_INTERVAL", 100, 0);
+	if ( ! slice_ms && ! periodic_expr_sweep) {
+		PeriodicExprInterval.setStartTimeNow();
 
-	UserPolicy policy;
+		UserPolicy policy;
 #ifdef USE_NON_MUTATING_USERPOLICY
-	policy.Init();
+		policy.Init();
 #endif
-	WalkJobQueue2(PeriodicExprEval, &policy);
+		WalkJobQueue2(PeriodicExprEval, &policy);
 
-	PeriodicExprInterval.setFinishTimeNow();
+		PeriodicExprInterval.setFinishTimeNow();
+	} else {
+		struct timeval start, finish;
+		condor_gettimestamp(start);
+
+		if ( ! periodic_expr_sweep) {
+			classad::Value val; val.SetBooleanValue(true);
+			periodic_expr_sweep = new PeriodicExprSweep(classad::Literal::MakeLiteral(val), slice_ms);
+		}
+		PeriodicExprSweep & sweep = *periodic_expr_sweep;
+		sweep.num_slices++;
+
+		// check the clock every few jobs, and stop when the slice is used up
+		JobQueueLogType::filter_iterator end = GetJobQueueIteratorEnd();
+		double slice_end = _condor_debug_get_time_double() + slice_ms / 1000.0;
+		int count = 0;
+		while (sweep.it != end) {
+			JobQueueJob * job = *sweep.it++;
+			if (job) {
+				sweep.num_jobs++;
+				PeriodicExprEval(job, job->jid, &sweep.policy);
+			}
+			if (slice_ms && (++count % 64) == 0 && _condor_debug_get_time_double() > slice_end) {
+				break;
+			}
+		}
+
+		condor_gettimestamp(finish);
+		sweep.busy_time += timersub_double(finish, start);
+
+		if (sweep.it != end) {
+				// come back for the next slice once pending events are handled.
+			daemonCore->Reset_Timer( periodicid, 0 );
+			return;
+		}
+
+			// account only for the time we were busy, so the time between
+			// slices doesn't stretch the interval to the next pass.
+		double busy = sweep.busy_time;
+		start = finish;
+		start.tv_sec -= (long)busy;
+		start.tv_usec -= (long)((busy - (long)busy) * 1000000);
+		if (start.tv_usec < 0) { start.tv_sec--; start.tv_usec += 1000000; }
+		PeriodicExprInterval.processEvent(start, finish);
+
+		dprintf(D_FULLDEBUG, "Evaluated periodic expressions for %d jobs in %d slices\n",
+				sweep.num_jobs, sweep.num_slices);
+		delete periodic_expr_sweep;
+		periodic_expr_sweep = NULL;
+	}
 
 	unsigned int time_to_next_run = PeriodicExprInterval.getTimeToNextRun();
 	dprintf(D_FULLDEBUG,"Evaluated periodic expressions in %.3fs, "
@@ -7502,11 +7603,15 @@ Scheduler::negotiate(int command, Stream* s)
 	int next_cluster = 0;
 	int skipped_auto_cluster = -1;
 
-	for(job_index = 0; job_index < N_PrioRecs && !skip_negotiation; job_index++) {
-		prio_rec *prec = &PrioRec[job_index];
+	// only look at the records of the submitter the negotiator wants
+	const std::vector<int> * owner_recs = skip_negotiation ? NULL : GetPrioRecsForSubmitter(owner);
+	jobs = owner_recs ? (int)owner_recs->size() : 0;
+
+	for(job_index = 0; owner_recs && job_index < (int)owner_recs->size(); job_index++) {
+		prio_rec *prec = &PrioRec[(*owner_recs)[job_index]];
 
-		// make sure owner matches what negotiator wants
-		if (strcmp(owner, prec->submitter) != 0)
+		// skip records that FindRunnableJob has disabled
+		if (prec->submitter[0] == '\0')
 		{
 			jobs--;
 			continue;
@@ -12849,6 +12954,7 @@ Scheduler::Init()
     stats.Reconfig();
 
 	if (first_time_in_init) {
+		daemonCore->Register_Metrics_Pool("", &stats.Pool);
 		if (param_boolean("USE_JOBSETS", false)) {
 			ASSERT(jobSets == nullptr);
 			jobSets = new JobSets();
@@ -228,6 +228,8 @@ void ScheddStatistics::InitMain()
    SCHEDD_STATS_ADD_EXTERN_RUNTIME(Pool, GetAutoCluster_cchit,     IF_VERBOSEPUB);
    extern stats_entry_abs<int> SCGetAutoClusterType;
    SCHEDD_STATS_ADD_VAL(Pool, SCGetAutoClusterType, IF_VERBOSEPUB);
+   extern stats_entry_abs<int> SCGetAutoClusterHashCollisions;
+   SCHEDD_STATS_ADD_VAL(Pool, SCGetAutoClusterHashCollisions, IF_VERBOSEPUB);
 
    //SCHEDD_STATS_PUB_DEBUG(Pool, JobsSubmitted,  IF_BASICPUB);
 }
@@ -34,7 +34,6 @@
 
 
 extern ReliSock *syscall_sock;
-extern BaseShadow *Shadow;
 extern RemoteResource *thisRemoteResource;
 
 
@@ -192,20 +191,21 @@ do_REMOTE_syscall()
            return -1;
        }
 
-		if( Shadow->supportsReconnect() ) {
+		BaseShadow *shadow = thisRemoteResource->getShadow();
+		if( shadow->supportsReconnect() ) {
 				// instead of having to EXCEPT, we can now try to
 				// reconnect.  happy day! :)
 			dprintf( D_ALWAYS, "%s\n", err_msg.Value() );
 
-			Shadow->resourceDisconnected(thisRemoteResource);
+			shadow->resourceDisconnected(thisRemoteResource);
 
-			if (!Shadow->shouldAttemptReconnect(thisRemoteResource)) {
+			if (!shadow->shouldAttemptReconnect(thisRemoteResource)) {
 					dprintf(D_ALWAYS, "This job cannot reconnect to starter, so job exiting\n");
-					Shadow->gracefulShutDown();
+					shadow->gracefulShutDown();
 					EXCEPT( "%s", err_msg.Value() );
 			}
 				// tell the shadow to start trying to reconnect
-			Shadow->reconnect();
+			shadow->reconnect();
 				// we need to return 0 so that our caller doesn't
 				// think the job exited and doesn't do anything to the
 				// syscall socket.
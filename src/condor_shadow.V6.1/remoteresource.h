@@ -102,6 +102,9 @@ class RemoteResource : public Service {
 		/// Destructor
 	virtual ~RemoteResource();
 
+		/// The shadow this resource belongs to
+	BaseShadow* getShadow( void ) const { return shadow; }
+
 		/** This function connects to the executing host and does
 			an ACTIVATE_CLAIM command on it.  The ClaimId, starternum
 			and Job ClassAd are pushed, and the executing host's 
@@ -31,6 +31,11 @@
 #include "dc_schedd.h"
 #include "spool_version.h"
 #include "file_transfer.h"
+#include "../condor_procapi/procapi.h"
+
+#if defined(LINUX) && defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 BaseShadow *Shadow = NULL;
 
@@ -44,6 +49,7 @@ static int proc = -1;
 static const char * xfer_queue_contact_info = NULL;
 bool sendUpdatesToSchedd = true;
 static time_t shadow_worklife_expires = 0;
+static int trim_memory_tid = -1;
 
 static void
 usage( int argc, char* argv[] )
@@ -264,6 +270,52 @@ initShadow( ClassAd* ad )
 }
 
 
+#if defined(LINUX) && defined(__GLIBC__)
+static unsigned long
+shadowResidentSizeKB()
+{
+	piPTR info = NULL;
+	int status = 0;
+	unsigned long rss = 0;
+	if( ProcAPI::getProcInfo( getpid(), info, status ) == PROCAPI_SUCCESS && info ) {
+		rss = info->rssize;
+	}
+	delete info;
+	return rss;
+}
+#endif
+
+// Once the job is running, the shadow mostly sits idle, but its heap
+// still holds the free space left over from reading the config and
+// setting up the job.  Since there is a shadow for every running job,
+// hand that space back to the kernel.
+static void
+trimShadowMemory()
+{
+	trim_memory_tid = -1;
+#if defined(LINUX) && defined(__GLIBC__)
+	unsigned long before = shadowResidentSizeKB();
+	malloc_trim(0);
+	dprintf( D_ALWAYS, "Trimmed heap memory: resident size went from %lu KiB to %lu KiB\n",
+			 before, shadowResidentSizeKB() );
+#endif
+}
+
+static void
+scheduleMemoryTrim()
+{
+	if( trim_memory_tid != -1 ) {
+		daemonCore->Cancel_Timer( trim_memory_tid );
+		trim_memory_tid = -1;
+	}
+	int delay = param_integer( "SHADOW_MEMORY_TRIM_DELAY", 60, 0 );
+	if( delay > 0 ) {
+		trim_memory_tid = daemonCore->Register_Timer( delay,
+				trimShadowMemory, "trimShadowMemory" );
+	}
+}
+
+
 void startShadow( ClassAd *ad )
 {
 		// see if the SchedD punched a DAEMON-level authorization
@@ -320,6 +372,8 @@ void startShadow( ClassAd *ad )
 			Shadow->spawn();
 		}
 	}		
+
+	scheduleMemoryTrim();
 }
 
 
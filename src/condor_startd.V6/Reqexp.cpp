@@ -191,6 +191,20 @@ Reqexp::config( ) // formerly compute(A_STATIC)
 				m_within_resource_limits_expr = strdup(wrlimit.c_str());
 			}
 		}
+
+			// Don't carve more jobs out of a partitionable slot while the
+			// machine's jobs are already stalling on memory or i/o; they
+			// would only slow down further.
+		double max_pressure = param_double("STARTD_PSLOT_MAX_PRESSURE", 0, 0, 100);
+		if (max_pressure > 0 && m_rip->is_partitionable_slot()) {
+			std::string wrlimit;
+			formatstr(wrlimit, "(%s) && (MY.%s is UNDEFINED || MY.%s <= %g) && (MY.%s is UNDEFINED || MY.%s <= %g)",
+				m_within_resource_limits_expr,
+				ATTR_TOTAL_MEMORY_PRESSURE, ATTR_TOTAL_MEMORY_PRESSURE, max_pressure,
+				ATTR_TOTAL_IO_PRESSURE, ATTR_TOTAL_IO_PRESSURE, max_pressure);
+			free(m_within_resource_limits_expr);
+			m_within_resource_limits_expr = strdup(wrlimit.c_str());
+		}
 		dprintf(D_FULLDEBUG, "%s = %s\n", ATTR_WITHIN_RESOURCE_LIMITS, m_within_resource_limits_expr);
 	}
 }
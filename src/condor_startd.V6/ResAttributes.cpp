@@ -32,6 +32,10 @@
 #include "winreg.windows.h"
 #endif
 
+#if defined(LINUX)
+#include "cgroup_v2.linux.h"
+#endif
+
 MachAttributes::MachAttributes()
    : m_user_specified(NULL, ";"), m_user_settings_init(false), m_named_chroot()
 {
@@ -61,6 +65,9 @@ MachAttributes::MachAttributes()
 	m_idle = 0;
 	m_load = -1.0;
 	m_owner_load = -1.0;
+	m_cpu_pressure = -1.0;
+	m_memory_pressure = -1.0;
+	m_io_pressure = -1.0;
 	m_virt_mem = 0;
 
 		// Number of CPUs.  Since this is used heavily by the ResMgr
@@ -472,6 +479,16 @@ MachAttributes::compute_for_policy()
 	{ // formerly IS_TIMEOUT(how_much) && IS_SHARED(how_much)
 		m_load = sysapi_load_avg();
 
+#if defined(LINUX)
+		PressureStall cpu, memory, io;
+		read_pressure_stall("/proc/pressure/cpu", cpu);
+		read_pressure_stall("/proc/pressure/memory", memory);
+		read_pressure_stall("/proc/pressure/io", io);
+		m_cpu_pressure = cpu.some_avg10;
+		m_memory_pressure = memory.some_avg10;
+		m_io_pressure = io.some_avg10;
+#endif
+
 		sysapi_idle_time( &m_idle, &m_console_idle );
 
 		time_t my_timer;
@@ -1063,8 +1080,6 @@ MachAttributes::publish_static(ClassAd* cp)
 		if (pav) pav->AssignToClassAd(cp);
 	}
 
-	if (m_local_credd) { cp->Assign(ATTR_LOCAL_CREDD, m_local_credd); }
-
 #else
 	// temporary attributes for raw utsname info
 	cp->Assign( ATTR_UTSNAME_SYSNAME, m_utsname_sysname );
@@ -1213,9 +1228,21 @@ MachAttributes::publish_dynamic( ClassAd* cp)
 	cp->Assign( ATTR_LAST_BENCHMARK, m_last_benchmark );
 	cp->Assign( ATTR_TOTAL_LOAD_AVG, rint(m_load * 100) / 100.0);
 	cp->Assign( ATTR_TOTAL_CONDOR_LOAD_AVG, rint(m_condor_load * 100) / 100.0);
+	if (m_cpu_pressure >= 0) { cp->Assign( ATTR_TOTAL_CPU_PRESSURE, m_cpu_pressure ); }
+	if (m_memory_pressure >= 0) { cp->Assign( ATTR_TOTAL_MEMORY_PRESSURE, m_memory_pressure ); }
+	if (m_io_pressure >= 0) { cp->Assign( ATTR_TOTAL_IO_PRESSURE, m_io_pressure ); }
 	cp->Assign( ATTR_CLOCK_MIN, m_clock_min );
 	cp->Assign( ATTR_CLOCK_DAY, m_clock_day );
 
+#if defined(WIN32)
+	// credd_test() can add or remove this at any time
+	if (m_local_credd) {
+		cp->Assign(ATTR_LOCAL_CREDD, m_local_credd);
+	} else {
+		cp->Delete(ATTR_LOCAL_CREDD);
+	}
+#endif
+
 	m_lst_dynamic.Rewind();
 	while (AttribValue *pav = m_lst_dynamic.Next() ) {
 		if (pav) pav->AssignToClassAd(cp);
@@ -261,6 +261,10 @@ private:
 	float			m_load;
 	float			m_condor_load;
 	float			m_owner_load;
+		// machine-wide pressure stall percentages, negative if unknown
+	double			m_cpu_pressure;
+	double			m_memory_pressure;
+	double			m_io_pressure;
 	long long		m_virt_mem;
 	time_t			m_idle;
 	time_t			m_console_idle;
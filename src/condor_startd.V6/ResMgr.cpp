@@ -156,6 +156,9 @@ double ResMgr::Stats::EndWalk(VoidResourceMember memberfunc, double before)
 ResMgr::~ResMgr()
 {
 	int i;
+	if( daemonCore ) {
+		daemonCore->Cancel_Metrics_Pool(&startd_stats.pool);
+	}
 	if( extras_classad ) delete extras_classad;
 	if( config_classad ) delete config_classad;
 	if( totals_classad ) delete totals_classad;
@@ -447,6 +450,7 @@ ResMgr::init_resources( void )
 	CpuAttributes** new_cpu_attrs;
 
     stats.Init();
+	daemonCore->Register_Metrics_Pool("", &startd_stats.pool);
 
     m_attr->init_machine_resources();
 
@@ -1769,6 +1773,8 @@ ResMgr::addResource( Resource *rip )
 					free(ripT->r_pair_name);
 					rip->r_pair_name = strdup(ripT->r_name);
 					ripT->r_pair_name = strdup(rip->r_name);
+					rip->invalidate_static_ad();
+					ripT->invalidate_static_ad();
 					break;
 				}
 			}
@@ -241,6 +241,7 @@ Resource::Resource( CpuAttributes* cap, int rid, bool multiple_slots, Resource*
 	prevLHF = 0;
 	r_config_classad = NULL;
 	r_classad = NULL;
+	r_static_ad = NULL;
 	r_state = new ResState( this );
 	r_pre = NULL;
 	r_pre_pre = NULL;
@@ -399,6 +400,7 @@ Resource::~Resource()
 		delete r_classad; r_classad = NULL;
 	}
 	delete r_config_classad; r_config_classad = NULL;
+	delete r_static_ad; r_static_ad = NULL;
 	delete r_cod_mgr; r_cod_mgr = NULL;
 	delete r_reqexp; r_reqexp = NULL;
 	delete r_attr; r_attr = NULL;
@@ -1240,6 +1242,7 @@ Resource::init_classad( void )
 		delete r_config_classad;
 	}
 	r_config_classad = new ClassAd( *resmgr->config_classad );
+	invalidate_static_ad();
 
 	// make an ephemeral ad that we will occasionally discard
 	// this catches all state updates
@@ -1427,7 +1430,8 @@ Resource::process_update_ad(ClassAd & public_ad, int snapshot) // change the upd
 			}
 			if(! StartdCronJobParams::attributeIsSumMetric( name ) ) { continue; }
 			if(! StartdCronJobParams::getResourceNameFromAttributeName( name, resourceName )) { continue; }
-			if(! param_boolean( "ADVERTISE_CMR_UPTIME_SECONDS", false )) {
+			static param_cached_bool advertise_cmr_uptime("ADVERTISE_CMR_UPTIME_SECONDS", false);
+			if(! advertise_cmr_uptime.value()) {
 			    deleteList.push_back( name );
 			}
 
@@ -1556,7 +1560,25 @@ void Resource::publish_single_slot_ad(ClassAd & ad, time_t cur_time, Purpose pur
 {
 	ASSERT(&ad != r_classad && &ad != r_config_classad);
 
-	publish_static(&ad);
+	// publish_static only depends on the configuration, so build it once
+	// and copy it into each ad rather than looking up and parsing
+	// STARTD_ATTRS and friends for every slot on every update.  Rebuild it
+	// if our address has changed, since daemonCore->publish puts that in.
+	const char * my_addr = daemonCore->publicNetworkIpAddr();
+	if (r_static_ad && my_addr) {
+		std::string cached_addr;
+		if ( ! r_static_ad->LookupString(ATTR_MY_ADDRESS, cached_addr) || cached_addr != my_addr) {
+			invalidate_static_ad();
+		}
+	}
+	if ( ! r_static_ad) {
+		r_static_ad = new ClassAd();
+		publish_static(r_static_ad);
+	}
+	ad.Update(*r_static_ad);
+	// the resource quantities change when p-slots are split and swap is recomputed
+	r_attr->publish_static(&ad);
+
 	publish_dynamic(&ad, true);
 	// the collector will set this, but for direct query, we have to set this ourselves
 	if (cur_time) { ad.Assign(ATTR_LAST_HEARD_FROM, cur_time); }
@@ -1584,6 +1606,8 @@ void Resource::publish_single_slot_ad(ClassAd & ad, time_t cur_time, Purpose pur
 		process_update_ad(ad);
 		break;
 	case Purpose::for_snap:
+		// the child rollup in the cached static ad may be stale
+		if (is_partitionable_slot()) { publishDynamicChildSummaries(&ad); }
 		process_update_ad(ad);
 		break;
 	}
@@ -2534,7 +2558,8 @@ void Resource::publish_static(ClassAd* cap)
 			cap->Assign(ATTR_SLOT_TYPE, "Dynamic");
 			cap->Assign(ATTR_PARENT_SLOT_ID, r_id);
 			cap->Assign(ATTR_DSLOT_ID, r_sub_id);
-			if ( param_boolean("ADVERTISE_PSLOT_ROLLUP_INFORMATION", true) ) {
+			static param_cached_bool advertise_rollup("ADVERTISE_PSLOT_ROLLUP_INFORMATION", true);
+			if ( advertise_rollup.value() ) {
 				// the Negotiator uses this to determine if the p-slot will have rollup from the d-slot
 				cap->Assign(ATTR_PSLOT_ROLLUP_INFORMATION, true);
 			}
@@ -2708,6 +2733,12 @@ Resource::publish_dynamic(ClassAd* cap, bool /*for_update*/)
 }
 
 
+void Resource::invalidate_static_ad()
+{
+	delete r_static_ad;
+	r_static_ad = NULL;
+}
+
 // called when the resource bag of a slot has changed (p-slot or coalesced slot)
 void Resource::refresh_classad_resources() {
 	if (r_classad) {
@@ -3934,7 +3965,8 @@ Resource::publishDynamicChildSummaries(ClassAd *cap)
 	cap->Assign(ATTR_NUM_DYNAMIC_SLOTS, (long long)m_children.size());
 
 		// If not set, turn off the whole thing
-	if (param_boolean("ADVERTISE_PSLOT_ROLLUP_INFORMATION", true) == false) {
+	static param_cached_bool advertise_rollup("ADVERTISE_PSLOT_ROLLUP_INFORMATION", true);
+	if (advertise_rollup.value() == false) {
 		return;
 	}
 
@@ -274,6 +274,7 @@ public:
 		if (r_classad) this->publish_dynamic(r_classad, false);
 	}
 	void	refresh_classad_resources(); // called when the resource bag of a slot has changed (p-slot or coalesced slot)
+	void	invalidate_static_ad(); // discard the cached output of publish_static
 	void	refresh_classad_evaluated();
 	void	refresh_classad_slot_attrs(); // refresh cross-slot attrs into r_classad
 	void	refresh_draining_attrs();    // specialized refresh for changes caused by draining
@@ -348,6 +349,7 @@ public:
 	ResState*		r_state;	// Startd state object, contains state and activity
 	ClassAd*		r_config_classad; // Static/Base Resource classad (contains everything in config file)
 	ClassAd*		r_classad;  // Chained child of r_config_classad, cleaned out and rebuild frequently, publish writes into this one
+	ClassAd*		r_static_ad; // cached output of publish_static for building update ads, NULL when it needs to be rebuilt
 	Claim*			r_cur;		// Info about the current claim
 	Claim*			r_pre;		// Info about the possibly preempting claim
 	Claim*			r_pre_pre;	// Info about the preempting preempting claim
@@ -155,6 +155,12 @@ VanillaProc::VanillaProc(ClassAd* jobAd) : OsProc(jobAd),
 VanillaProc::~VanillaProc()
 {
 	cleanupOOM();
+#if defined(LINUX)
+	if( ! m_cgroup_v2_dir.empty() ) {
+		TemporaryPrivSentry sentry(PRIV_ROOT);
+		cgroup_v2_remove(m_cgroup_v2_dir);
+	}
+#endif
 }
 
 int
@@ -328,12 +334,14 @@ VanillaProc::StartJob()
 	setupOOMScore(4,800);
 #endif
 
-#if defined(HAVE_EXT_LIBCGROUP)
+#if defined(LINUX)
 	// Determine the cgroup
 	std::string cgroup_base;
 	param(cgroup_base, "BASE_CGROUP", "");
 	MyString cgroup_str;
+#if defined(HAVE_EXT_LIBCGROUP)
 	const char *cgroup = NULL;
+#endif
 		/* Note on CONDOR_UNIVERSE_LOCAL - The cgroup setup code below
 		 *  requires a unique name for the cgroup. It relies on
 		 *  uniqueness of the MachineAd's Name
@@ -368,11 +376,34 @@ VanillaProc::StartJob()
 		cgroup_str.formatstr("%s%ccondor%s", cgroup_base.c_str(), DIR_DELIM_CHAR,
 			cgroup_uniq.Value());
 		cgroup_str += this->CgroupSuffix();
-		
-		cgroup = cgroup_str.Value();
-		ASSERT (cgroup != NULL);
-		fi.cgroup = cgroup;
-		dprintf(D_FULLDEBUG, "Requesting cgroup %s for job.\n", cgroup);
+
+		if (cgroup_v2_has_controller("memory")) {
+				// The controllers are on the unified hierarchy, where
+				// libcgroup can't make a cgroup, so make the job's
+				// cgroup ourselves and have the job start in it.
+			if (m_cgroup_v2_dir.empty()) {
+				TemporaryPrivSentry sentry(PRIV_ROOT);
+				if (cgroup_v2_create(cgroup_str.Value(), m_cgroup_v2_dir)) {
+					dprintf(D_FULLDEBUG, "Using cgroup v2 directory %s for job.\n", m_cgroup_v2_dir.c_str());
+				} else {
+					m_cgroup_v2_dir.clear();
+				}
+			}
+			if ( ! m_cgroup_v2_dir.empty()) {
+				fi.cgroup_v2_dir = m_cgroup_v2_dir.c_str();
+					// The cgroup outlives a restart after a checkpoint,
+					// so count this run's usage from here.
+				m_cgroup_v2_start = CgroupV2Usage();
+				cgroup_v2_read_usage(m_cgroup_v2_dir, m_cgroup_v2_start);
+			}
+		} else {
+#if defined(HAVE_EXT_LIBCGROUP)
+			cgroup = cgroup_str.Value();
+			ASSERT (cgroup != NULL);
+			fi.cgroup = cgroup;
+			dprintf(D_FULLDEBUG, "Requesting cgroup %s for job.\n", cgroup);
+#endif
+		}
 	}
 
 #endif
@@ -692,7 +723,13 @@ VanillaProc::PublishUpdateAd( ClassAd* ad )
 					"VanillaProc::PublishUpdateAd() for pid %d\n", JobPid);
 			return false;
 		}
+#if defined(LINUX)
+		updateCgroupV2Usage(current_usage);
+#endif
 	}
+#if defined(LINUX)
+	publishCgroupV2Usage(ad);
+#endif
 
 	ProcFamilyUsage reported_usage = m_checkpoint_usage;
 	reported_usage += current_usage;
@@ -759,6 +796,58 @@ VanillaProc::PublishUpdateAd( ClassAd* ad )
 	return OsProc::PublishUpdateAd( ad );
 }
 
+#if defined(LINUX)
+// If we made a cgroup for the job, take its CPU and block i/o usage from
+// the kernel's counters for that cgroup.  Only the job is in it, and the
+// counters include processes the procd never saw, so they replace the
+// procd's figures.
+void
+VanillaProc::updateCgroupV2Usage( ProcFamilyUsage & usage )
+{
+	if( m_cgroup_v2_dir.empty() ) {
+		return;
+	}
+
+	CgroupV2Usage cg;
+	if( ! cgroup_v2_read_usage(m_cgroup_v2_dir, cg) ) {
+		return;
+	}
+	m_cgroup_v2_usage = cg;
+
+	const CgroupV2Usage & start = m_cgroup_v2_start;
+	if( cg.user_usec >= 0 && start.user_usec >= 0 ) {
+		usage.user_cpu_time = (long)((cg.user_usec - start.user_usec) / 1000000);
+	}
+	if( cg.system_usec >= 0 && start.system_usec >= 0 ) {
+		usage.sys_cpu_time = (long)((cg.system_usec - start.system_usec) / 1000000);
+	}
+	if( cg.read_bytes >= 0 && start.read_bytes >= 0 ) {
+		usage.block_read_bytes = cg.read_bytes - start.read_bytes;
+		usage.block_write_bytes = cg.write_bytes - start.write_bytes;
+		usage.block_reads = cg.reads - start.reads;
+		usage.block_writes = cg.writes - start.writes;
+	}
+}
+
+void
+VanillaProc::publishCgroupV2Usage( ClassAd* ad )
+{
+	const CgroupV2Usage & cg = m_cgroup_v2_usage;
+	if( cg.memory_current >= 0 ) {
+		ad->Assign( ATTR_CGROUP_MEMORY_KB, cg.memory_current / 1024 );
+	}
+	if( cg.cpu.some_avg10 >= 0 ) {
+		ad->Assign( ATTR_CPU_PRESSURE, cg.cpu.some_avg10 );
+	}
+	if( cg.memory.some_avg10 >= 0 ) {
+		ad->Assign( ATTR_MEMORY_PRESSURE, cg.memory.some_avg10 );
+	}
+	if( cg.io.some_avg10 >= 0 ) {
+		ad->Assign( ATTR_IO_PRESSURE, cg.io.some_avg10 );
+	}
+}
+#endif
+
 
 int VanillaProc::pidNameSpaceReaper( int status ) {
 	if (requested_exit) {
@@ -795,6 +884,9 @@ void VanillaProc::recordFinalUsage() {
 		dprintf( D_ALWAYS, "error getting family usage for pid %d in "
 			"VanillaProc::JobReaper()\n", JobPid );
 	}
+#if defined(LINUX)
+	updateCgroupV2Usage(m_final_usage);
+#endif
 }
 
 void VanillaProc::killFamilyIfWarranted() {
@@ -816,6 +908,9 @@ void VanillaProc::restartCheckpointedJob() {
 		dprintf( D_ALWAYS, "error getting family usage for pid %d in "
 			"VanillaProc::restartCheckpointedJob()\n", JobPid );
 	}
+#if defined(LINUX)
+	updateCgroupV2Usage(last_usage);
+#endif
 	m_checkpoint_usage += last_usage;
 
 	if( Starter->jic->uploadCheckpointFiles() ) {
@@ -23,6 +23,9 @@
 
 #include "os_proc.h"
 #include "generic_stats.h"
+#if defined(LINUX)
+#include "cgroup_v2.linux.h"
+#endif
 
 /* forward reference */
 class SafeSock;
@@ -142,6 +145,17 @@ private:
 
 	std::string m_pid_ns_status_filename;
 
+#if defined(LINUX)
+		// The cgroup we made for the job on the unified (v2) hierarchy,
+		// if any, its usage when this run of the job started, and its
+		// usage when we last looked.
+	std::string m_cgroup_v2_dir;
+	CgroupV2Usage m_cgroup_v2_start;
+	CgroupV2Usage m_cgroup_v2_usage;
+	void updateCgroupV2Usage( ProcFamilyUsage & usage );
+	void publishCgroupV2Usage( ClassAd* ad );
+#endif
+
 	// Internal helper functions.
 	int pidNameSpaceReaper( int status );
 	void recordFinalUsage();
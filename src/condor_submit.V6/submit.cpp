@@ -3073,34 +3073,21 @@ static int MySendJobAttributes(const JOB_ID_KEY & key, const classad::ClassAd &
 {
 	classad::ClassAdUnParser unparser;
 	unparser.SetOldClassAd( true, true );
-	std::string rhs; rhs.reserve(120);
 
 	MyString keybuf;
 	key.sprint(keybuf);
 	const char * keystr = keybuf.c_str();
 
-	int retval = 0;
 	bool is_cluster = key.proc < 0;
 
-	// first try and send the cluster id or proc id
+	std::vector<std::pair<std::string, std::string> > attrs;
+	attrs.reserve(ad.size() + 2);
+
+	// first the cluster id or proc id
 	if (is_cluster) {
-		if (MyQ->set_AttributeInt (key.cluster, -1, ATTR_CLUSTER_ID, key.cluster, saflags) == -1) {
-			if (saflags & SetAttribute_NoAck) {
-				fprintf( stderr, "\nERROR: Failed submission for job %s - aborting entire submit\n", keystr);
-			} else {
-				fprintf( stderr, "\nERROR: Failed to set " ATTR_CLUSTER_ID "=%d for job %s (%d)\n", key.cluster, keystr, errno);
-			}
-			return -1;
-		}
+		attrs.push_back(std::make_pair(std::string(ATTR_CLUSTER_ID), std::to_string(key.cluster)));
 	} else {
-		if (MyQ->set_AttributeInt (key.cluster, key.proc, ATTR_PROC_ID, key.proc, saflags) == -1) {
-			if (saflags & SetAttribute_NoAck) {
-				fprintf( stderr, "\nERROR: Failed submission for job %s - aborting entire submit\n", keystr);
-			} else {
-				fprintf( stderr, "\nERROR: Failed to set " ATTR_PROC_ID "=%d for job %s (%d)\n", key.proc, keystr, errno);
-			}
-			return -1;
-		}
+		attrs.push_back(std::make_pair(std::string(ATTR_PROC_ID), std::to_string(key.proc)));
 
 		// For now, we make sure to set the JobStatus attribute in the proc ad, note that we may actually be
 		// fetching this from a chained parent ad.  this is the ONLY attribute that we want to pick up
@@ -3109,50 +3096,46 @@ static int MySendJobAttributes(const JOB_ID_KEY & key, const classad::ClassAd &
 		// and per-owner totals by state doesn't work if this attribute is missing in the proc ads.
 		int status = IDLE;
 		if ( ! ad.EvaluateAttrInt(ATTR_JOB_STATUS, status)) { status = IDLE; }
-		if (MyQ->set_AttributeInt (key.cluster, key.proc, ATTR_JOB_STATUS, status, saflags) == -1) {
-			if (saflags & SetAttribute_NoAck) {
-				fprintf( stderr, "\nERROR: Failed submission for job %s - aborting entire submit\n", keystr);
-			} else {
-				fprintf( stderr, "\nERROR: Failed to set " ATTR_JOB_STATUS "=%d for job %s (%d)\n", status, keystr, errno);
-			}
-			return -1;
-		}
+		attrs.push_back(std::make_pair(std::string(ATTR_JOB_STATUS), std::to_string(status)));
 	}
 
-	// (shallow) iterate the attributes in this ad and send them to the schedd
+	// (shallow) iterate the attributes in this ad
 	//
 	for (auto it = ad.begin(); it != ad.end(); ++it) {
 		const char * attr = it->first.c_str();
 
-		// skip attributes that are forced into the other sort of ad, or have already been sent.
+		// skip attributes that are forced into the other sort of ad, or have already been added.
 		int forced = IsForcedProcAttribute(attr);
 		if (forced) {
-			// skip attributes not forced into the cluster ad and not already sent
+			// skip attributes not forced into the cluster ad and not already added
 			if (is_cluster && (forced != -1)) continue;
-			// skip attributes not forced into the proc ad and not already sent
+			// skip attributes not forced into the proc ad and not already added
 			if ( ! is_cluster && (forced != 1)) continue;
 		}
 
 		if ( ! it->second) {
 			fprintf(stderr, "\nERROR: Null attribute name or value for job %s\n", keystr);
-			retval = -1;
-			break;
+			return -1;
 		}
-		rhs.clear();
-		unparser.Unparse(rhs, it->second);
+		attrs.push_back(std::make_pair(it->first, std::string()));
+		unparser.Unparse(attrs.back().second, it->second);
+	}
 
-		if (MyQ->set_Attribute(key.cluster, key.proc, attr, rhs.c_str(), saflags) == -1) {
-			if (saflags & SetAttribute_NoAck) {
-				fprintf( stderr, "\nERROR: Failed submission for job %s - aborting entire submit\n", keystr);
-			} else {
-				fprintf( stderr, "\nERROR: Failed to set %s=%s for job %s (%d)\n", attr, rhs.c_str(), keystr, errno );
-			}
-			retval = -1;
-			break;
+	// and send them to the schedd all at once
+	int failed_index = -1;
+	if (MyQ->set_JobAttributes(key.cluster, key.proc, attrs, saflags, &failed_index) == -1) {
+		if (saflags & SetAttribute_NoAck) {
+			fprintf( stderr, "\nERROR: Failed submission for job %s - aborting entire submit\n", keystr);
+		} else if (failed_index >= 0 && failed_index < (int)attrs.size()) {
+			fprintf( stderr, "\nERROR: Failed to set %s=%s for job %s (%d)\n",
+				attrs[failed_index].first.c_str(), attrs[failed_index].second.c_str(), keystr, errno );
+		} else {
+			fprintf( stderr, "\nERROR: Failed to set attributes for job %s (%d)\n", keystr, errno );
 		}
+		return -1;
 	}
 
-	return retval;
+	return 0;
 }
 
 
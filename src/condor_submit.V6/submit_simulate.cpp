@@ -148,6 +148,14 @@ int SimScheddQ::set_AttributeInt(int cluster_id, int proc_id, const char *attr,
 	return 0;
 }
 
+int SimScheddQ::set_JobAttributes(int cluster_id, int proc_id, const std::vector<std::pair<std::string, std::string> > & attrs, SetAttributeFlags_t flags, int * failed_index) {
+	if (failed_index) { *failed_index = -1; }
+	for (auto it = attrs.begin(); it != attrs.end(); ++it) {
+		set_Attribute(cluster_id, proc_id, it->first.c_str(), it->second.c_str(), flags);
+	}
+	return 0;
+}
+
 
 int SimScheddQ::set_Factory(int cluster_id, int qnum, const char * filename, const char * text) {
 	ASSERT(cluster_id == cluster);
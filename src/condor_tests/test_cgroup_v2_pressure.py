@@ -0,0 +1,221 @@
+#!/usr/bin/env pytest
+
+# On a machine whose cgroup controllers are on the v2 (unified) hierarchy,
+# check that the starter puts the job in a cgroup of its own and that the
+# job ad gets the job's memory usage and pressure stall figures from it.
+# Then check that with STARTD_PSLOT_MAX_PRESSURE set, a partitionable slot
+# stops matching, so no dynamic slot is carved out of it, while the
+# machine's memory pressure is above that limit, and matches again once the
+# pressure has gone back down.  The pressure comes from a process in a cgroup
+# of the test's own whose memory.high is far below what the process touches.
+#
+# The starter can only make cgroups as root, so this only runs as root.
+
+import logging
+import os
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+import pytest
+
+import classad
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+CGROUP_ROOT = Path("/sys/fs/cgroup")
+MAX_PRESSURE = 5
+JOB_DURATION = 60
+# how long the job must go unmatched while the machine is under pressure
+UNDER_PRESSURE_SECONDS = 30
+
+STRESSOR = """
+import time
+buf = bytearray({size})
+while True:
+    for i in range(0, len(buf), 4096):
+        buf[i] = (buf[i] + 1) & 255
+"""
+
+
+def cgroup_v2_memory():
+    controllers = CGROUP_ROOT / "cgroup.controllers"
+    return controllers.exists() and "memory" in controllers.read_text().split()
+
+
+pytestmark = pytest.mark.skipif(
+    os.geteuid() != 0 or not cgroup_v2_memory() or not Path("/proc/pressure/memory").exists(),
+    reason="needs root, the memory controller on cgroup v2 and pressure stall information",
+)
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={
+            "BASE_CGROUP": "htcondor_test",
+            "NUM_CPUS": "2",
+            "SLOT_TYPE_1": "cpus=100%,memory=100%,disk=100%",
+            "SLOT_TYPE_1_PARTITIONABLE": "True",
+            "NUM_SLOTS_TYPE_1": "1",
+            "STARTD_PSLOT_MAX_PRESSURE": str(MAX_PRESSURE),
+            "UPDATE_INTERVAL": "5",
+            "POLLING_INTERVAL": "2",
+            "STARTER_UPDATE_INTERVAL": "5",
+            "SHADOW_QUEUE_UPDATE_INTERVAL": "5",
+        },
+    ) as condor:
+        yield condor
+
+
+def pslot_ad(condor):
+    ads = condor.get_local_collector().query(
+        htcondor.AdTypes.Startd, "PartitionableSlot"
+    )
+    assert len(ads) == 1
+    return ads[0]
+
+
+def dynamic_slots(condor):
+    return condor.get_local_collector().query(
+        htcondor.AdTypes.Startd, "DynamicSlot", ["Name"]
+    )
+
+
+def wait_for(condition, timeout, interval=2):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        result = condition()
+        if result:
+            return result
+        time.sleep(interval)
+    return condition()
+
+
+@standup
+def running_job(condor, path_to_sleep):
+    handle = condor.submit(
+        {
+            "executable": path_to_sleep,
+            "arguments": str(JOB_DURATION),
+            "request_memory": "16",
+            "request_disk": "1024",
+        }
+    )
+    assert handle.wait(condition=ClusterState.all_running, timeout=120)
+    return handle
+
+
+@standup
+def job_usage(running_job):
+    # wait for the starter's and then the shadow's next update to get there
+    def usage():
+        ads = running_job.query(
+            projection=["CgroupMemoryKb", "CpuPressure", "MemoryPressure", "IOPressure"]
+        )
+        return ads[0] if "CgroupMemoryKb" in ads[0] else None
+
+    return wait_for(usage, timeout=60)
+
+
+@standup
+def idle_pslot(condor, running_job):
+    assert running_job.wait(condition=ClusterState.all_complete, timeout=JOB_DURATION * 3)
+    assert wait_for(lambda: not dynamic_slots(condor), timeout=60)
+    return pslot_ad(condor)
+
+
+@standup
+def stressor(test_dir, idle_pslot):
+    # a cgroup that may hold only a fraction of what its process keeps
+    # touching, so the process spends most of its time stalled on memory
+    cgroup = CGROUP_ROOT / "htcondor_test_pressure_{}".format(os.getpid())
+    cgroup.mkdir()
+    (cgroup / "memory.high").write_text(str(32 * 1024 * 1024))
+    procs = cgroup / "cgroup.procs"
+    proc = subprocess.Popen(
+        [sys.executable, "-c", STRESSOR.format(size=512 * 1024 * 1024)],
+        preexec_fn=lambda: procs.write_text(str(os.getpid())),
+    )
+    yield proc
+    if proc.poll() is None:
+        proc.kill()
+        proc.wait()
+    cgroup.rmdir()
+
+
+@standup
+def job_under_pressure(condor, stressor, path_to_sleep):
+    def pressure():
+        return pslot_ad(condor).get("TotalMemoryPressure", 0) > MAX_PRESSURE
+
+    if not wait_for(pressure, timeout=90):
+        pytest.skip("could not raise the machine's memory pressure above {}".format(MAX_PRESSURE))
+
+    handle = condor.submit(
+        {
+            "executable": path_to_sleep,
+            "arguments": "0",
+            "request_memory": "16",
+            "request_disk": "1024",
+        }
+    )
+    time.sleep(UNDER_PRESSURE_SECONDS)
+    under_pressure = {
+        "status": handle.state[0],
+        "dynamic_slots": dynamic_slots(condor),
+        "pressure": pslot_ad(condor).get("TotalMemoryPressure"),
+    }
+    logger.info("While under pressure: {}".format(under_pressure))
+
+    stressor.kill()
+    stressor.wait()
+    ran = handle.wait(condition=ClusterState.all_complete, timeout=180)
+    return under_pressure, ran
+
+
+def within_resource_limits(slot_ad, memory_pressure):
+    # match a small job against the slot's WithinResourceLimits alone, with
+    # the machine's pressure replaced by the given figures
+    slot = classad.ClassAd()
+    slot.update(slot_ad)
+    slot["TotalMemoryPressure"] = memory_pressure
+    slot["TotalIOPressure"] = 0.0
+    slot["Requirements"] = classad.ExprTree("WithinResourceLimits")
+    job = classad.ClassAd(
+        {"RequestCpus": 1, "RequestMemory": 16, "RequestDisk": 1024, "Requirements": True}
+    )
+    return slot.symmetricMatch(job)
+
+
+class TestCgroupV2Pressure:
+    def test_job_ad_has_cgroup_usage(self, job_usage):
+        assert job_usage is not None
+        assert job_usage["CgroupMemoryKb"] > 0
+        for attr in ["CpuPressure", "MemoryPressure", "IOPressure"]:
+            assert 0 <= job_usage[attr] <= 100
+
+    def test_machine_publishes_pressure(self, idle_pslot):
+        for attr in ["TotalCpuPressure", "TotalMemoryPressure", "TotalIOPressure"]:
+            assert 0 <= idle_pslot[attr] <= 100
+
+    def test_pslot_limits_include_pressure(self, idle_pslot):
+        assert within_resource_limits(idle_pslot, 0.0)
+        assert within_resource_limits(idle_pslot, float(MAX_PRESSURE))
+        assert not within_resource_limits(idle_pslot, MAX_PRESSURE + 1.0)
+
+    def test_no_dynamic_slot_under_pressure(self, job_under_pressure):
+        under_pressure, _ = job_under_pressure
+        assert under_pressure["status"] == JobStatus.IDLE
+        assert under_pressure["dynamic_slots"] == []
+
+    def test_job_runs_once_pressure_drops(self, job_under_pressure):
+        _, ran = job_under_pressure
+        assert ran
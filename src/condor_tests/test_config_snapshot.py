@@ -0,0 +1,100 @@
+#!/usr/bin/env pytest
+
+# Check that with MASTER_CONFIG_SNAPSHOT the schedd and the shadow see the
+# same configuration whether they read the master's config snapshot or the
+# config files, including knobs that are set for one subsystem only.  A
+# config with a prefixed self reference (SHADOW.X = $(X) ...) means
+# something different to each daemon that reads it, so the master must not
+# write a snapshot of it at all.
+
+import logging
+import os
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+SNAPSHOT_ENV = "CONDOR_CONFIG_SNAPSHOT"
+PREFIXED_SELF_REFERENCE = """
+TOOL_DEBUG = D_FULLDEBUG
+SHADOW.TOOL_DEBUG = $(TOOL_DEBUG) D_X
+"""
+
+
+@action(params={"plain": "", "prefixed": PREFIXED_SELF_REFERENCE})
+def raw_config(request):
+    return request.param
+
+
+@action
+def condor(test_dir, raw_config):
+    with Condor(
+        local_dir=test_dir / "condor-{}".format("prefixed" if raw_config else "plain"),
+        config={
+            "MASTER_CONFIG_SNAPSHOT": "True",
+            "SNAPSHOT_TEST_KNOB": "for-everyone",
+            "SCHEDD.SNAPSHOT_TEST_KNOB": "for-the-schedd",
+        },
+        raw_config=raw_config,
+    ) as condor:
+        yield condor
+
+
+@action
+def snapshot(condor):
+    return condor.lock_dir / "config_snapshot"
+
+
+@action(params={"schedd": "SCHEDD", "shadow": "SHADOW"})
+def subsys(request):
+    return request.param
+
+
+def config_val(condor, subsys, args, snapshot=None):
+    # read the config the way a daemon started by the master would, with or
+    # without the snapshot that the master passes in the environment
+    saved = os.environ.pop(SNAPSHOT_ENV, None)
+    if snapshot is not None:
+        os.environ[SNAPSHOT_ENV] = str(snapshot)
+    try:
+        result = condor.run_command(["condor_config_val", "-subsystem", subsys] + args)
+    finally:
+        os.environ.pop(SNAPSHOT_ENV, None)
+        if saved is not None:
+            os.environ[SNAPSHOT_ENV] = saved
+    assert result.returncode == 0, result.stderr
+    return result.stdout
+
+
+@action
+def dumps(condor, snapshot, subsys):
+    return {
+        "files": config_val(condor, subsys, ["-dump"]),
+        "snapshot": config_val(condor, subsys, ["-dump"], snapshot),
+    }
+
+
+class TestConfigSnapshot:
+    def test_snapshot_only_for_plain_config(self, condor, snapshot, raw_config):
+        if raw_config:
+            assert not snapshot.exists()
+            assert "Not writing a config snapshot" in condor.master_log.path.read_text()
+        else:
+            assert snapshot.exists()
+
+    def test_snapshot_is_read(self, condor, snapshot, subsys, raw_config):
+        where = config_val(condor, subsys, ["-verbose", "SNAPSHOT_TEST_KNOB"], snapshot)
+        assert ("config_snapshot" in where) == (not raw_config)
+
+    def test_dump_matches_config_files(self, dumps):
+        assert dumps["snapshot"] == dumps["files"]
+
+    def test_subsystem_knobs(self, condor, snapshot, subsys, raw_config):
+        knob = config_val(condor, subsys, ["SNAPSHOT_TEST_KNOB"], snapshot).strip()
+        assert knob == ("for-the-schedd" if subsys == "SCHEDD" else "for-everyone")
+
+        if raw_config:
+            debug = config_val(condor, subsys, ["TOOL_DEBUG"], snapshot).split()
+            assert debug == (["D_FULLDEBUG", "D_X"] if subsys == "SHADOW" else ["D_FULLDEBUG"])
@@ -0,0 +1,124 @@
+#!/usr/bin/env pytest
+
+# Check that DAGMan submits node jobs directly to the schedd by default,
+# putting every node that is ready in the same submit cycle into a single
+# transaction, and that the jobs it submits this way get the same
+# attributes as the jobs condor_submit would have made, with each node's
+# VARS only reaching that node's jobs.
+
+import json
+import logging
+import textwrap
+import time
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_NODES = 10
+NODES = ["N{}".format(i) for i in range(NUM_NODES)]
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor", config={"DAGMAN_USE_STRICT": "0"}
+    ) as condor:
+        yield condor
+
+
+@action(params={"direct": None, "condor_submit": "True"})
+def use_condor_submit(request):
+    return request.param
+
+
+@action
+def dag_dir(test_dir, use_condor_submit):
+    return test_dir / "dagman-{}".format("condor_submit" if use_condor_submit else "direct")
+
+
+@action
+def dag_job(condor, path_to_sleep, dag_dir, use_condor_submit):
+    submit_file = write_file(
+        dag_dir / "node.sub",
+        textwrap.dedent(
+            """
+            executable = {}
+            arguments = 0
+            My.NodeVar = "$(nodevar)"
+            queue
+            """.format(path_to_sleep)
+        ),
+    )
+
+    lines = []
+    if use_condor_submit is not None:
+        config_file = write_file(
+            dag_dir / "dagman.config",
+            "DAGMAN_USE_CONDOR_SUBMIT = {}\n".format(use_condor_submit),
+        )
+        lines.append("CONFIG {}".format(config_file))
+    for node in NODES:
+        lines.append("JOB {} {}".format(node, submit_file))
+        lines.append('VARS {} nodevar="value-of-{}"'.format(node, node))
+    dag_file = write_file(dag_dir / "direct.dag", "\n".join(lines) + "\n")
+
+    dag_job = condor.submit(htcondor.Submit.from_dag(str(dag_file)))
+    assert dag_job.wait(condition=ClusterState.all_terminal, timeout=300)
+    return dag_job
+
+
+@action
+def dagman_out(dag_dir, dag_job):
+    return (dag_dir / "direct.dag.dagman.out").read_text()
+
+
+@action
+def metrics(dag_dir, dag_job):
+    return json.loads((dag_dir / "direct.dag.metrics").read_text())
+
+
+@action
+def node_jobs(condor, dag_job):
+    # the node jobs may still be leaving the queue when DAGMan exits
+    for _ in range(60):
+        ads = list(
+            condor.get_local_schedd().history(
+                "DAGManJobId == {}".format(dag_job.clusterid),
+                ["DAGNodeName", "NodeVar", "JobStatus"],
+                NUM_NODES * 2,
+            )
+        )
+        if len(ads) >= NUM_NODES:
+            break
+        time.sleep(1)
+    return {ad["DAGNodeName"]: ad for ad in ads}
+
+
+class TestDagmanDirectSubmit:
+    def test_dag_completed(self, dag_job, dagman_out):
+        assert dag_job.state[0] == JobStatus.COMPLETED
+        assert "All jobs Completed!" in dagman_out
+
+    def test_submit_method(self, dagman_out, use_condor_submit):
+        direct = "using direct job submission" in dagman_out
+        assert direct == (use_condor_submit is None)
+
+    def test_ready_nodes_share_one_transaction(self, dagman_out, use_condor_submit):
+        one_transaction = "Submitted {} nodes in one transaction".format(NUM_NODES)
+        assert (one_transaction in dagman_out) == (use_condor_submit is None)
+
+    def test_each_node_got_its_own_vars(self, node_jobs):
+        assert sorted(node_jobs.keys()) == sorted(NODES)
+        for node, ad in node_jobs.items():
+            assert ad["NodeVar"] == "value-of-{}".format(node)
+            assert ad["JobStatus"] == JobStatus.COMPLETED
+
+    def test_metrics_count_submits(self, metrics):
+        assert metrics["total_jobs_submitted"] == NUM_NODES
+        assert metrics["submit_time"] >= 0
+        assert metrics["submit_rate"] >= 0
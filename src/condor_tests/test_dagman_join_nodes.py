@@ -0,0 +1,153 @@
+#!/usr/bin/env pytest
+
+# Check that DAGMan inserts a join node for a many-PARENT-many-CHILD
+# statement only when it saves dependencies, that the join node still
+# holds the children back until every parent is done, that join nodes are
+# left out of the node counts and the node status file, and that a rescue
+# DAG which marks a join node done is accepted by a DAG that no longer has
+# that join node.
+
+import json
+import logging
+import re
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+PARENTS = ["A1", "A2", "A3"]
+CHILDREN = ["B1", "B2", "B3"]
+# one parent and two children: a join node would add edges, not save them
+SMALL = ["C", "D1", "D2"]
+NODES = PARENTS + CHILDREN + SMALL
+JOIN_NODE = "_condor_join_node1"
+
+
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor") as condor:
+        yield condor
+
+
+@standup
+def submit_files(test_dir, path_to_sleep):
+    fail = write_file(test_dir / "fail.sh", "#!/bin/sh\nexit 1\n")
+    fail.chmod(0o755)
+    return {
+        "ok": write_file(
+            test_dir / "ok.sub",
+            "executable = {}\narguments = 0\nqueue\n".format(path_to_sleep),
+        ),
+        "fail": write_file(
+            test_dir / "fail.sub", "executable = {}\nqueue\n".format(fail)
+        ),
+    }
+
+
+def write_dag(test_dir, submit_files, b1, first_statement):
+    lines = []
+    for node in NODES:
+        kind = b1 if node == "B1" else "ok"
+        lines.append("JOB {} {}".format(node, submit_files[kind]))
+    lines.append(first_statement)
+    lines.append("PARENT C CHILD D1 D2")
+    lines.append("NODE_STATUS_FILE join.status")
+    return write_file(test_dir / "join.dag", "\n".join(lines) + "\n")
+
+
+def run_dag(condor, dag_file):
+    dag_job = condor.submit(htcondor.Submit.from_dag(str(dag_file)))
+    assert dag_job.wait(condition=ClusterState.all_terminal, timeout=300)
+    return dag_job
+
+
+@standup
+def failed_run(condor, test_dir, submit_files):
+    # B1 fails, so DAGMan writes a rescue DAG
+    dag_file = write_dag(
+        test_dir,
+        submit_files,
+        "fail",
+        "PARENT {} CHILD {}".format(" ".join(PARENTS), " ".join(CHILDREN)),
+    )
+    run_dag(condor, dag_file)
+    return {
+        "dagman_out": (test_dir / "join.dag.dagman.out").read_text(),
+        "status": (test_dir / "join.status").read_text(),
+        "metrics": json.loads((test_dir / "join.dag.metrics").read_text()),
+        "rescue": (test_dir / "join.dag.rescue001").read_text(),
+        "node_log": str(test_dir / "join.dag.nodes.log"),
+    }
+
+
+@standup
+def rescue_run(condor, test_dir, submit_files, failed_run):
+    # the same nodes, but the statement that got a join node now has only
+    # one parent, so the rescue DAG names a join node this DAG doesn't have
+    dag_file = write_dag(
+        test_dir, submit_files, "ok", "PARENT A1 CHILD {}".format(" ".join(CHILDREN))
+    )
+    dag_job = run_dag(condor, dag_file)
+    return dag_job, (test_dir / "join.dag.dagman.out").read_text()
+
+
+def node_event_order(node_log):
+    # returns {node: [(event index, event type)]} from the node log
+    cluster_node = {}
+    events = {}
+    for i, event in enumerate(htcondor.JobEventLog(node_log).events(stop_after=0)):
+        if event.type == htcondor.JobEventType.SUBMIT:
+            match = re.search(r"DAG Node: (\S+)", event.get("LogNotes", ""))
+            if match:
+                cluster_node[event.cluster] = match.group(1)
+        node = cluster_node.get(event.cluster)
+        if node is not None:
+            events.setdefault(node, []).append((i, event.type))
+    return events
+
+
+class TestDagmanJoinNodes:
+    def test_join_node_only_where_it_saves_edges(self, failed_run):
+        # dagman.out names every node it submits, join nodes included
+        assert "Node {}".format(JOIN_NODE) in failed_run["dagman_out"]
+        assert "_condor_join_node2" not in failed_run["dagman_out"]
+
+    def test_children_wait_for_every_parent(self, failed_run):
+        events = node_event_order(failed_run["node_log"])
+        last_parent_done = max(
+            i
+            for node in PARENTS
+            for i, kind in events[node]
+            if kind == htcondor.JobEventType.JOB_TERMINATED
+        )
+        first_child_submit = min(
+            i
+            for node in CHILDREN
+            for i, kind in events[node]
+            if kind == htcondor.JobEventType.SUBMIT
+        )
+        assert last_parent_done < first_child_submit
+
+    def test_join_nodes_not_counted(self, failed_run):
+        assert "Of {} nodes total".format(len(NODES)) in failed_run["dagman_out"]
+        assert failed_run["metrics"]["jobs"] == len(NODES)
+        assert failed_run["metrics"]["jobs_failed"] == 1
+
+    def test_join_nodes_not_in_status_file(self, failed_run):
+        assert "_condor_join_node" not in failed_run["status"]
+        for node in NODES:
+            assert 'Node = "{}"'.format(node) in failed_run["status"]
+
+    def test_rescue_dag_marks_join_node_done(self, failed_run):
+        assert "DONE {}".format(JOIN_NODE) in failed_run["rescue"]
+
+    def test_rescue_of_missing_join_node_accepted(self, rescue_run):
+        dag_job, dagman_out = rescue_run
+        assert "Ignoring DONE for join node {}".format(JOIN_NODE) in dagman_out
+        assert dag_job.state[0] == JobStatus.COMPLETED
+        # dagman.out is appended to, so look at how the second run ended
+        assert re.findall(r"EXITING WITH STATUS (\d+)", dagman_out)[-1] == "0"
@@ -0,0 +1,168 @@
+#!/usr/bin/env pytest
+
+# Check that DAGMan in recovery mode replays its node state journal when the
+# journal matches the node log, and falls back to reading the whole node log
+# when the journal has been cut short or the node log has changed under it.
+# In every case the DAG must still finish, and the journal must be removed
+# when it does.
+
+import logging
+import re
+import shutil
+import textwrap
+import time
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+# the journal header is "DAGNJRN2", a u32 node count and a u64 signature
+JOURNAL_HEADER_SIZE = 8 + 4 + 8
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={"DAGMAN_USE_STRICT": "0", "DAGMAN_NODE_JOURNAL": "true"},
+    ) as condor:
+        yield condor
+
+
+def replace_node_log(dag_dir):
+    # a new file with the same contents has a different inode
+    log = dag_dir / "journal.dag.nodes.log"
+    copy = dag_dir / "journal.dag.nodes.log.copy"
+    shutil.copyfile(str(log), str(copy))
+    copy.rename(log)
+
+
+def rewrite_node_log_in_place(dag_dir):
+    # change one digit of the first event time, keeping the inode and size
+    log = dag_dir / "journal.dag.nodes.log"
+    with log.open("r+b") as f:
+        contents = f.read()
+        match = re.search(rb"\d\d:\d\d:(\d)\d", contents)
+        assert match is not None
+        digit = b"1" if match.group(1) != b"1" else b"2"
+        f.seek(match.start(1))
+        f.write(digit)
+
+
+def truncate_journal(dag_dir):
+    # cut the journal off in the middle of its first record
+    journal = dag_dir / "journal.dag.nodes.log.journal"
+    with journal.open("r+b") as f:
+        f.truncate(JOURNAL_HEADER_SIZE + 5)
+
+
+SCENARIOS = {
+    "replay": (None, r"Replaying [1-9]\d* events from node state journal"),
+    "truncated-journal": (truncate_journal, r"has no checkpoint; ignoring it"),
+    "replaced-node-log": (replace_node_log, r"has changed since node state journal"),
+    "rewritten-node-log": (
+        rewrite_node_log_in_place,
+        r"has changed since node state journal",
+    ),
+}
+
+
+@action(params={name: name for name in SCENARIOS})
+def scenario(request):
+    return request.param
+
+
+@action
+def dag_dir(test_dir, scenario):
+    # each scenario gets its own directory, so its journal is its own
+    return test_dir / "dagman-{}".format(scenario)
+
+
+def wait_for_text(path, text, timeout=180):
+    for _ in range(timeout):
+        if path.exists() and text in path.read_text():
+            return
+        time.sleep(1)
+    assert False, "{} never contained {}".format(path, text)
+
+
+@action
+def recovered_dag_job(condor, path_to_sleep, dag_dir, scenario):
+    go_file = dag_dir / "go"
+    pre_script = write_file(
+        dag_dir / "wait_for_go.sh",
+        textwrap.dedent(
+            """\
+            #!/bin/sh
+            while [ ! -f {} ]; do sleep 1; done
+            exit 0
+            """.format(go_file)
+        ),
+    )
+    pre_script.chmod(0o755)
+
+    dag_file = write_file(
+        dag_dir / "journal.dag",
+        textwrap.dedent(
+            """
+            JOB A {{
+                executable = {sleep}
+                arguments = 0
+            }}
+            JOB B {{
+                executable = {sleep}
+                arguments = 0
+            }}
+            SCRIPT PRE B {pre}
+            PARENT A CHILD B
+            """.format(sleep=path_to_sleep, pre=pre_script)
+        ),
+    )
+
+    dag_job = condor.submit(htcondor.Submit.from_dag(str(dag_file)))
+
+    # node B's PRE script only runs once node A's events have been read and
+    # written to the journal
+    dagman_out = dag_dir / "journal.dag.dagman.out"
+    wait_for_text(dagman_out, "Running PRE script of Node B")
+
+    # holding and releasing DAGMan restarts it in recovery mode
+    dag_job.hold()
+    assert dag_job.wait(condition=ClusterState.all_held, timeout=60)
+
+    damage, _ = SCENARIOS[scenario]
+    if damage is not None:
+        damage(dag_dir)
+
+    go_file.touch()
+    dag_job.release()
+    assert dag_job.wait(condition=ClusterState.all_terminal, timeout=300)
+
+    return dag_job
+
+
+@action
+def dagman_out(dag_dir, recovered_dag_job):
+    return (dag_dir / "journal.dag.dagman.out").read_text()
+
+
+class TestDagmanNodeJournal:
+    def test_dag_completed(self, recovered_dag_job):
+        assert recovered_dag_job.state[0] == JobStatus.COMPLETED
+
+    def test_dag_ran_recovery(self, dagman_out):
+        assert "Running in RECOVERY mode" in dagman_out
+
+    def test_journal_was_used_or_rejected(self, dagman_out, scenario):
+        _, expected = SCENARIOS[scenario]
+        assert re.search(expected, dagman_out) is not None
+
+    def test_every_node_succeeded(self, dagman_out):
+        assert "All jobs Completed!" in dagman_out
+
+    def test_journal_removed_on_completion(self, dag_dir, recovered_dag_job):
+        assert not (dag_dir / "journal.dag.nodes.log.journal").exists()
@@ -0,0 +1,93 @@
+#!/usr/bin/env pytest
+
+# Check that DAGMan reads node job events as soon as they are written to the
+# node log, rather than at its next scan of the log.  The scan interval is
+# set far longer than the jobs take, so a DAG that reacts to each event
+# within a few seconds can only be doing so because it was told the log
+# changed.
+
+import datetime
+import logging
+import re
+import textwrap
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+SCAN_INTERVAL = 120
+# generous, but still far short of the scan interval
+MAX_LAG = 15
+NODES = ["A", "B", "C"]
+
+TIME = r"(\d\d/\d\d/\d\d \d\d:\d\d:\d\d)"
+EVENT_LINE = re.compile(
+    r"^{} Event: ULOG_JOB_TERMINATED for HTCondor Node (\w+) \(\S+\) \{{{}\}}".format(
+        TIME, TIME
+    ),
+    re.MULTILINE,
+)
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={
+            "DAGMAN_USE_STRICT": "0",
+            "DAGMAN_USER_LOG_SCAN_INTERVAL": str(SCAN_INTERVAL),
+        },
+    ) as condor:
+        yield condor
+
+
+@action
+def dag_job(condor, test_dir, path_to_sleep):
+    jobs = "".join(
+        textwrap.dedent(
+            """
+            JOB {node} {{
+                executable = {sleep}
+                arguments = 0
+            }}
+            """
+        ).format(node=node, sleep=path_to_sleep)
+        for node in NODES
+    )
+    dag_file = write_file(
+        test_dir / "notify.dag", jobs + "PARENT A CHILD B\nPARENT B CHILD C\n"
+    )
+
+    dag_job = condor.submit(htcondor.Submit.from_dag(str(dag_file)))
+    assert dag_job.wait(condition=ClusterState.all_terminal, timeout=SCAN_INTERVAL * 2)
+    return dag_job
+
+
+@action
+def dagman_out(test_dir, dag_job):
+    return (test_dir / "notify.dag.dagman.out").read_text()
+
+
+def parse_time(text):
+    return datetime.datetime.strptime(text, "%m/%d/%y %H:%M:%S")
+
+
+class TestDagmanNodeLogNotify:
+    def test_dag_completed(self, dag_job, dagman_out):
+        assert dag_job.state[0] == JobStatus.COMPLETED
+        assert "All jobs Completed!" in dagman_out
+
+    def test_node_log_was_watched(self, dagman_out):
+        assert "Watching node log" in dagman_out
+
+    def test_events_read_without_waiting_for_scan(self, dagman_out):
+        lags = {}
+        for read_at, node, written_at in EVENT_LINE.findall(dagman_out):
+            lags[node] = (parse_time(read_at) - parse_time(written_at)).total_seconds()
+        logger.info("Seconds from each node's terminate event to DAGMan reading it: {}".format(lags))
+        assert sorted(lags.keys()) == NODES
+        assert all(lag <= MAX_LAG for lag in lags.values())
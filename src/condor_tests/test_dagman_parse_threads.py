@@ -0,0 +1,135 @@
+#!/usr/bin/env pytest
+
+# Check that DAGMan builds the same dependencies from a DAG with thousands
+# of PARENT lines whether it looks their nodes up with several threads or
+# one, and that either way an unknown node name is reported at the file and
+# line where it first appears.
+
+import logging
+import re
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+# comfortably more PARENT lines than it takes to use several threads
+NUM_PAIRS = 2048
+THREADS = 4
+# where the unknown node names go, as indexes into the PARENT lines
+FIRST_BAD = 1500
+SECOND_BAD = 1800
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={
+            "DAGMAN_MAX_SUBMITS_PER_INTERVAL": str(NUM_PAIRS * 4),
+            "DAGMAN_USER_LOG_SCAN_INTERVAL": "1",
+        },
+    ) as condor:
+        yield condor
+
+
+@action(params={"serial": 1, "threaded": THREADS})
+def parse_threads(request):
+    return request.param
+
+
+def write_dag(dag_dir, name, parse_threads, bad_names=False):
+    config = write_file(
+        dag_dir / "{}.config".format(name),
+        "DAGMAN_PARSE_THREADS = {}\n".format(parse_threads),
+    )
+    lines = ["CONFIG {}".format(config), "DOT {}".format(dag_dir / "{}.dot".format(name))]
+    for i in range(NUM_PAIRS):
+        lines.append("JOB P{} noop.sub NOOP".format(i))
+        lines.append("JOB C{} noop.sub NOOP".format(i))
+
+    bad_lines = []
+    for i in range(NUM_PAIRS):
+        parent = "P{}".format(i)
+        if bad_names and i in (FIRST_BAD, SECOND_BAD):
+            parent = "P_missing_{}".format(i)
+            bad_lines.append(len(lines) + 1)
+        # a second child elsewhere in the DAG, so the lines cross-link
+        lines.append(
+            "PARENT {} CHILD C{} C{}".format(parent, i, (i * 7 + 1) % NUM_PAIRS)
+        )
+    dag_file = write_file(dag_dir / "{}.dag".format(name), "\n".join(lines) + "\n")
+    return dag_file, bad_lines
+
+
+def run_dag(condor, dag_file):
+    dag_job = condor.submit(htcondor.Submit.from_dag(str(dag_file)))
+    assert dag_job.wait(condition=ClusterState.all_terminal, timeout=600)
+    return dag_job
+
+
+@action
+def dag_dir(test_dir, parse_threads):
+    return test_dir / "dagman-{}".format(parse_threads)
+
+
+@action
+def good_dag(condor, dag_dir, parse_threads):
+    dag_file, _ = write_dag(dag_dir, "good", parse_threads)
+    dag_job = run_dag(condor, dag_file)
+    return {
+        "job": dag_job,
+        "dagman_out": (dag_dir / "good.dag.dagman.out").read_text(),
+        "arcs": dot_arcs(dag_dir / "good.dot"),
+    }
+
+
+@action
+def bad_dag(condor, dag_dir, parse_threads):
+    dag_file, bad_lines = write_dag(dag_dir, "bad", parse_threads, bad_names=True)
+    run_dag(condor, dag_file)
+    return dag_file, bad_lines, (dag_dir / "bad.dag.dagman.out").read_text()
+
+
+def dot_arcs(dot_file):
+    return sorted(re.findall(r'^\s*"(\S+)" -> "(\S+)";$', dot_file.read_text(), re.MULTILINE))
+
+
+def expected_arcs():
+    arcs = set()
+    for i in range(NUM_PAIRS):
+        arcs.add(("P{}".format(i), "C{}".format(i)))
+        arcs.add(("P{}".format(i), "C{}".format((i * 7 + 1) % NUM_PAIRS)))
+    return sorted(arcs)
+
+
+class TestDagmanParseThreads:
+    def test_dag_completed(self, good_dag):
+        assert good_dag["job"].state[0] == JobStatus.COMPLETED
+        assert "All jobs Completed!" in good_dag["dagman_out"]
+
+    def test_thread_count(self, good_dag, parse_threads):
+        used = re.findall(
+            r"looked up the nodes of \d+ PARENT lines with (\d+) threads",
+            good_dag["dagman_out"],
+        )
+        if parse_threads == 1:
+            assert used == []
+        else:
+            assert used == [str(THREADS)]
+
+    def test_dependencies(self, good_dag):
+        assert good_dag["arcs"] == expected_arcs()
+
+    def test_first_unknown_node_reported(self, bad_dag):
+        dag_file, bad_lines, dagman_out = bad_dag
+        errors = re.findall(
+            r"ERROR: (\S+) \(line (\d+)\): Unknown Job (\S+)", dagman_out
+        )
+        assert len(errors) == 1
+        filename, line, name = errors[0]
+        assert filename.endswith(dag_file.name)
+        assert (int(line), name) == (bad_lines[0], "P_missing_{}".format(FIRST_BAD))
@@ -0,0 +1,157 @@
+#!/usr/bin/env pytest
+
+# Check that condor_history gives the same answers from a columnar history
+# archive as from the plain history file it was converted from, including
+# when a projection and a constraint refer to attributes that are
+# expressions over other attributes.
+
+import logging
+import shutil
+import time
+from pathlib import Path
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_PROCS = 6
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={
+            "NUM_CPUS": "4",
+            "ROTATE_HISTORY_COLUMNAR": "true",
+            "MAX_HISTORY_ROTATIONS": "10",
+        },
+    ) as condor:
+        yield condor
+
+
+def wait_for_history(path, count):
+    # the job leaves the queue, and is written to history, after it completes
+    for _ in range(60):
+        if path.exists():
+            banners = [l for l in path.read_text().splitlines() if l.startswith("*** ")]
+            if len(banners) >= count:
+                return
+        time.sleep(1)
+    assert False, "{} never had {} jobs".format(path, count)
+
+
+@action
+def history_file(condor):
+    return Path(
+        condor.run_command(["condor_config_val", "HISTORY"]).stdout.strip()
+    )
+
+
+@action
+def text_history_file(condor, test_dir, path_to_sleep, history_file):
+    handle = condor.submit(
+        {
+            "executable": path_to_sleep,
+            "arguments": "0",
+            "My.Base": "$(ProcId)",
+            "My.Derived": "Base * 2",
+            "My.Indirect": "Derived + 1",
+        },
+        count=NUM_PROCS,
+    )
+    handle.wait(condition=ClusterState.all_complete, timeout=180)
+    wait_for_history(history_file, NUM_PROCS)
+
+    copy = test_dir / "text_history"
+    shutil.copyfile(str(history_file), str(copy))
+    return copy
+
+
+@action
+def archive_file(condor, path_to_sleep, history_file, text_history_file):
+    # make the next job rotate the history file, which converts it to an archive
+    with condor.config_file.open(mode="a") as f:
+        f.write("\nMAX_HISTORY_LOG = 1\n")
+    condor.run_command(["condor_reconfig", "-schedd"])
+    time.sleep(5)
+
+    handle = condor.submit({"executable": path_to_sleep, "arguments": "0"})
+    handle.wait(condition=ClusterState.all_complete, timeout=180)
+
+    # the conversion is done by a child of the schedd
+    for _ in range(60):
+        archives = list(history_file.parent.glob(history_file.name + ".*.hca"))
+        if archives:
+            return archives[0]
+        time.sleep(1)
+    assert False, "history was never converted to an archive"
+
+
+QUERIES = {
+    "projection-of-expression": (
+        "true",
+        ["ClusterId", "ProcId", "Indirect"],
+    ),
+    "constraint-on-expression": (
+        "Indirect > 5",
+        ["ProcId"],
+    ),
+    "projection-and-constraint-on-expression": (
+        "Derived >= 4 && ProcId < 5",
+        ["ProcId", "Indirect"],
+    ),
+    "request-memory": (
+        "RequestMemory > 0",
+        ["ProcId", "RequestMemory"],
+    ),
+    "literal": (
+        "ProcId == 2",
+        ["ProcId", "Base", "Owner"],
+    ),
+}
+
+
+@action(params=QUERIES)
+def query(request):
+    return request.param
+
+
+def history_output(condor, history, constraint, attrs):
+    cmd = condor.run_command(
+        ["condor_history", "-file", history, "-forwards", "-constraint", constraint, "-af"]
+        + attrs
+    )
+    assert cmd.returncode == 0
+    return cmd.stdout.strip().splitlines()
+
+
+class TestHistoryArchive:
+    def test_plain_file_was_removed(self, archive_file):
+        plain = archive_file.parent / archive_file.stem
+        for _ in range(10):
+            if not plain.exists():
+                break
+            time.sleep(1)
+        assert not plain.exists()
+
+    def test_archive_agrees_with_plain_file(
+        self, condor, archive_file, text_history_file, query
+    ):
+        constraint, attrs = query
+        from_archive = history_output(condor, archive_file, constraint, attrs)
+        from_text = history_output(condor, text_history_file, constraint, attrs)
+        assert from_archive == from_text
+
+    def test_expressions_evaluate_against_unprojected_attributes(
+        self, condor, archive_file
+    ):
+        output = history_output(
+            condor, archive_file, "Derived >= 4", ["ProcId", "Indirect"]
+        )
+        expected = [
+            "{} {}".format(proc, proc * 2 + 1) for proc in range(2, NUM_PROCS)
+        ]
+        assert output == expected
@@ -0,0 +1,142 @@
+#!/usr/bin/env pytest
+
+# Check that condor_history gives the same answers when it uses the
+# sidecar index of a history file as when it scans the whole file.
+
+import logging
+import shutil
+import time
+from pathlib import Path
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_CLUSTERS = 3
+NUM_PROCS = 4
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={"NUM_CPUS": "4", "ENABLE_HISTORY_INDEX": "true"},
+    ) as condor:
+        yield condor
+
+
+@action
+def finished_jobs(condor, path_to_sleep):
+    handles = []
+    for _ in range(NUM_CLUSTERS):
+        handles.append(
+            condor.submit(
+                {"executable": path_to_sleep, "arguments": "0"}, count=NUM_PROCS
+            )
+        )
+    for handle in handles:
+        handle.wait(condition=ClusterState.all_complete, timeout=180)
+    return handles
+
+
+@action
+def history_file(condor, finished_jobs):
+    path = Path(
+        condor.run_command(["condor_config_val", "HISTORY"]).stdout.strip()
+    )
+    # the job leaves the queue, and is written to history, after it completes
+    for _ in range(60):
+        if path.exists() and path.read_text().count("***") >= NUM_CLUSTERS * NUM_PROCS:
+            break
+        time.sleep(1)
+    return path
+
+
+@action
+def index_file(history_file):
+    return history_file.parent / ".{}.idx".format(history_file.name)
+
+
+@action
+def unindexed_history_file(test_dir, history_file):
+    # a copy of the history file has no sidecar index, so condor_history scans it
+    copy = test_dir / "unindexed_history"
+    shutil.copyfile(str(history_file), str(copy))
+    return copy
+
+
+@action
+def first_cluster(finished_jobs):
+    return finished_jobs[0].clusterid
+
+
+CONSTRAINTS = {
+    "cluster": "ClusterId == {first}",
+    "cluster-range": "ClusterId > {first} && ProcId >= 2",
+    "proc-and-other": "ProcId == 1 && JobStatus == 4",
+    "owner": 'Owner =!= undefined && ClusterId != {first}',
+    "completion": "CompletionDate > 0 && ClusterId >= {first}",
+    "no-match": "ClusterId == {first} && ProcId == 99",
+    "unindexed": "JobStatus == 4",
+}
+
+DIRECTIONS = {"backwards": [], "forwards": ["-forwards"]}
+
+
+@action(params=CONSTRAINTS)
+def constraint(request, first_cluster):
+    return request.param.format(first=first_cluster)
+
+
+@action(params=DIRECTIONS)
+def direction(request):
+    return request.param
+
+
+def history_output(condor, history, constraint, direction, extra=[]):
+    cmd = condor.run_command(
+        ["condor_history", "-file", history, "-constraint", constraint]
+        + direction
+        + extra
+        + ["-af", "ClusterId", "ProcId", "Owner", "CompletionDate"]
+    )
+    assert cmd.returncode == 0
+    return cmd.stdout.strip().splitlines()
+
+
+class TestHistoryIndex:
+    def test_index_was_written(self, index_file):
+        assert index_file.exists()
+
+    def test_index_has_every_job(self, index_file):
+        entries = [
+            line for line in index_file.read_text().splitlines()
+            if line and not line.startswith("#")
+        ]
+        assert len(entries) == NUM_CLUSTERS * NUM_PROCS
+
+    def test_index_agrees_with_full_scan(
+        self, condor, history_file, unindexed_history_file, constraint, direction
+    ):
+        indexed = history_output(condor, history_file, constraint, direction)
+        scanned = history_output(condor, unindexed_history_file, constraint, direction)
+        assert indexed == scanned
+
+    def test_index_agrees_with_full_scan_with_limit(
+        self, condor, history_file, unindexed_history_file, constraint, direction
+    ):
+        extra = ["-limit", "3"]
+        indexed = history_output(condor, history_file, constraint, direction, extra)
+        scanned = history_output(condor, unindexed_history_file, constraint, direction, extra)
+        assert indexed == scanned
+
+    def test_since_agrees_with_full_scan(
+        self, condor, history_file, unindexed_history_file, first_cluster
+    ):
+        extra = ["-since", "ClusterId == {}".format(first_cluster)]
+        indexed = history_output(condor, history_file, "true", [], extra)
+        scanned = history_output(condor, unindexed_history_file, "true", [], extra)
+        assert indexed == scanned
+        assert len(indexed) == (NUM_CLUSTERS - 1) * NUM_PROCS
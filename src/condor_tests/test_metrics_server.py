@@ -0,0 +1,130 @@
+#!/usr/bin/env pytest
+
+# Check that the schedd, collector and startd serve their statistics over
+# HTTP when METRICS_PORT is set, that what they serve parses as OpenMetrics
+# text, and that anything but the metrics path is refused.
+
+import logging
+import re
+import socket
+import urllib.error
+import urllib.request
+
+import pytest
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+# one statistic that only each daemon's own pool publishes
+DAEMONS = {
+    "schedd": "condor_schedd_JobsSubmitted",
+    "collector": "condor_collector_MachineAds",
+    "startd": "condor_startd_JobPreemptions",
+}
+
+METRIC_NAME = r"[a-zA-Z_:][a-zA-Z0-9_:]*"
+TYPE_LINE = re.compile(r"^# TYPE ({}) (\w+)$".format(METRIC_NAME))
+SAMPLE_LINE = re.compile(r'^({})(\{{[a-zA-Z_]+="[^"]*"\}})? (\S+)$'.format(METRIC_NAME))
+SAMPLE_SUFFIXES = {
+    "counter": ["_total"],
+    "histogram": ["_bucket", "_count", "_sum"],
+    "summary": ["_count", "_sum"],
+}
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+@standup
+def ports():
+    return {daemon: free_port() for daemon in DAEMONS}
+
+
+@standup
+def condor(test_dir, ports):
+    config = {"NUM_CPUS": "1"}
+    for daemon, port in ports.items():
+        config["{}.METRICS_PORT".format(daemon.upper())] = str(port)
+    with Condor(local_dir=test_dir / "condor", config=config) as condor:
+        yield condor
+
+
+@action(params={daemon: daemon for daemon in DAEMONS})
+def daemon(request):
+    return request.param
+
+
+def fetch(port, path):
+    url = "http://127.0.0.1:{}{}".format(port, path)
+    with urllib.request.urlopen(url, timeout=30) as response:
+        return response.status, response.headers, response.read().decode()
+
+
+@action
+def metrics(condor, ports, daemon):
+    return fetch(ports[daemon], "/metrics")
+
+
+@action
+def metrics_text(metrics):
+    return metrics[2]
+
+
+def parse_openmetrics(text):
+    # returns {family name: (type, [sample lines])}, failing on anything
+    # an OpenMetrics parser would reject in what the daemons serve
+    lines = text.split("\n")
+    assert lines[-2:] == ["# EOF", ""], "must end with a single '# EOF' line"
+    families = {}
+    current = None
+    for line in lines[:-2]:
+        match = TYPE_LINE.match(line)
+        if match:
+            name, kind = match.groups()
+            assert name not in families, "family {} declared twice".format(name)
+            families[name] = (kind, [])
+            current = name
+            continue
+        assert not line.startswith("#"), "unexpected comment {!r}".format(line)
+        match = SAMPLE_LINE.match(line)
+        assert match, "malformed sample {!r}".format(line)
+        name, _, value = match.groups()
+        float(value)
+        assert current is not None, "sample {!r} has no family".format(line)
+        allowed = [current + suffix for suffix in SAMPLE_SUFFIXES.get(families[current][0], [])]
+        if families[current][0] not in SAMPLE_SUFFIXES:
+            allowed.append(current)
+        assert name in allowed, "sample {!r} is not part of family {}".format(line, current)
+        families[current][1].append(line)
+    return families
+
+
+class TestMetricsServer:
+    def test_response_is_openmetrics(self, metrics):
+        status, headers, _ = metrics
+        assert status == 200
+        assert headers["Content-Type"].startswith("application/openmetrics-text")
+
+    def test_metrics_parse(self, metrics_text):
+        families = parse_openmetrics(metrics_text)
+        assert len(families) > 0
+        for name, (_, samples) in families.items():
+            assert len(samples) > 0, "family {} has no samples".format(name)
+
+    def test_metrics_parse_with_prometheus_client(self, metrics_text):
+        parser = pytest.importorskip("prometheus_client.openmetrics.parser")
+        assert len(list(parser.text_string_to_metric_families(metrics_text))) > 0
+
+    def test_daemon_serves_its_own_statistics(self, metrics_text, daemon):
+        assert DAEMONS[daemon] in parse_openmetrics(metrics_text)
+
+    def test_other_paths_are_not_found(self, condor, ports, daemon):
+        with pytest.raises(urllib.error.HTTPError) as error:
+            fetch(ports[daemon], "/nothing-here")
+        assert error.value.code == 404
@@ -0,0 +1,244 @@
+#!/usr/bin/env pytest
+
+# Check that the htcondor.aio front-ends return the same results as the
+# blocking bindings, that several queries can be awaited at once, and that
+# the event loop keeps running while they are in flight.  Two slow schedd
+# queries made at once, from two threads or two coroutines, must overlap
+# rather than wait for each other.
+
+import asyncio
+import logging
+import os
+import threading
+import time
+
+import pytest
+
+import htcondor
+from htcondor import aio
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_PROCS = 20
+PROJECTION = ["ClusterId", "ProcId", "JobStatus"]
+# a slow query should take at least this long, and two at once well under twice it
+MIN_SLOW_QUERY_SECONDS = 1.0
+OVERLAP_FACTOR = 1.6
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={"NUM_CPUS": "2", "NUM_SLOTS": "2", "SCHEDD_QUERY_WORKERS": "4"},
+    ) as condor:
+        yield condor
+
+
+@action
+def held_jobs(condor, path_to_sleep):
+    return condor.submit(
+        {"executable": path_to_sleep, "arguments": "0", "hold": "true"},
+        count=NUM_PROCS,
+    )
+
+
+@action
+def schedd(condor, held_jobs):
+    return condor.get_local_schedd()
+
+
+@action
+def collector(condor):
+    return condor.get_local_collector()
+
+
+@action
+def job_constraint(held_jobs):
+    return "ClusterId == {}".format(held_jobs.clusterid)
+
+
+def job_ids(ads):
+    return sorted((ad["ClusterId"], ad["ProcId"]) for ad in ads)
+
+
+@action
+def blocking_jobs(schedd, job_constraint):
+    return job_ids(schedd.query(job_constraint, PROJECTION))
+
+
+@action
+def async_query_jobs(schedd, job_constraint):
+    async def run():
+        return await aio.AsyncSchedd(schedd).query(job_constraint, PROJECTION)
+
+    return job_ids(asyncio.run(run()))
+
+
+@action
+def async_xquery_jobs(schedd, job_constraint):
+    async def run():
+        return [
+            ad async for ad in aio.AsyncSchedd(schedd).xquery(job_constraint, PROJECTION)
+        ]
+
+    return job_ids(asyncio.run(run()))
+
+
+@action
+def concurrent_queries(schedd, job_constraint):
+    # count how often the event loop got to run while the queries were out
+    async def run():
+        ticks = 0
+        stop = asyncio.Event()
+
+        async def ticker():
+            nonlocal ticks
+            while not stop.is_set():
+                ticks += 1
+                await asyncio.sleep(0)
+
+        tick_task = asyncio.ensure_future(ticker())
+        async_schedd = aio.AsyncSchedd(schedd)
+        results = await asyncio.gather(
+            *[async_schedd.query(job_constraint, PROJECTION) for _ in range(5)]
+        )
+        stop.set()
+        await tick_task
+        return results, ticks
+
+    return asyncio.run(run())
+
+
+@action
+def big_job(condor, path_to_sleep):
+    # splitting this attribute is what makes a query slow
+    return condor.submit(
+        {
+            "executable": path_to_sleep,
+            "arguments": "0",
+            "hold": "true",
+            "My.Big": '"{}"'.format("word " * 50000),
+        }
+    )
+
+
+def slow_constraint(big_job, repeats):
+    # evaluated by the schedd's query worker; never true, so no ads come
+    # back until the worker has looked at every job
+    return "ClusterId == {} && {} < 0".format(
+        big_job.clusterid, " + ".join(["size(split(Big))"] * repeats)
+    )
+
+
+def timed(func, *args):
+    start = time.monotonic()
+    func(*args)
+    return time.monotonic() - start
+
+
+@action
+def slow_query(schedd, big_job):
+    # make the query slow enough that two at once can be told from two in turn
+    repeats = 8
+    while True:
+        constraint = slow_constraint(big_job, repeats)
+        seconds = timed(schedd.query, constraint, ["ProcId"])
+        if seconds >= MIN_SLOW_QUERY_SECONDS or repeats >= 4096:
+            break
+        repeats *= 2
+    logger.info("One query with {} splits took {:.2f}s".format(repeats, seconds))
+    assert seconds >= MIN_SLOW_QUERY_SECONDS
+    return constraint, seconds
+
+
+@action
+def threaded_slow_queries(schedd, slow_query):
+    constraint, _ = slow_query
+    errors = []
+
+    def run():
+        try:
+            schedd.query(constraint, ["ProcId"])
+        except Exception as e:
+            errors.append(e)
+
+    def both():
+        threads = [threading.Thread(target=run) for _ in range(2)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+    seconds = timed(both)
+    logger.info("Two queries from two threads took {:.2f}s".format(seconds))
+    return seconds, errors
+
+
+@action
+def async_slow_queries(schedd, slow_query):
+    constraint, _ = slow_query
+
+    async def run():
+        async_schedd = aio.AsyncSchedd(schedd)
+        await asyncio.gather(
+            *[async_schedd.query(constraint, ["ProcId"]) for _ in range(2)]
+        )
+
+    seconds = timed(asyncio.run, run())
+    logger.info("Two queries from two coroutines took {:.2f}s".format(seconds))
+    return seconds
+
+
+@action
+def async_slots(collector):
+    async def run():
+        return await aio.AsyncCollector(collector).query(
+            htcondor.AdTypes.Startd, "true", ["Name"]
+        )
+
+    return sorted(ad["Name"] for ad in asyncio.run(run()))
+
+
+class TestPythonBindingsAio:
+    def test_query_matches_blocking_query(self, blocking_jobs, async_query_jobs):
+        assert len(blocking_jobs) == NUM_PROCS
+        assert async_query_jobs == blocking_jobs
+
+    def test_xquery_matches_blocking_query(self, blocking_jobs, async_xquery_jobs):
+        assert async_xquery_jobs == blocking_jobs
+
+    def test_concurrent_queries_all_complete(self, blocking_jobs, concurrent_queries):
+        results, _ = concurrent_queries
+        assert [job_ids(ads) for ads in results] == [blocking_jobs] * 5
+
+    def test_event_loop_ran_during_queries(self, concurrent_queries):
+        _, ticks = concurrent_queries
+        assert ticks > 0
+
+    @pytest.mark.skipif(
+        (os.cpu_count() or 1) < 2, reason="the schedd needs two CPUs for two queries"
+    )
+    def test_threaded_slow_queries_overlap(self, slow_query, threaded_slow_queries):
+        _, one = slow_query
+        two, errors = threaded_slow_queries
+        assert errors == []
+        assert two < OVERLAP_FACTOR * one
+
+    @pytest.mark.skipif(
+        (os.cpu_count() or 1) < 2, reason="the schedd needs two CPUs for two queries"
+    )
+    def test_async_slow_queries_overlap(self, slow_query, async_slow_queries):
+        _, one = slow_query
+        assert async_slow_queries < OVERLAP_FACTOR * one
+
+    def test_collector_query_matches_blocking_query(self, collector, async_slots):
+        blocking = sorted(
+            ad["Name"] for ad in collector.query(htcondor.AdTypes.Startd, "true", ["Name"])
+        )
+        assert len(blocking) == 2
+        assert async_slots == blocking
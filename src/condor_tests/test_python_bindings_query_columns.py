@@ -0,0 +1,157 @@
+#!/usr/bin/env pytest
+
+# Check that Schedd.query_columns() and Collector.query_columns() return the
+# same ads as query(), one column per attribute, with each value evaluated
+# in its ad rather than returned as an expression.  Numeric columns come back
+# as array.array objects, with NaN for missing values, and the rest as lists.
+
+import array
+import logging
+import math
+
+import pytest
+
+import classad
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_PROCS = 4
+JOB_ATTRS = ["ProcId", "Base", "Doubled", "Half", "Label", "NotThere"]
+SLOT_ATTRS = ["Name", "Cpus", "Memory", "SlotID", "NotThere"]
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={"NUM_CPUS": "2", "NUM_SLOTS": "2"},
+    ) as condor:
+        yield condor
+
+
+@action
+def held_jobs(condor, path_to_sleep):
+    return condor.submit(
+        {
+            "executable": path_to_sleep,
+            "arguments": "0",
+            "hold": "true",
+            "My.Base": "$(ProcId)",
+            "My.Doubled": "Base * 2",
+            "My.Half": "Base / 2.0",
+            "My.Label": '"proc $(ProcId)"',
+            "My.Sometimes": "ifThenElse(ProcId == 0, undefined, ProcId)",
+        },
+        count=NUM_PROCS,
+    )
+
+
+@action
+def job_constraint(held_jobs):
+    return "ClusterId == {}".format(held_jobs.clusterid)
+
+
+@action
+def job_columns(condor, job_constraint):
+    return condor.get_local_schedd().query_columns(job_constraint, JOB_ATTRS)
+
+
+@action
+def sometimes_columns(condor, job_constraint):
+    return condor.get_local_schedd().query_columns(
+        job_constraint, ["ProcId", "Sometimes"]
+    )
+
+
+@action
+def job_ads(condor, job_constraint):
+    return condor.get_local_schedd().query(job_constraint, JOB_ATTRS)
+
+
+@action
+def slot_columns(condor):
+    return condor.get_local_collector().query_columns(
+        htcondor.AdTypes.Startd, "true", SLOT_ATTRS
+    )
+
+
+@action
+def slot_ads(condor):
+    return condor.get_local_collector().query(
+        htcondor.AdTypes.Startd, "true", SLOT_ATTRS
+    )
+
+
+def evaluated_rows(ads, attrs):
+    rows = []
+    for ad in ads:
+        row = []
+        for attr in attrs:
+            value = ad.eval(attr) if attr in ad else None
+            row.append(None if value is classad.Value.Undefined else value)
+        rows.append(tuple(row))
+    return sorted(rows, key=repr)
+
+
+def column_rows(columns, attrs):
+    return sorted(zip(*[columns[attr] for attr in attrs]), key=repr)
+
+
+def typecode(column):
+    return column.typecode if isinstance(column, array.array) else None
+
+
+class TestQueryColumns:
+    def test_job_columns_are_the_projection(self, job_columns):
+        assert sorted(job_columns.keys()) == sorted(JOB_ATTRS)
+        for attr in JOB_ATTRS:
+            assert len(job_columns[attr]) == NUM_PROCS
+
+    def test_job_columns_match_query(self, job_columns, job_ads):
+        assert column_rows(job_columns, JOB_ATTRS) == evaluated_rows(job_ads, JOB_ATTRS)
+
+    def test_job_expressions_are_evaluated(self, job_columns, job_ads):
+        # query() hands back the expression; query_columns() its value
+        assert all(isinstance(ad["Doubled"], classad.ExprTree) for ad in job_ads)
+        rows = column_rows(job_columns, ["ProcId", "Doubled", "Label"])
+        assert rows == [
+            (proc, proc * 2, "proc {}".format(proc)) for proc in range(NUM_PROCS)
+        ]
+
+    def test_numeric_columns_are_arrays(self, job_columns, slot_columns):
+        assert {attr: typecode(job_columns[attr]) for attr in JOB_ATTRS} == {
+            "ProcId": "q",
+            "Base": "q",
+            "Doubled": "q",
+            "Half": "d",
+            "Label": None,
+            "NotThere": None,
+        }
+        assert memoryview(job_columns["ProcId"]).format == "q"
+        assert memoryview(job_columns["Half"]).format == "d"
+        for attr in ["Cpus", "Memory", "SlotID"]:
+            assert typecode(slot_columns[attr]) == "q"
+        assert typecode(slot_columns["Name"]) is None
+
+    def test_missing_number_is_nan(self, sometimes_columns):
+        # an integer column with a missing value can only be held as doubles
+        assert typecode(sometimes_columns["Sometimes"]) == "d"
+        values = dict(zip(sometimes_columns["ProcId"], sometimes_columns["Sometimes"]))
+        assert math.isnan(values.pop(0))
+        assert values == {proc: float(proc) for proc in range(1, NUM_PROCS)}
+
+    def test_missing_attribute_is_none(self, job_columns):
+        assert job_columns["NotThere"] == [None] * NUM_PROCS
+
+    def test_slot_columns_match_query(self, slot_columns, slot_ads):
+        assert len(slot_ads) == 2
+        assert column_rows(slot_columns, SLOT_ATTRS) == evaluated_rows(slot_ads, SLOT_ATTRS)
+
+    def test_empty_projection_is_an_error(self, condor):
+        with pytest.raises(htcondor.HTCondorValueError):
+            condor.get_local_schedd().query_columns("true", [])
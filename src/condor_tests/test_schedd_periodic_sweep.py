@@ -0,0 +1,101 @@
+#!/usr/bin/env pytest
+
+# Check that the schedd applies PERIODIC_HOLD, PERIODIC_RELEASE and
+# PERIODIC_REMOVE to every job in a large queue both when it evaluates
+# them in one pass and when it evaluates them a slice at a time, going
+# back to handling commands in between slices.  Jobs the sweep removes
+# while it is partway through the queue must not upset the rest of it.
+
+import logging
+import re
+import time
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_JOBS = 1000
+SLICES_LINE = re.compile(r"Evaluated periodic expressions for (\d+) jobs in (\d+) slices")
+
+
+@action(params={"one-pass": 0, "sliced": 1})
+def yield_interval(request):
+    return request.param
+
+
+@action
+def condor(test_dir, yield_interval):
+    with Condor(
+        local_dir=test_dir / "condor-yield-{}".format(yield_interval),
+        config={
+            "PERIODIC_EXPR_INTERVAL": "1",
+            "PERIODIC_EXPR_YIELD_INTERVAL": str(yield_interval),
+            "SCHEDD_DEBUG": "D_FULLDEBUG",
+        },
+    ) as condor:
+        yield condor
+
+
+@action
+def clusters(condor, path_to_sleep):
+    # none of these jobs can match, so only the policy changes their state
+    common = {"executable": path_to_sleep, "arguments": "0", "requirements": "false"}
+    handles = {
+        "release": condor.submit(
+            dict(common, hold="true", periodic_release="true"), count=NUM_JOBS
+        ),
+        "hold": condor.submit(dict(common, periodic_hold="true"), count=NUM_JOBS),
+        "remove": condor.submit(dict(common, periodic_remove="true"), count=NUM_JOBS),
+    }
+
+    assert handles["release"].wait(
+        condition=lambda state: state.all_status(JobStatus.IDLE)
+        and state.count_status(JobStatus.HELD) == 0,
+        timeout=180,
+    )
+    assert handles["hold"].wait(condition=ClusterState.all_held, timeout=180)
+    assert handles["remove"].wait(
+        condition=lambda state: state.all_status(JobStatus.REMOVED), timeout=180
+    )
+    return handles
+
+
+@action
+def sweeps(condor, clusters):
+    return [
+        (int(jobs), int(slices))
+        for jobs, slices in SLICES_LINE.findall(condor.schedd_log.path.read_text())
+    ]
+
+
+class TestScheddPeriodicSweep:
+    def test_every_held_job_released(self, clusters):
+        released = clusters["release"].event_log.filter(
+            lambda e: e.type == htcondor.JobEventType.JOB_RELEASED
+        )
+        assert sorted(e.proc for e in released) == list(range(NUM_JOBS))
+
+    def test_held_for_policy(self, clusters):
+        ads = clusters["hold"].query(projection=["HoldReasonCode"])
+        assert len(ads) == NUM_JOBS
+        # 3 is JobPolicy
+        assert all(ad["HoldReasonCode"] == 3 for ad in ads)
+
+    def test_removed_jobs_left_the_queue(self, clusters):
+        for _ in range(60):
+            if len(clusters["remove"].query(projection=["ProcId"])) == 0:
+                break
+            time.sleep(1)
+        assert len(clusters["remove"].query(projection=["ProcId"])) == 0
+
+    def test_sweep_was_sliced(self, sweeps, yield_interval):
+        logger.info("Periodic sweeps (jobs, slices): {}".format(sweeps))
+        if yield_interval == 0:
+            assert sweeps == []
+        else:
+            assert len(sweeps) > 0
+            assert max(slices for _, slices in sweeps) > 1
@@ -0,0 +1,96 @@
+#!/usr/bin/env pytest
+
+# Check that when the schedd reuses a claim, it picks the next job of the
+# claim's own submitter, in priority order, even when another submitter
+# has runnable jobs of higher priority in the queue.  With a single slot,
+# each submitter's jobs should therefore run back to back, highest
+# priority first.
+
+import logging
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_JOBS = 5
+SUBMITTERS = ["alice", "bob"]
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={
+            "NUM_CPUS": "1",
+            "NUM_SLOTS": "1",
+            "NEGOTIATOR_CONSIDER_PREEMPTION": "False",
+            "CLAIM_WORKLIFE": "-1",
+        },
+    ) as condor:
+        yield condor
+
+
+@standup
+def job_log(test_dir):
+    return test_dir / "jobs.log"
+
+
+@standup
+def clusters(condor, path_to_sleep, job_log):
+    handles = {}
+    for i, user in enumerate(SUBMITTERS):
+        handles[user] = condor.submit(
+            {
+                "executable": path_to_sleep,
+                "arguments": "1",
+                "log": str(job_log),
+                "hold": "true",
+                "accounting_group": "group_test",
+                "accounting_group_user": user,
+                # alice's jobs get priorities 0-4 and bob's 10-14, so
+                # bob's all outrank alice's
+                "priority": "{}$(ProcId)".format(i if i else ""),
+            },
+            count=NUM_JOBS,
+        )
+
+    # let both submitters' jobs be runnable from the same moment
+    for handle in handles.values():
+        handle.release()
+    for handle in handles.values():
+        assert handle.wait(condition=ClusterState.all_complete, timeout=300)
+    return handles
+
+
+@standup
+def execute_order(clusters, job_log):
+    users = {handle.clusterid: user for user, handle in clusters.items()}
+    order = []
+    for event in htcondor.JobEventLog(str(job_log)).events(stop_after=0):
+        if event.type == htcondor.JobEventType.EXECUTE:
+            order.append((users[event.cluster], event.proc))
+    logger.info("Jobs ran in the order {}".format(order))
+    return order
+
+
+class TestScheddSubmitterIndex:
+    def test_every_job_ran_once(self, execute_order):
+        assert sorted(execute_order) == sorted(
+            (user, proc) for user in SUBMITTERS for proc in range(NUM_JOBS)
+        )
+
+    def test_claim_reused_for_same_submitter(self, execute_order):
+        first = [user for user, _ in execute_order[:NUM_JOBS]]
+        second = [user for user, _ in execute_order[NUM_JOBS:]]
+        assert len(set(first)) == 1
+        assert len(set(second)) == 1
+        assert first[0] != second[0]
+
+    def test_each_submitter_in_priority_order(self, execute_order):
+        for user in SUBMITTERS:
+            procs = [proc for u, proc in execute_order if u == user]
+            assert procs == sorted(procs, reverse=True)
@@ -0,0 +1,174 @@
+#!/usr/bin/env pytest
+
+# Measure the resident memory and CPU time each condor_shadow costs per
+# running job, with and without SHADOW_MEMORY_TRIM_DELAY, and check that
+# each shadow trims its heap once it has started its job.  The numbers,
+# including the resident size before and after each trim, are logged so
+# that changes to the shadow can be compared against them; how much a trim
+# gives back depends on the heap, so it is not checked.  The jobs must
+# also still complete, since
+# every remote system call now goes through the shadow that owns the
+# remote resource rather than the process-wide one.
+
+import logging
+import os
+import re
+import time
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_JOBS = 8
+TRIM_DELAY = 5
+# long enough to measure the shadows once they have all trimmed
+JOB_DURATION = 60
+CPU_SAMPLE_SECONDS = 10
+
+TRIM_LINE = re.compile(r"Trimmed heap memory: resident size went from (\d+) KiB to (\d+) KiB")
+
+
+@action(params={"trim": TRIM_DELAY, "no-trim": 0})
+def trim_delay(request):
+    return request.param
+
+
+@action
+def condor(test_dir, trim_delay):
+    with Condor(
+        local_dir=test_dir / "condor-trim-{}".format(trim_delay),
+        config={
+            "NUM_CPUS": str(NUM_JOBS),
+            "NUM_SLOTS": str(NUM_JOBS),
+            "SHADOW_MEMORY_TRIM_DELAY": str(trim_delay),
+        },
+    ) as condor:
+        yield condor
+
+
+def children(pid):
+    found = []
+    for entry in os.listdir("/proc"):
+        if not entry.isdigit():
+            continue
+        try:
+            with open("/proc/{}/stat".format(entry)) as f:
+                stat = f.read()
+        except OSError:
+            continue
+        # the command name is in parentheses and may contain spaces
+        fields = stat[stat.rindex(")") + 2 :].split()
+        if int(fields[1]) == pid:
+            found.append(int(entry))
+    return found
+
+
+def descendants(pid):
+    found = []
+    for child in children(pid):
+        found.append(child)
+        found += descendants(child)
+    return found
+
+
+def shadow_pids(condor):
+    pids = []
+    for pid in descendants(condor.condor_master.pid):
+        try:
+            with open("/proc/{}/comm".format(pid)) as f:
+                if f.read().strip() == "condor_shadow":
+                    pids.append(pid)
+        except OSError:
+            pass
+    return pids
+
+
+def rss_kib(pid):
+    with open("/proc/{}/status".format(pid)) as f:
+        for line in f:
+            if line.startswith("VmRSS:"):
+                return int(line.split()[1])
+    return 0
+
+
+def cpu_seconds(pid):
+    with open("/proc/{}/stat".format(pid)) as f:
+        stat = f.read()
+    fields = stat[stat.rindex(")") + 2 :].split()
+    # utime and stime are the 14th and 15th fields of the whole line
+    return (int(fields[11]) + int(fields[12])) / os.sysconf("SC_CLK_TCK")
+
+
+def trim_lines(condor):
+    if not condor.shadow_log.path.exists():
+        return []
+    return TRIM_LINE.findall(condor.shadow_log.path.read_text())
+
+
+@action
+def running_jobs(condor, path_to_sleep, trim_delay):
+    handle = condor.submit(
+        {"executable": path_to_sleep, "arguments": str(JOB_DURATION)},
+        count=NUM_JOBS,
+    )
+    assert handle.wait(condition=ClusterState.all_running, timeout=120)
+
+    # give every shadow time to settle (and to trim, if it's going to)
+    deadline = time.time() + TRIM_DELAY * 4
+    while time.time() < deadline:
+        if trim_delay and len(trim_lines(condor)) >= NUM_JOBS:
+            break
+        time.sleep(1)
+    return handle
+
+
+@action
+def shadow_usage(condor, running_jobs, trim_delay):
+    pids = shadow_pids(condor)
+    assert len(pids) == NUM_JOBS
+
+    start = {pid: cpu_seconds(pid) for pid in pids}
+    time.sleep(CPU_SAMPLE_SECONDS)
+    usage = {
+        "rss_kib": sum(rss_kib(pid) for pid in pids) / len(pids),
+        "cpu_seconds": sum(cpu_seconds(pid) for pid in pids) / len(pids),
+        "idle_cpu_percent": 100
+        * sum(cpu_seconds(pid) - start[pid] for pid in pids)
+        / len(pids)
+        / CPU_SAMPLE_SECONDS,
+    }
+    logger.info(
+        "SHADOW_MEMORY_TRIM_DELAY={}: per running job, the shadow uses {:.0f} KiB "
+        "resident, {:.2f} s of CPU so far and {:.3f}% CPU while idle".format(
+            trim_delay, usage["rss_kib"], usage["cpu_seconds"], usage["idle_cpu_percent"]
+        )
+    )
+    return usage
+
+
+@action
+def completed_jobs(running_jobs, shadow_usage):
+    assert running_jobs.wait(condition=ClusterState.all_complete, timeout=JOB_DURATION * 4)
+    return running_jobs
+
+
+class TestShadowMemory:
+    def test_one_shadow_per_running_job(self, shadow_usage):
+        assert shadow_usage["rss_kib"] > 0
+
+    def test_each_shadow_trims(self, condor, shadow_usage, trim_delay):
+        trims = [(int(before), int(after)) for before, after in trim_lines(condor)]
+        if not trim_delay:
+            assert trims == []
+            return
+        assert len(trims) >= NUM_JOBS
+        logger.info(
+            "Resident size of the shadows before trimming {} KiB, after {} KiB".format(
+                sum(before for before, _ in trims), sum(after for _, after in trims)
+            )
+        )
+
+    def test_jobs_complete(self, completed_jobs):
+        assert completed_jobs.state.all_complete()
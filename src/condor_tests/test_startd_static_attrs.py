@@ -0,0 +1,170 @@
+#!/usr/bin/env pytest
+
+# The startd builds the configuration-derived part of each slot ad once and
+# reuses it until the next reconfig.  Check that a changed STARTD_ATTRS value
+# shows up in the slot ads after condor_reconfig, both in the partitionable
+# slot and in a dynamic slot that already exists, and that dynamic slots
+# carved out after startup (before and after the reconfig) publish the same
+# static attributes as their partitionable slot, along with their own
+# resources.
+
+import logging
+import time
+
+import htcondor
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_CPUS = 4
+# attributes a dynamic slot should share with its partitionable slot
+SHARED_ATTRS = [
+    "Arch",
+    "OpSys",
+    "Machine",
+    "MyAddress",
+    "CondorVersion",
+    "TotalCpus",
+    "TotalMemory",
+    "TestStaticAttr",
+]
+
+
+@standup
+def condor(test_dir):
+    with Condor(
+        local_dir=test_dir / "condor",
+        config={
+            "NUM_CPUS": str(NUM_CPUS),
+            "SLOT_TYPE_1": "cpus=100%,memory=100%,disk=100%",
+            "SLOT_TYPE_1_PARTITIONABLE": "True",
+            "NUM_SLOTS_TYPE_1": "1",
+            "STARTD_ATTRS": "TestStaticAttr",
+            "TestStaticAttr": '"before"',
+            "UPDATE_INTERVAL": "5",
+        },
+    ) as condor:
+        yield condor
+
+
+def slot_ads(condor, constraint):
+    return condor.get_local_collector().query(htcondor.AdTypes.Startd, constraint)
+
+
+def wait_for(condition, timeout=60, interval=2):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        result = condition()
+        if result:
+            return result
+        time.sleep(interval)
+    return condition()
+
+
+def submit_sleeper(condor, path_to_sleep):
+    handle = condor.submit(
+        {
+            "executable": path_to_sleep,
+            "arguments": "600",
+            "request_cpus": "1",
+            "request_memory": "64",
+            "request_disk": "1024",
+        }
+    )
+    assert handle.wait(condition=ClusterState.all_running, timeout=120)
+    return handle
+
+
+def dynamic_slot_of(condor, handle):
+    # the dynamic slot running the given job, once the collector has it
+    job_id = "{}.0".format(handle.clusterid)
+
+    def find():
+        ads = slot_ads(condor, 'DynamicSlot && JobId == "{}"'.format(job_id))
+        return ads[0] if ads else None
+
+    return wait_for(find)
+
+
+def pslot_with_cpus(condor, cpus):
+    # the partitionable slot, once the collector has its remaining cpus
+    def find():
+        ads = slot_ads(condor, "PartitionableSlot && Cpus == {}".format(cpus))
+        return ads[0] if ads else None
+
+    return wait_for(find)
+
+
+@standup
+def pslot_at_startup(condor):
+    ads = wait_for(lambda: slot_ads(condor, "PartitionableSlot"))
+    assert len(ads) == 1
+    return ads[0]
+
+
+@standup
+def first_job(condor, path_to_sleep, pslot_at_startup):
+    return submit_sleeper(condor, path_to_sleep)
+
+
+@standup
+def first_dslot(condor, first_job):
+    return dynamic_slot_of(condor, first_job)
+
+
+@standup
+def reconfigured(condor, first_dslot):
+    with condor.config_file.open(mode="a") as f:
+        f.write('\nTestStaticAttr = "after"\n')
+    condor.run_command(["condor_reconfig", "-startd"])
+
+    def updated(constraint):
+        ads = slot_ads(condor, constraint)
+        return ads if ads and all(ad.get("TestStaticAttr") == "after" for ad in ads) else None
+
+    return {
+        "pslot": wait_for(lambda: updated("PartitionableSlot")),
+        "first_dslot": wait_for(
+            lambda: updated('DynamicSlot && JobId == "{}"'.format(first_dslot["JobId"]))
+        ),
+    }
+
+
+@standup
+def second_dslot(condor, path_to_sleep, reconfigured):
+    return dynamic_slot_of(condor, submit_sleeper(condor, path_to_sleep))
+
+
+class TestStartdStaticAttrs:
+    def test_startd_attrs_at_startup(self, pslot_at_startup):
+        assert pslot_at_startup["TestStaticAttr"] == "before"
+        assert pslot_at_startup["Cpus"] == NUM_CPUS
+
+    def test_dynamic_slot_after_startup(self, condor, first_dslot):
+        assert first_dslot is not None
+        assert first_dslot["TestStaticAttr"] == "before"
+        assert first_dslot["Cpus"] == 1
+        assert first_dslot["Memory"] >= 64
+        # the partitionable slot's resources change at run time
+        pslot = pslot_with_cpus(condor, NUM_CPUS - 1)
+        assert pslot is not None
+        for attr in SHARED_ATTRS:
+            assert first_dslot[attr] == pslot[attr], attr
+
+    def test_reconfig_updates_pslot(self, reconfigured):
+        assert reconfigured["pslot"] is not None
+
+    def test_reconfig_updates_existing_dynamic_slot(self, reconfigured):
+        assert reconfigured["first_dslot"] is not None
+
+    def test_dynamic_slot_after_reconfig(self, condor, second_dslot):
+        assert second_dslot is not None
+        assert second_dslot["TestStaticAttr"] == "after"
+        assert second_dslot["Cpus"] == 1
+        pslot = pslot_with_cpus(condor, NUM_CPUS - 2)
+        assert pslot is not None
+        for attr in SHARED_ATTRS:
+            assert second_dslot[attr] == pslot[attr], attr
@@ -0,0 +1,119 @@
+#!/usr/bin/env pytest
+
+# Check that jobs submitted with one CONDOR_SetJobAttributes message per ad
+# end up with the same attributes as jobs submitted with one SetAttribute
+# message per attribute, and that a rejected attribute is still named in
+# the error condor_submit prints.
+
+import logging
+
+from ornithology import *
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+NUM_PROCS = 3
+NUM_ATTRS = 200
+
+
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", config={"NUM_CPUS": "1"}) as condor:
+        yield condor
+
+
+@action
+def submit_file(test_dir, path_to_sleep):
+    lines = [
+        "executable = {}".format(path_to_sleep),
+        "arguments = 0",
+        "hold = true",
+        "My.PerProc = $(ProcId) * 10",
+    ]
+    lines += ['My.Bulk{0} = "value {0}"'.format(i) for i in range(NUM_ATTRS)]
+    lines.append("queue {}".format(NUM_PROCS))
+    return write_file(test_dir / "bulk.sub", "\n".join(lines) + "\n")
+
+
+def submit(condor, submit_file, bulk, noack=True, extra=[]):
+    env = {
+        "_CONDOR_SUBMIT_BULK_SET_ATTRIBUTES": "true" if bulk else "false",
+        "_CONDOR_SUBMIT_NOACK_ON_SETATTRIBUTE": "true" if noack else "false",
+    }
+    with SetEnv(env):
+        return condor.run_command(["condor_submit", submit_file] + extra)
+
+
+def job_attributes(condor, clusterid):
+    # everything but the attributes that differ from one cluster to the next
+    skip = {
+        "ClusterId",
+        "GlobalJobId",
+        "QDate",
+        "EnteredCurrentStatus",
+        "ServerTime",
+        "AutoClusterId",
+        "AutoClusterAttrs",
+    }
+    cmd = condor.run_command(["condor_q", str(clusterid), "-long"])
+    assert cmd.returncode == 0
+    jobs = []
+    for block in cmd.stdout.strip().split("\n\n"):
+        attrs = {}
+        for line in block.splitlines():
+            name, _, value = line.partition(" = ")
+            if name not in skip:
+                attrs[name] = value
+        jobs.append(attrs)
+    return sorted(jobs, key=lambda attrs: int(attrs["ProcId"]))
+
+
+@action(params={"bulk": True, "one-at-a-time": False})
+def bulk(request):
+    return request.param
+
+
+@action
+def submitted_jobs(condor, submit_file, bulk):
+    cmd = submit(condor, submit_file, bulk)
+    assert cmd.returncode == 0
+    clusterid, num_procs = parse_submit_result(cmd)
+    assert num_procs == NUM_PROCS
+    return job_attributes(condor, clusterid)
+
+
+@action
+def reference_jobs(condor, submit_file):
+    cmd = submit(condor, submit_file, False)
+    assert cmd.returncode == 0
+    clusterid, _ = parse_submit_result(cmd)
+    return job_attributes(condor, clusterid)
+
+
+@action
+def rejected_submit(condor, submit_file, bulk):
+    # the schedd never lets the owner be set to root
+    return submit(
+        condor, submit_file, bulk, noack=False, extra=["-append", 'My.Owner = "root"']
+    )
+
+
+class TestSubmitBulkAttributes:
+    def test_every_attribute_arrived(self, submitted_jobs):
+        assert len(submitted_jobs) == NUM_PROCS
+        for job in submitted_jobs:
+            for i in range(NUM_ATTRS):
+                assert job["Bulk{}".format(i)] == '"value {}"'.format(i)
+
+    def test_proc_attributes_arrived(self, submitted_jobs):
+        for proc, job in enumerate(submitted_jobs):
+            assert job["ProcId"] == str(proc)
+            assert job["PerProc"] == "{} * 10".format(proc)
+
+    def test_same_ads_as_one_attribute_at_a_time(self, submitted_jobs, reference_jobs):
+        assert submitted_jobs == reference_jobs
+
+    def test_rejected_attribute_is_named(self, rejected_submit):
+        assert rejected_submit.returncode != 0
+        assert 'Failed to set Owner="root"' in rejected_submit.stderr
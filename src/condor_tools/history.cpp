@@ -46,7 +46,11 @@
 #include "classad_helpers.h" // for initStringListFromAttrs
 #include "history_utils.h"
 #include "backward_file_reader.h"
+#include "classadHistory.h" // for the history index
+#include "history_archive.h"
+#include "condor_blkng_full_disk_io.h"
 #include <fcntl.h>  // for O_BINARY
+#include <algorithm>
 
 void Usage(const char* name, int iExitCode=1);
 
@@ -111,7 +115,11 @@ static void readHistoryRemote(classad::ExprTree *constraintExpr, bool want_start
 static void readHistoryFromFiles(bool fileisuserlog, const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr);
 static void readHistoryFromFileOld(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr);
 static void readHistoryFromFileEx(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards);
+static bool readHistoryFromIndex(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards);
+static void readHistoryFromArchive(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards);
+static void setupHistoryPushdown(ExprTree *constraintExpr);
 static void printJobAds(ClassAdList & jobs);
+static void printJobIfConstraint(ClassAd & ad, const char* constraint, ExprTree *constraintExpr);
 static void printJob(ClassAd & ad);
 
 static int set_print_mask_from_stream(AttrListPrintMask & print_mask, std::string & constraint, StringList & attrs, const char * streamid, bool is_filename);
@@ -149,6 +157,15 @@ static StringList projection;
 static classad::References whitelist;
 static ExprTree *sinceExpr = NULL;
 static bool want_startd_history = false;
+// top level && terms of the constraint and since expressions
+static std::vector<ExprTree*> constraintConjuncts;
+static std::vector<ExprTree*> sinceConjuncts;
+// terms of the constraint that can be evaluated against the history index
+static std::vector<ExprTree*> indexConjuncts;
+static bool sinceIsIndexed = false;
+// attributes needed from a columnar history archive, when archiveAllColumns is false
+static classad::References archiveColumns;
+static bool archiveAllColumns = true;
 
 int getInheritedSocks(Stream* socks[], size_t cMaxSocks, pid_t & ppid)
 {
@@ -562,6 +579,7 @@ main(int argc, const char* argv[])
   }
 
   if(readfromfile == true) {
+		setupHistoryPushdown(constraintExpr);
 		// some output methods use a whitelist rather than a stringlist projection.
 		for (const char * attr = projection.first(); attr != NULL; attr = projection.next()) {
 			whitelist.insert(attr);
@@ -1370,6 +1388,11 @@ static void printJobIfConstraint(std::vector<std::string> & exprs, const char* c
 		}
 		exprs.pop_back();
 	}
+	printJobIfConstraint(ad, constraint, constraintExpr);
+}
+
+static void printJobIfConstraint(ClassAd & ad, const char* constraint, ExprTree *constraintExpr)
+{
 	++adCount;
 
 	if (sinceExpr && EvalExprBool(&ad, sinceExpr)) {
@@ -1402,6 +1425,18 @@ static void readHistoryFromFileEx(const char *JobHistoryFileName, const char* co
 		return;
 	}
 
+	// rotated history files may have been converted to columnar archives
+	if (IsHistoryArchive(JobHistoryFileName)) {
+		readHistoryFromArchive(JobHistoryFileName, constraint, constraintExpr, read_backwards);
+		return;
+	}
+
+	// if the history file has an index and the constraint can use it,
+	// we only need to read the ads that the index says might match.
+	if (readHistoryFromIndex(JobHistoryFileName, constraint, constraintExpr, read_backwards)) {
+		return;
+	}
+
 	// the old function doesn't work for backwards, but it does work for forwards so go ahead and call it.
 	//
 	if ( ! read_backwards) {
@@ -1483,6 +1518,262 @@ static void readHistoryFromFileEx(const char *JobHistoryFileName, const char* co
 	reader.Close();
 }
 
+// returns true if the expression can be evaluated exactly using only the attributes
+// recorded in the history index.  we accept only operators, literals and unscoped
+// references to indexed attributes, so that function calls like eval() can't
+// sneak in references to attributes that the index does not have.
+static bool ExprIsHistoryIndexable(classad::ExprTree * tree)
+{
+	if ( ! tree) return true;
+	switch (tree->GetKind()) {
+	case classad::ExprTree::LITERAL_NODE:
+		return true;
+	case classad::ExprTree::ATTRREF_NODE: {
+		classad::ExprTree * scope = NULL;
+		std::string attr;
+		bool absolute = false;
+		((classad::AttributeReference*)tree)->GetComponents(scope, attr, absolute);
+		return ! scope && ! absolute && IsHistoryIndexAttr(attr.c_str());
+	}
+	case classad::ExprTree::OP_NODE: {
+		classad::Operation::OpKind op;
+		classad::ExprTree *t1, *t2, *t3;
+		((classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+		return ExprIsHistoryIndexable(t1) && ExprIsHistoryIndexable(t2) && ExprIsHistoryIndexable(t3);
+	}
+	default:
+		return false;
+	}
+}
+
+// split an expression at top level && operators. if any of the terms is false
+// for a job, the whole expression is false for it.
+static void splitConjuncts(classad::ExprTree * tree, std::vector<ExprTree*> & conjuncts)
+{
+	tree = SkipExprParens(tree);
+	if (tree->GetKind() == classad::ExprTree::OP_NODE) {
+		classad::Operation::OpKind op;
+		classad::ExprTree *t1, *t2, *t3;
+		((classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+		if (op == classad::Operation::LOGICAL_AND_OP) {
+			splitConjuncts(t1, conjuncts);
+			splitConjuncts(t2, conjuncts);
+			return;
+		}
+	}
+	conjuncts.push_back(tree->Copy());
+}
+
+// returns true if the attributes that an expression references can't be
+// determined by looking at it, in which case we must read every attribute.
+static bool ExprHasHiddenReferences(classad::ExprTree * tree)
+{
+	if ( ! tree) return false;
+	switch (tree->GetKind()) {
+	case classad::ExprTree::LITERAL_NODE:
+	case classad::ExprTree::ATTRREF_NODE:
+		return false;
+	case classad::ExprTree::OP_NODE: {
+		classad::Operation::OpKind op;
+		classad::ExprTree *t1, *t2, *t3;
+		((classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+		return ExprHasHiddenReferences(t1) || ExprHasHiddenReferences(t2) || ExprHasHiddenReferences(t3);
+	}
+	case classad::ExprTree::FN_CALL_NODE: {
+		std::string fn;
+		std::vector<classad::ExprTree*> args;
+		((classad::FunctionCall*)tree)->GetComponents(fn, args);
+		if (MATCH == strcasecmp(fn.c_str(), "eval")) return true;
+		for (auto it = args.begin(); it != args.end(); ++it) {
+			if (ExprHasHiddenReferences(*it)) return true;
+		}
+		return false;
+	}
+	default:
+		return true;
+	}
+}
+
+static void setupHistoryPushdown(ExprTree *constraintExpr)
+{
+	if (constraintExpr) {
+		splitConjuncts(constraintExpr, constraintConjuncts);
+	}
+	if (sinceExpr) {
+		splitConjuncts(sinceExpr, sinceConjuncts);
+	}
+
+	// terms of the constraint that can be evaluated using only the history index
+	for (auto it = constraintConjuncts.begin(); it != constraintConjuncts.end(); ++it) {
+		if (ExprIsHistoryIndexable(*it)) {
+			indexConjuncts.push_back(*it);
+		}
+	}
+	// the since expression must be checked against every job, including those
+	// that we skip, so the index is only usable if since can also be evaluated from it.
+	sinceIsIndexed = ! sinceExpr || ExprIsHistoryIndexable(sinceExpr);
+
+	// columnar archives only need to decode the projection and the attributes
+	// that the constraint and since expressions use.
+	archiveAllColumns = projection.isEmpty() ||
+		ExprHasHiddenReferences(constraintExpr) || ExprHasHiddenReferences(sinceExpr);
+	if ( ! archiveAllColumns) {
+		ClassAd empty;
+		for (const char * attr = projection.first(); attr != NULL; attr = projection.next()) {
+			archiveColumns.insert(attr);
+		}
+		if (constraintExpr) { GetExprReferences(constraintExpr, empty, &archiveColumns, &archiveColumns); }
+		if (sinceExpr) { GetExprReferences(sinceExpr, empty, &archiveColumns, &archiveColumns); }
+	}
+
+	if (diagnostic) {
+		fprintf(stderr, "%d terms of the constraint can use the history index%s\n",
+			(int)indexConjuncts.size(), sinceIsIndexed ? "" : " (but -since cannot)");
+		if (archiveAllColumns) {
+			fprintf(stderr, "All attributes will be read from history archives\n");
+		} else {
+			std::string attrs;
+			print_attrs(attrs, false, archiveColumns, ",");
+			fprintf(stderr, "Attributes read from history archives: %s\n", attrs.c_str());
+		}
+	}
+}
+
+// read the jobs in a columnar history archive. row groups whose statistics show
+// that no job in them can match are skipped without decompressing them, and only
+// the columns that we need are decompressed.
+static void readHistoryFromArchive(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards)
+{
+	HistoryArchiveReader reader;
+	std::string errmsg;
+	if ( ! reader.Open(JobHistoryFileName, errmsg)) {
+		fprintf(stderr, "Error opening history file %s: %s\n", JobHistoryFileName, errmsg.c_str());
+		exit(1);
+	}
+
+	ClassAd ad;
+	int numGroups = reader.NumGroups();
+	int groupsRead = 0;
+	bool done = false;
+	for (int ix = 0; ix < numGroups && ! done; ++ix) {
+		int group = read_backwards ? numGroups - ix - 1 : ix;
+		if ( ! reader.ReadGroupHeader(group, errmsg)) {
+			fprintf(stderr, "Error reading history file %s: %s\n", JobHistoryFileName, errmsg.c_str());
+			exit(1);
+		}
+		// we can skip the row group if no job in it can match, but not if it might
+		// contain the job that the since expression says to stop at.
+		if ( ! reader.GroupMightMatch(constraintConjuncts) &&
+			( ! sinceExpr || ! reader.GroupMightMatch(sinceConjuncts))) {
+			continue;
+		}
+		if ( ! reader.LoadGroup(archiveAllColumns ? NULL : &archiveColumns, errmsg)) {
+			fprintf(stderr, "Error reading history file %s: %s\n", JobHistoryFileName, errmsg.c_str());
+			exit(1);
+		}
+		++groupsRead;
+
+		int rows = reader.GroupRows();
+		for (int jj = 0; jj < rows; ++jj) {
+			if ((specifiedMatch > 0 && matchCount >= specifiedMatch) || (maxAds > 0 && adCount >= maxAds) || abort_transfer) {
+				done = true;
+				break;
+			}
+			if ( ! reader.GetRow(read_backwards ? rows - jj - 1 : jj, ad)) {
+				dprintf(D_ALWAYS,"condor_history: failed to create classad from archive %s\n", JobHistoryFileName);
+				printf( "\t*** Warning: Bad history file; skipping malformed ad(s)\n" );
+				continue;
+			}
+			printJobIfConstraint(ad, constraint, constraintExpr);
+		}
+	}
+
+	if (diagnostic) {
+		fprintf(stderr, "Read %d of %d row groups in %s\n", groupsRead, numGroups, JobHistoryFileName);
+	}
+}
+
+// read the jobs in a history file by way of its index, reading only the job ads
+// that the index says could match the constraint. returns false without reading
+// anything if the file has no usable index.
+static bool readHistoryFromIndex(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards)
+{
+	if (indexConjuncts.empty() || ! sinceIsIndexed) {
+		return false;
+	}
+
+	int fd = safe_open_wrapper_follow(JobHistoryFileName, O_RDONLY | O_LARGEFILE);
+	if (fd < 0) {
+		return false;
+	}
+	std::vector<HistoryIndexEntry> entries;
+	if ( ! ReadHistoryIndex(fd, JobHistoryFileName, entries)) {
+		close(fd);
+		return false;
+	}
+
+	ClassAd keyAd;
+	std::string buf;
+	std::vector<std::string> exprs;
+	int numRead = 0;
+	size_t num = entries.size();
+	for (size_t ix = 0; ix < num; ++ix) {
+		if ((specifiedMatch > 0 && matchCount >= specifiedMatch) || (maxAds > 0 && adCount >= maxAds))
+			break;
+		if (abort_transfer)
+			break;
+
+		const HistoryIndexEntry & entry = entries[read_backwards ? num - ix - 1 : ix];
+		HistoryIndexEntryToAd(entry, keyAd);
+		if (sinceExpr && EvalExprBool(&keyAd, sinceExpr)) {
+			++adCount;
+			maxAds = adCount; // this will force us to stop scanning
+			break;
+		}
+		bool maybe_match = true;
+		for (auto it = indexConjuncts.begin(); it != indexConjuncts.end(); ++it) {
+			if ( ! EvalExprBool(&keyAd, *it)) {
+				maybe_match = false;
+				break;
+			}
+		}
+		if ( ! maybe_match) {
+			continue;
+		}
+
+		// read the job ad, which is the text before the banner line
+		size_t cb = (size_t)(entry.banner_offset - entry.ad_offset);
+		buf.resize(cb);
+		if (lseek(fd, entry.ad_offset, SEEK_SET) != entry.ad_offset ||
+			(cb > 0 && full_read(fd, &buf[0], cb) != (ssize_t)cb)) {
+			fprintf(stderr, "Error reading history file %s: %s\n", JobHistoryFileName, strerror(errno));
+			exit(1);
+		}
+		++numRead;
+
+		// printJobIfConstraint wants the lines in reverse order
+		exprs.clear();
+		size_t begin = 0;
+		while (begin < cb) {
+			size_t end = buf.find('\n', begin);
+			if (end == std::string::npos) end = cb;
+			size_t first = buf.find_first_not_of(" \t", begin);
+			if (first < end && buf[first] != '#') {
+				exprs.push_back(buf.substr(begin, end - begin));
+			}
+			begin = end + 1;
+		}
+		std::reverse(exprs.begin(), exprs.end());
+		printJobIfConstraint(exprs, constraint, constraintExpr);
+	}
+	close(fd);
+
+	if (diagnostic) {
+		fprintf(stderr, "Read %d of %d ads in %s using its index\n", numRead, (int)num, JobHistoryFileName);
+	}
+	return true;
+}
+
 // !!! ENTRIES IN THIS TABLE MUST BE SORTED BY THE FIRST FIELD !!
 static const CustomFormatFnTableItem LocalPrintFormats[] = {
 	{ "DATE",            ATTR_Q_DATE, 0, format_int_date, NULL },
@@ -0,0 +1,291 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_debug.h"
+#include "safe_fopen.h"
+#include "cgroup_v2.linux.h"
+
+bool
+read_pressure_stall(const char * filename, PressureStall & ps)
+{
+	FILE * fp = safe_fopen_wrapper_follow(filename, "r");
+	if ( ! fp) {
+		return false;
+	}
+
+	bool found = false;
+	char line[256];
+	while (fgets(line, sizeof(line), fp)) {
+		double avg10 = 0.0;
+		if (sscanf(line, "some avg10=%lf", &avg10) == 1) {
+			ps.some_avg10 = avg10;
+			found = true;
+		} else if (sscanf(line, "full avg10=%lf", &avg10) == 1) {
+			ps.full_avg10 = avg10;
+			found = true;
+		}
+	}
+	fclose(fp);
+	return found;
+}
+
+bool
+cgroup_v2_mount_point(std::string & mount)
+{
+	static std::string cached_mount;
+	if ( ! cached_mount.empty()) {
+		mount = cached_mount;
+		return true;
+	}
+
+	FILE * fp = safe_fopen_wrapper_follow("/proc/self/mounts", "r");
+	if ( ! fp) {
+		return false;
+	}
+	char line[4096];
+	char dev[1024], dir[1024], fstype[64];
+	while (fgets(line, sizeof(line), fp)) {
+		if (sscanf(line, "%1023s %1023s %63s", dev, dir, fstype) == 3 &&
+			strcmp(fstype, "cgroup2") == 0)
+		{
+			cached_mount = dir;
+			break;
+		}
+	}
+	fclose(fp);
+
+	if (cached_mount.empty()) {
+		return false;
+	}
+	mount = cached_mount;
+	return true;
+}
+
+bool
+cgroup_v2_dir_of_pid(pid_t pid, std::string & dir)
+{
+	std::string mount;
+	if ( ! cgroup_v2_mount_point(mount)) {
+		return false;
+	}
+
+	char filename[64];
+	snprintf(filename, sizeof(filename), "/proc/%d/cgroup", (int)pid);
+	FILE * fp = safe_fopen_wrapper_follow(filename, "r");
+	if ( ! fp) {
+		return false;
+	}
+
+		// the unified hierarchy is the one with id 0 and no controllers,
+		// e.g. "0::/system.slice/condor.service"
+	bool found = false;
+	char line[4096];
+	while (fgets(line, sizeof(line), fp)) {
+		if (strncmp(line, "0::", 3) == 0) {
+			size_t len = strlen(line);
+			if (len && line[len-1] == '\n') { line[len-1] = 0; }
+			dir = mount + (line + 3);
+			found = true;
+			break;
+		}
+	}
+	fclose(fp);
+	return found;
+}
+
+// Read "key value" lines from a cgroup file such as cpu.stat.
+static void
+read_cgroup_keyed_file(const std::string & filename, const char * key, long long & value, bool & any)
+{
+	FILE * fp = safe_fopen_wrapper_follow(filename.c_str(), "r");
+	if ( ! fp) {
+		return;
+	}
+	char line[256];
+	size_t keylen = strlen(key);
+	while (fgets(line, sizeof(line), fp)) {
+		if (strncmp(line, key, keylen) == 0 && line[keylen] == ' ') {
+			value = strtoll(line + keylen + 1, NULL, 10);
+			any = true;
+			break;
+		}
+	}
+	fclose(fp);
+}
+
+bool
+cgroup_v2_read_usage(const std::string & dir, CgroupV2Usage & usage)
+{
+	bool any = false;
+	std::string filename;
+
+	filename = dir + "/memory.current";
+	FILE * fp = safe_fopen_wrapper_follow(filename.c_str(), "r");
+	if (fp) {
+		long long value = 0;
+		if (fscanf(fp, "%lld", &value) == 1) {
+			usage.memory_current = value;
+			any = true;
+		}
+		fclose(fp);
+	}
+
+	filename = dir + "/cpu.stat";
+	read_cgroup_keyed_file(filename, "user_usec", usage.user_usec, any);
+	read_cgroup_keyed_file(filename, "system_usec", usage.system_usec, any);
+
+		// io.stat has one line per device, e.g.
+		// "8:0 rbytes=1024 wbytes=0 rios=1 wios=0 dbytes=0 dios=0"
+	filename = dir + "/io.stat";
+	fp = safe_fopen_wrapper_follow(filename.c_str(), "r");
+	if (fp) {
+		usage.read_bytes = usage.write_bytes = usage.reads = usage.writes = 0;
+		char line[1024];
+		while (fgets(line, sizeof(line), fp)) {
+			char * saveptr = NULL;
+			for (char * tok = strtok_r(line, " \n", &saveptr); tok; tok = strtok_r(NULL, " \n", &saveptr)) {
+				long long value = 0;
+				if (sscanf(tok, "rbytes=%lld", &value) == 1) { usage.read_bytes += value; }
+				else if (sscanf(tok, "wbytes=%lld", &value) == 1) { usage.write_bytes += value; }
+				else if (sscanf(tok, "rios=%lld", &value) == 1) { usage.reads += value; }
+				else if (sscanf(tok, "wios=%lld", &value) == 1) { usage.writes += value; }
+			}
+		}
+		fclose(fp);
+		any = true;
+	}
+
+	filename = dir + "/cpu.pressure";
+	any = read_pressure_stall(filename.c_str(), usage.cpu) || any;
+	filename = dir + "/memory.pressure";
+	any = read_pressure_stall(filename.c_str(), usage.memory) || any;
+	filename = dir + "/io.pressure";
+	any = read_pressure_stall(filename.c_str(), usage.io) || any;
+
+	return any;
+}
+
+bool
+cgroup_v2_has_controller(const char * controller)
+{
+	std::string mount;
+	if ( ! cgroup_v2_mount_point(mount)) {
+		return false;
+	}
+
+	std::string filename = mount + "/cgroup.controllers";
+	FILE * fp = safe_fopen_wrapper_follow(filename.c_str(), "r");
+	if ( ! fp) {
+		return false;
+	}
+	bool found = false;
+	char line[1024];
+	if (fgets(line, sizeof(line), fp)) {
+		char * saveptr = NULL;
+		for (char * tok = strtok_r(line, " \n", &saveptr); tok; tok = strtok_r(NULL, " \n", &saveptr)) {
+			if (strcmp(tok, controller) == 0) {
+				found = true;
+				break;
+			}
+		}
+	}
+	fclose(fp);
+	return found;
+}
+
+// Write a short string to a cgroup interface file.
+static bool
+write_cgroup_file(const std::string & filename, const char * value)
+{
+	int fd = safe_open_wrapper_follow(filename.c_str(), O_WRONLY);
+	if (fd < 0) {
+		return false;
+	}
+	ssize_t len = (ssize_t)strlen(value);
+	bool ok = write(fd, value, len) == len;
+	close(fd);
+	return ok;
+}
+
+bool
+cgroup_v2_create(const std::string & name, std::string & dir)
+{
+	std::string mount;
+	if ( ! cgroup_v2_mount_point(mount)) {
+		return false;
+	}
+
+		// A controller has to be enabled in the subtree_control of every
+		// ancestor for the leaf to get its interface files.  The kernel
+		// refuses this for a cgroup that has processes of its own, e.g.
+		// when the name is under the condor service's cgroup, in which
+		// case the leaf only gets cpu.stat and the pressure files.
+	static const char * const controllers[] = { "+cpu", "+io", "+memory" };
+	std::string path = mount;
+	size_t start = 0;
+	while (start < name.size()) {
+		size_t end = name.find('/', start);
+		if (end == std::string::npos) { end = name.size(); }
+		if (end > start) {
+			for (size_t ix = 0; ix < COUNTOF(controllers); ++ix) {
+				write_cgroup_file(path + "/cgroup.subtree_control", controllers[ix]);
+			}
+			path += "/";
+			path.append(name, start, end - start);
+			if (mkdir(path.c_str(), 0755) < 0 && errno != EEXIST) {
+				dprintf(D_ALWAYS, "Failed to create cgroup %s: %s\n", path.c_str(), strerror(errno));
+				return false;
+			}
+		}
+		start = end + 1;
+	}
+	dir = path;
+	return true;
+}
+
+bool
+cgroup_v2_enter(const char * dir)
+{
+	char filename[PATH_MAX];
+	if (snprintf(filename, sizeof(filename), "%s/cgroup.procs", dir) >= (int)sizeof(filename)) {
+		errno = ENAMETOOLONG;
+		return false;
+	}
+	int fd = open(filename, O_WRONLY);
+	if (fd < 0) {
+		return false;
+	}
+		// "0" means the writing process
+	bool ok = write(fd, "0", 1) == 1;
+	int saved_errno = errno;
+	close(fd);
+	errno = saved_errno;
+	return ok;
+}
+
+bool
+cgroup_v2_remove(const std::string & dir)
+{
+	if (rmdir(dir.c_str()) < 0 && errno != ENOENT) {
+		dprintf(D_FULLDEBUG, "Failed to remove cgroup %s: %s\n", dir.c_str(), strerror(errno));
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,100 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _CGROUP_V2_LINUX_H_
+#define _CGROUP_V2_LINUX_H_
+
+/*
+ * Access to the cgroup v2 (unified hierarchy) accounting files and to
+ * pressure stall information (PSI), and just enough cgroup management to
+ * give a job a cgroup of its own.  This uses the kernel's files directly
+ * rather than going through libcgroup, which only knows about the v1
+ * controllers.
+ */
+
+#include <string>
+
+	// One line of a PSI file: the share of wall clock time, in percent,
+	// over the last 10 seconds in which some (or all) tasks were stalled
+	// waiting on the resource.  The values are negative when unavailable.
+struct PressureStall {
+	double some_avg10;
+	double full_avg10;
+
+	PressureStall() : some_avg10(-1.0), full_avg10(-1.0) {}
+};
+
+	// Parse a PSI file such as /proc/pressure/memory or the
+	// memory.pressure file of a cgroup.  Returns false if the file can't
+	// be read, e.g. because the kernel was built without PSI.
+bool read_pressure_stall(const char * filename, PressureStall & ps);
+
+	// Usage of one cgroup, as read from its v2 interface files.  Any value
+	// that could not be read is left negative.
+struct CgroupV2Usage {
+	long long memory_current;	// bytes, from memory.current
+	long long user_usec;		// from cpu.stat
+	long long system_usec;
+	long long read_bytes;		// summed over all devices in io.stat
+	long long write_bytes;
+	long long reads;
+	long long writes;
+	PressureStall cpu;
+	PressureStall memory;
+	PressureStall io;
+
+	CgroupV2Usage()
+		: memory_current(-1), user_usec(-1), system_usec(-1)
+		, read_bytes(-1), write_bytes(-1), reads(-1), writes(-1) {}
+};
+
+	// Return the mount point of the unified hierarchy, or false if there
+	// is none.  The answer is cached after the first successful call.
+bool cgroup_v2_mount_point(std::string & mount);
+
+	// Return the full path of the directory of the v2 cgroup that pid
+	// belongs to, or false if it isn't in one.
+bool cgroup_v2_dir_of_pid(pid_t pid, std::string & dir);
+
+	// Read the usage of the cgroup in the given directory.  Returns false
+	// if none of the files could be read, e.g. because the cgroup is gone.
+bool cgroup_v2_read_usage(const std::string & dir, CgroupV2Usage & usage);
+
+	// Is the given controller (e.g. "memory") available on the unified
+	// hierarchy?  It isn't when the machine still mounts the v1
+	// hierarchies, since a controller can only be bound to one of them.
+bool cgroup_v2_has_controller(const char * controller);
+
+	// Make the cgroup with the given name, relative to the mount point,
+	// and return its directory.  The cpu, io and memory controllers are
+	// enabled for it where the kernel allows, so that memory.current and
+	// io.stat exist; cpu.stat and the pressure files always do.  Must be
+	// called as root.
+bool cgroup_v2_create(const std::string & name, std::string & dir);
+
+	// Move the calling process into the cgroup in the given directory.
+	// This only uses system calls, so it is safe to call between fork()
+	// and exec().  On failure, returns false and leaves errno set.
+bool cgroup_v2_enter(const char * dir);
+
+	// Remove the cgroup in the given directory, which fails if it still
+	// has processes.  Must be called as root.
+bool cgroup_v2_remove(const std::string & dir);
+
+#endif
@@ -27,12 +27,23 @@
 #include "util_lib_proto.h" // for rotate_file
 #include "iso_dates.h"
 #include "condor_email.h"
+#include "condor_daemon_core.h"
 
 #include "classadHistory.h"
+#include "history_archive.h"
 
 static FILE *HistoryFile_fp = NULL;
 static int HistoryFile_RefCount = 0;
 
+// The sidecar index for the current history file.  HistoryIndex_end is the
+// offset in the history file just past the last ad the index describes.
+// HistoryIndex_suspended is set when the current history file has ads that
+// are not in the index, in which case we stop maintaining the index until
+// the next rotation starts a fresh history file.
+static FILE *HistoryIndex_fp = NULL;
+static long long HistoryIndex_end = -1;
+static bool HistoryIndex_suspended = false;
+
 char* JobHistoryFileName = NULL;
 char* JobHistoryParamName = NULL;
 bool        DoHistoryRotation = true;
@@ -40,6 +51,8 @@ bool        DoDailyHistoryRotation = true;
 bool        DoMonthlyHistoryRotation = true;
 filesize_t  MaxHistoryFileSize = 20 * 1024 * 1024; // 20MB;
 int         NumberBackupHistoryFiles = 2;
+bool        DoHistoryIndex = true;
+bool        DoColumnarHistoryArchive = false;
 char*       PerJobHistoryDir = NULL;
 
 static void MaybeRotateHistory(int size_to_append);
@@ -51,6 +64,10 @@ static int findHistoryOffset(FILE *LogFile);
 static FILE* OpenHistoryFile();
 static void CloseJobHistoryFile();
 static void RelinquishHistoryFile(FILE *fp);
+static void AppendHistoryIndex(long long ad_offset, long long banner_offset, long long end_offset, ClassAd *ad);
+static void CloseHistoryIndex();
+static bool ReadLastHistoryIndexEnd(FILE *fp, long long &end_offset);
+static void StartHistoryArchiveConversion(const char *rotated_history_file);
 
 // --------------------------------------------------------------------------
 // --------- PUBLIC FUNCTIONS (called by schedd, startd, etc) ---------------
@@ -82,6 +99,9 @@ InitJobHistoryFile(const char *history_param, const char *per_job_history_param)
     NumberBackupHistoryFiles = param_integer("MAX_HISTORY_ROTATIONS", 
                                           2,  // default
                                           1); // minimum
+    DoHistoryIndex = param_boolean("ENABLE_HISTORY_INDEX", true);
+    DoColumnarHistoryArchive = param_boolean("ROTATE_HISTORY_COLUMNAR", false);
+    HistoryIndex_suspended = false;
 
     if (DoHistoryRotation) {
         dprintf(D_ALWAYS, "History file rotation is enabled.\n");
@@ -144,6 +164,7 @@ AppendHistory(ClassAd* ad)
 	  failed = true;
   } else {
 	  int offset = findHistoryOffset(LogFile);
+	  long long ad_offset = ftell(LogFile);
 	  if (!fPrintAd(LogFile, *ad)) {
 		  dprintf(D_ALWAYS, 
 				  "ERROR: failed to write job class ad to history file %s\n",
@@ -165,10 +186,13 @@ AppendHistory(ClassAd* ad)
 		  if (!ad->LookupString("Owner", owner)) {
 			  owner = "?";
 		  }
+		  long long banner_offset = ftell(LogFile);
 		  fprintf(LogFile,
                       "*** Offset = %d ClusterId = %d ProcId = %d Owner = \"%s\" CompletionDate = %d\n",
 				  offset, cluster, proc, owner.c_str(), completion);
-		  fflush( LogFile );
+		  if (fflush( LogFile ) == 0) {
+			  AppendHistoryIndex(ad_offset, banner_offset, ftell(LogFile), ad);
+		  }
       }
   }
 
@@ -283,10 +307,266 @@ WritePerJobHistoryFile(ClassAd* ad, bool useGjid)
     }
 }
 
+// --------------------------------------------------------------------------
+// The history index is a small text file kept next to each history file,
+// named .<history file name>.idx so that it is never mistaken for a rotated
+// history file. It has a header line followed by one line per ad:
+//
+//   <ad offset> <banner offset> <end offset> <ClusterId> <ProcId> <CompletionDate> <Owner>
+//
+// Offsets are byte offsets into the history file. Missing integer attributes
+// are written as ?, and a missing Owner is written as an empty field.
+// --------------------------------------------------------------------------
+
+#define HISTORY_INDEX_HEADER "# HistoryIndex 1"
+
+void
+HistoryIndexFileName(const char *history_file, std::string &index_file)
+{
+	const char *base = condor_basename(history_file);
+	index_file.assign(history_file, base - history_file);
+	index_file += '.';
+	index_file += base;
+	index_file += ".idx";
+}
+
+static bool
+parseHistoryIndexInt(const char *&p, long long &val, bool &present)
+{
+	while (*p == ' ') ++p;
+	if (*p == '?') {
+		present = false;
+		++p;
+	} else {
+		char *pend = NULL;
+		val = strtoll(p, &pend, 10);
+		if (pend == p) return false;
+		present = true;
+		p = pend;
+	}
+	return *p == ' ' || *p == '\n' || *p == 0;
+}
+
+// Read the index for the given history file. history_fd must be open on the
+// history file; the index is only returned if it describes every ad in that
+// file, otherwise false is returned and the caller should scan the file.
+bool
+ReadHistoryIndex(int history_fd, const char *history_file, std::vector<HistoryIndexEntry> &entries)
+{
+	entries.clear();
+
+	StatInfo si(history_fd);
+	if (si.Error() != SIGood) {
+		return false;
+	}
+	long long history_size = si.GetFileSize();
+
+	std::string index_file;
+	HistoryIndexFileName(history_file, index_file);
+	FILE *fp = safe_fopen_wrapper_follow(index_file.c_str(), "r");
+	if ( ! fp) {
+		return false;
+	}
+
+	bool valid = true;
+	long long prev_end = 0;
+	std::string line;
+	if ( ! readLine(line, fp) || strncmp(line.c_str(), HISTORY_INDEX_HEADER, sizeof(HISTORY_INDEX_HEADER)-1) != MATCH) {
+		valid = false;
+	}
+	while (valid && readLine(line, fp)) {
+		HistoryIndexEntry entry;
+		long long cluster = 0, proc = 0;
+		bool present;
+		const char *p = line.c_str();
+		if ( ! parseHistoryIndexInt(p, entry.ad_offset, present) || ! present ||
+			 ! parseHistoryIndexInt(p, entry.banner_offset, present) || ! present ||
+			 ! parseHistoryIndexInt(p, entry.end_offset, present) || ! present ||
+			 ! parseHistoryIndexInt(p, cluster, entry.has_cluster) ||
+			 ! parseHistoryIndexInt(p, proc, entry.has_proc) ||
+			 ! parseHistoryIndexInt(p, entry.completion_date, entry.has_completion_date)) {
+			valid = false;
+			break;
+		}
+		entry.cluster = (int)cluster;
+		entry.proc = (int)proc;
+		if (*p == ' ') ++p;
+		entry.owner = p;
+		chomp(entry.owner);
+		entry.has_owner = ! entry.owner.empty();
+
+		// the entries must tile the history file exactly
+		if (entry.ad_offset != prev_end ||
+			entry.banner_offset < entry.ad_offset ||
+			entry.end_offset <= entry.banner_offset) {
+			valid = false;
+			break;
+		}
+		prev_end = entry.end_offset;
+		entries.push_back(entry);
+	}
+	fclose(fp);
+
+	if (valid && prev_end != history_size) {
+		dprintf(D_FULLDEBUG, "History index %s covers %lld bytes of %lld, ignoring it\n",
+			index_file.c_str(), prev_end, history_size);
+		valid = false;
+	}
+	if ( ! valid) {
+		entries.clear();
+	}
+	return valid;
+}
+
+// Populate an ad with the attributes that the index records for a job.
+void
+HistoryIndexEntryToAd(const HistoryIndexEntry &entry, ClassAd &ad)
+{
+	ad.Clear();
+	if (entry.has_cluster) { ad.InsertAttr(ATTR_CLUSTER_ID, entry.cluster); }
+	if (entry.has_proc) { ad.InsertAttr(ATTR_PROC_ID, entry.proc); }
+	if (entry.has_completion_date) { ad.InsertAttr(ATTR_COMPLETION_DATE, entry.completion_date); }
+	if (entry.has_owner) { ad.InsertAttr(ATTR_OWNER, entry.owner); }
+}
+
+// Returns true if the given attribute is one that the history index records.
+bool
+IsHistoryIndexAttr(const char *attr)
+{
+	return MATCH == strcasecmp(attr, ATTR_CLUSTER_ID) ||
+		MATCH == strcasecmp(attr, ATTR_PROC_ID) ||
+		MATCH == strcasecmp(attr, ATTR_COMPLETION_DATE) ||
+		MATCH == strcasecmp(attr, ATTR_OWNER);
+}
+
 // --------------------------------------------------------------------------
 // ------ PRIVATE / STATIC FUNCTIONS (implementation specific to this module)
 // --------------------------------------------------------------------------
 
+// Add an entry for the ad just written to the history file to the index.
+// The index is only maintained while it describes every ad in the current
+// history file, so if we find that it doesn't (because the index was
+// disabled for a while, or a write failed) we drop it and wait for the next
+// rotation to start a new one.
+static void
+AppendHistoryIndex(long long ad_offset, long long banner_offset, long long end_offset, ClassAd *ad)
+{
+	if ( ! DoHistoryIndex || HistoryIndex_suspended || ad_offset < 0 || end_offset < 0) {
+		return;
+	}
+
+	std::string index_file;
+	HistoryIndexFileName(JobHistoryFileName, index_file);
+
+	if (HistoryIndex_fp && HistoryIndex_end != ad_offset) {
+		dprintf(D_ALWAYS, "History index %s is out of date, removing it\n", index_file.c_str());
+		CloseHistoryIndex();
+		unlink(index_file.c_str());
+		HistoryIndex_suspended = true;
+		return;
+	}
+
+	if ( ! HistoryIndex_fp) {
+		if (ad_offset == 0) {
+			// this is the first ad in the history file, so start a new index
+			HistoryIndex_fp = safe_fcreate_replace_if_exists(index_file.c_str(), "w", 0644);
+			if (HistoryIndex_fp) {
+				fprintf(HistoryIndex_fp, HISTORY_INDEX_HEADER "\n");
+			}
+		} else {
+			// pick up where a previous incarnation left off, but only if
+			// the index ends exactly where this ad begins.
+			HistoryIndex_fp = safe_fopen_wrapper_follow(index_file.c_str(), "a+");
+			long long index_end = -1;
+			if (HistoryIndex_fp && ( ! ReadLastHistoryIndexEnd(HistoryIndex_fp, index_end) || index_end != ad_offset)) {
+				dprintf(D_FULLDEBUG, "History index %s does not match %s, will start a new index after rotation\n",
+					index_file.c_str(), JobHistoryFileName);
+				CloseHistoryIndex();
+				unlink(index_file.c_str());
+			}
+		}
+		if ( ! HistoryIndex_fp) {
+			HistoryIndex_suspended = true;
+			return;
+		}
+	}
+
+	std::string line;
+	formatstr(line, "%lld %lld %lld", ad_offset, banner_offset, end_offset);
+	const char * int_attrs[] = { ATTR_CLUSTER_ID, ATTR_PROC_ID, ATTR_COMPLETION_DATE };
+	for (size_t ix = 0; ix < COUNTOF(int_attrs); ++ix) {
+		long long val;
+		if (ad->LookupInteger(int_attrs[ix], val)) {
+			formatstr_cat(line, " %lld", val);
+		} else {
+			line += " ?";
+		}
+	}
+	std::string owner;
+	line += ' ';
+	if (ad->LookupString(ATTR_OWNER, owner) && owner.find('\n') == std::string::npos) {
+		line += owner;
+	}
+	line += '\n';
+
+	if (fputs(line.c_str(), HistoryIndex_fp) < 0 || fflush(HistoryIndex_fp) != 0) {
+		dprintf(D_ALWAYS, "ERROR writing history index %s: %s\n", index_file.c_str(), strerror(errno));
+		CloseHistoryIndex();
+		unlink(index_file.c_str());
+		HistoryIndex_suspended = true;
+		return;
+	}
+	HistoryIndex_end = end_offset;
+}
+
+static void
+CloseHistoryIndex()
+{
+	if (HistoryIndex_fp) {
+		fclose(HistoryIndex_fp);
+		HistoryIndex_fp = NULL;
+	}
+	HistoryIndex_end = -1;
+}
+
+// Find the end offset recorded by the last entry of an open history index.
+static bool
+ReadLastHistoryIndexEnd(FILE *fp, long long &end_offset)
+{
+	const long JUMP = 512;
+	char buffer[JUMP + 1];
+
+	if (fseek(fp, 0, SEEK_END) != 0) {
+		return false;
+	}
+	long size = ftell(fp);
+	long start = (size > JUMP) ? size - JUMP : 0;
+	if (size <= 0 || fseek(fp, start, SEEK_SET) != 0) {
+		return false;
+	}
+	size_t cb = fread(buffer, 1, size - start, fp);
+	fseek(fp, 0, SEEK_END);
+	if (cb != (size_t)(size - start) || buffer[cb-1] != '\n') {
+		return false;
+	}
+	buffer[cb-1] = 0;
+	const char *line = strrchr(buffer, '\n');
+	if (line) {
+		++line;
+	} else if (start == 0) {
+		line = buffer;
+	} else {
+		return false;
+	}
+	if (*line == '#') {
+		// only the header, the index is empty
+		end_offset = 0;
+		return true;
+	}
+	long long ad_offset, banner_offset;
+	return sscanf(line, "%lld %lld %lld", &ad_offset, &banner_offset, &end_offset) == 3;
+}
+
 // Obtain a handle to the HISTORY file.  Note that each call to OpenHistoryFile()
 // that return non-NULL _MUST_ be paired with a call to RelinquishHistoryFile().
 static FILE *
@@ -333,6 +613,7 @@ CloseJobHistoryFile() {
 		fclose( HistoryFile_fp );
 		HistoryFile_fp = NULL;
 	}
+	CloseHistoryIndex();
 }
 
 // --------------------------------------------------------------------------
@@ -491,6 +772,9 @@ MaybeDeleteOneHistoryBackup(void)
                     dprintf(D_ALWAYS, "Failed to delete %s\n", oldest_history_filename);
                     num_backups = 0; // prevent looping forever
                 }
+                std::string index_file;
+                HistoryIndexFileName(dir.GetFullPath(), index_file);
+                unlink(index_file.c_str());
             } else {
                 dprintf(D_ALWAYS, "Failed to find/delete %s\n", oldest_history_filename);
                 num_backups = 0; // prevent looping forever
@@ -564,18 +848,112 @@ RotateHistory(void)
     rotated_history_name += '.';
     rotated_history_name += iso_time;
 
+	bool index_valid = HistoryIndex_fp != NULL;
 	CloseJobHistoryFile();
 
+    std::string index_file, rotated_index_file;
+    HistoryIndexFileName(JobHistoryFileName, index_file);
+    HistoryIndexFileName(rotated_history_name.Value(), rotated_index_file);
+
     // Now rotate the file
     if (rotate_file(JobHistoryFileName, rotated_history_name.Value())) {
         dprintf(D_ALWAYS, "Failed to rotate history file to %s\n",
                 rotated_history_name.Value());
         dprintf(D_ALWAYS, "Because rotation failed, the history file may get very large.\n");
+    } else if ( ! index_valid || rotate_file(index_file.c_str(), rotated_index_file.c_str())) {
+        // an index that does not describe the rotated file is worse than none
+        unlink(index_file.c_str());
+    }
+
+    // the next ad starts a new history file, so we can start a new index
+    HistoryIndex_suspended = false;
+
+    if (DoColumnarHistoryArchive && access(rotated_history_name.Value(), F_OK) == 0) {
+        StartHistoryArchiveConversion(rotated_history_name.Value());
     }
 
     return;
 }
 
+// --------------------------------------------------------------------------
+// Convert a rotated history file to a columnar archive, which takes much
+// less space and is faster to query. The archive name still ends in the
+// timestamp, so it is treated as a history backup like the file it
+// replaces. The index is not needed once the archive exists.
+// --------------------------------------------------------------------------
+static bool
+ConvertRotatedHistory(const char *rotated_history_file)
+{
+    std::string archive_file(rotated_history_file);
+    archive_file += HISTORY_ARCHIVE_SUFFIX;
+    std::string errmsg;
+    if ( ! ConvertHistoryToArchive(rotated_history_file, archive_file.c_str(), errmsg)) {
+        dprintf(D_ALWAYS, "Failed to convert %s to a columnar history archive: %s\n",
+                rotated_history_file, errmsg.c_str());
+        return false;
+    }
+
+    std::string index_file;
+    HistoryIndexFileName(rotated_history_file, index_file);
+    unlink(rotated_history_file);
+    unlink(index_file.c_str());
+    return true;
+}
+
+// the rotated history files being converted, by the tid of the converter
+static std::map<int, std::string*> HistoryArchiveConversions;
+static int HistoryArchiveReaperId = -1;
+
+static int
+HistoryArchiveThread(void *arg, Stream *)
+{
+    const std::string *rotated_history_file = (const std::string *)arg;
+    return ConvertRotatedHistory(rotated_history_file->c_str()) ? 0 : 1;
+}
+
+static int
+HistoryArchiveReaper(int tid, int exit_status)
+{
+    auto it = HistoryArchiveConversions.find(tid);
+    if (it != HistoryArchiveConversions.end()) {
+        if (exit_status != 0) {
+            dprintf(D_ALWAYS, "Conversion of %s to a columnar history archive failed, "
+                    "leaving it as a plain history file\n", it->second->c_str());
+        } else {
+            dprintf(D_FULLDEBUG, "Converted %s to a columnar history archive\n", it->second->c_str());
+        }
+        delete it->second;
+        HistoryArchiveConversions.erase(it);
+    }
+    return TRUE;
+}
+
+// Converting takes about a second per 20 Mbytes of history, which is too long
+// to block a daemon, so daemons do it in a child process.
+static void
+StartHistoryArchiveConversion(const char *rotated_history_file)
+{
+    if ( ! daemonCore) {
+        ConvertRotatedHistory(rotated_history_file);
+        return;
+    }
+
+    if (HistoryArchiveReaperId < 0) {
+        HistoryArchiveReaperId = daemonCore->Register_Reaper("HistoryArchiveReaper",
+            HistoryArchiveReaper, "HistoryArchiveReaper");
+    }
+
+    std::string *arg = new std::string(rotated_history_file);
+    int tid = daemonCore->Create_Thread(HistoryArchiveThread, arg, NULL, HistoryArchiveReaperId);
+    if ( ! tid) {
+        dprintf(D_ALWAYS, "Failed to start converting %s to a columnar history archive, "
+                "leaving it as a plain history file\n", rotated_history_file);
+        delete arg;
+        return;
+    }
+    HistoryArchiveConversions[tid] = arg;
+}
+
 // --------------------------------------------------------------------------
 // Figure out how far from the end the beginning of the last line in the
 // history file is. We assume that the file is open. We reset the file pointer
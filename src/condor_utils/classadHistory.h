@@ -29,9 +29,38 @@ extern filesize_t  MaxHistoryFileSize;
 extern int         NumberBackupHistoryFiles;
 extern char*       PerJobHistoryDir;
 extern char* JobHistoryFileName;
+extern bool        DoHistoryIndex;
+extern bool        DoColumnarHistoryArchive;
 
 void WritePerJobHistoryFile(ClassAd*, bool);
 void AppendHistory(ClassAd*);
 void InitJobHistoryFile(const char *, const char *);
 
+// One entry in the sidecar index that AppendHistory keeps for each history
+// file. The ad occupies [ad_offset, banner_offset) of the history file, and
+// its "*** " banner line ends at end_offset.
+struct HistoryIndexEntry {
+	long long ad_offset;
+	long long banner_offset;
+	long long end_offset;
+	long long completion_date;
+	int cluster;
+	int proc;
+	std::string owner;
+	bool has_cluster;
+	bool has_proc;
+	bool has_completion_date;
+	bool has_owner;
+	HistoryIndexEntry()
+		: ad_offset(0), banner_offset(0), end_offset(0), completion_date(0)
+		, cluster(-1), proc(-1)
+		, has_cluster(false), has_proc(false), has_completion_date(false), has_owner(false)
+	{}
+};
+
+void HistoryIndexFileName(const char *history_file, std::string &index_file);
+bool ReadHistoryIndex(int history_fd, const char *history_file, std::vector<HistoryIndexEntry> &entries);
+void HistoryIndexEntryToAd(const HistoryIndexEntry &entry, ClassAd &ad);
+bool IsHistoryIndexAttr(const char *attr);
+
 #endif
@@ -109,6 +109,8 @@ void reinsert_specials(const char* host);
 void process_config_source(const char*, int depth, const char*, const char*, int);
 void process_locals( const char*, const char*);
 void process_directory( const char* dirlist, const char* host);
+static void write_config_snapshot();
+static bool read_config_snapshot(const char * snapshot, const char * root_config, const char * host);
 static int  process_dynamic_configs();
 void do_smart_auto_use(int options);
 
@@ -892,6 +894,14 @@ condor_auth_config(int is_daemon)
 #endif
 }
 
+// bumped whenever the config might have changed, see param_config_generation()
+static int config_generation = 0;
+
+int param_config_generation()
+{
+	return config_generation;
+}
+
 bool
 real_config(const char* host, int wantsQuiet, int config_options, const char * root_config)
 {
@@ -912,6 +922,8 @@ real_config(const char* host, int wantsQuiet, int config_options, const char * r
 			// rebuild it from scratch.
 		clear_global_config_table();
 	}
+	ConfigMacroSet.options &= ~CONFIG_OPT_CONTEXT_DEPENDENT;
+	++config_generation;
 
 	dprintf( D_CONFIG, "config: using subsystem '%s', local '%s'\n",
 			 get_mySubSystem()->getName(), get_mySubSystem()->getLocalName("") );
@@ -1000,6 +1012,20 @@ real_config(const char* host, int wantsQuiet, int config_options, const char * r
 		}
 	}
 
+		// If our parent left a snapshot of its config in the environment, and
+		// none of the config sources have changed since it was written, read
+		// that instead of the global config and all of the local config sources.
+	bool read_snapshot = false;
+	if (config_source && ! (config_options & CONFIG_OPT_USE_THIS_ROOT_CONFIG) &&
+		! get_mySubSystem()->isType(SUBSYSTEM_TYPE_MASTER)) {
+		const char * snapshot = getenv(EnvGetName(ENV_CONFIG_SNAPSHOT));
+		if (snapshot && snapshot[0] && read_config_snapshot(snapshot, config_source, host)) {
+			read_snapshot = true;
+			global_config_source = config_source;
+			config_source = NULL;
+		}
+	}
+
 		// Read in the global file
 	if( config_source ) {
 		process_config_source( config_source, 0, "global config source", NULL, true );
@@ -1026,38 +1052,45 @@ real_config(const char* host, int wantsQuiet, int config_options, const char * r
 		insert_macro("TILDE", tilde, ConfigMacroSet, DetectedMacro, ctx);
 	}
 
-		// Read in the LOCAL_CONFIG_FILE as a string list and process
-		// all the files in the order they are listed.
-	char *dirlist = param("LOCAL_CONFIG_DIR");
-	if(dirlist) {
-		process_directory(dirlist, host);
-	}
-	process_locals( "LOCAL_CONFIG_FILE", host );
+	if ( ! read_snapshot) {
+			// Read in the LOCAL_CONFIG_FILE as a string list and process
+			// all the files in the order they are listed.
+		char *dirlist = param("LOCAL_CONFIG_DIR");
+		if(dirlist) {
+			process_directory(dirlist, host);
+		}
+		process_locals( "LOCAL_CONFIG_FILE", host );
 
-	char* newdirlist = param("LOCAL_CONFIG_DIR");
-	if(newdirlist) {
-		if (dirlist) {
-			if(strcmp(dirlist, newdirlist) ) {
+		char* newdirlist = param("LOCAL_CONFIG_DIR");
+		if(newdirlist) {
+			if (dirlist) {
+				if(strcmp(dirlist, newdirlist) ) {
+					process_directory(newdirlist, host);
+				}
+			}
+			else {
 				process_directory(newdirlist, host);
 			}
 		}
-		else {
-			process_directory(newdirlist, host);
-		}
-	}
 
-	if(dirlist) { free(dirlist); dirlist = NULL; }
-	if(newdirlist) { free(newdirlist); newdirlist = NULL; }
+		if(dirlist) { free(dirlist); dirlist = NULL; }
+		if(newdirlist) { free(newdirlist); newdirlist = NULL; }
 
-		// Now, insert overrides from the user config file (if any)
-	user_config_source.clear();
-	std::string user_config_name;
-	param(user_config_name, "USER_CONFIG_FILE");
-	if (!user_config_name.empty()) {
-		if (find_user_file(user_config_source, user_config_name.c_str(), true, false)) {
-			dprintf(D_FULLDEBUG|D_CONFIG, "Reading condor user-specific configuration from '%s'\n", user_config_source.c_str());
-			process_config_source(user_config_source.c_str(), 1, "user_config source", host, false);
-			local_config_sources.append(user_config_source.c_str());
+			// Now, insert overrides from the user config file (if any)
+		user_config_source.clear();
+		std::string user_config_name;
+		param(user_config_name, "USER_CONFIG_FILE");
+		if (!user_config_name.empty()) {
+			if (find_user_file(user_config_source, user_config_name.c_str(), true, false)) {
+				dprintf(D_FULLDEBUG|D_CONFIG, "Reading condor user-specific configuration from '%s'\n", user_config_source.c_str());
+				process_config_source(user_config_source.c_str(), 1, "user_config source", host, false);
+				local_config_sources.append(user_config_source.c_str());
+			}
+		}
+
+			// The master writes out what it has read so far for the daemons it starts.
+		if (get_mySubSystem()->isType(SUBSYSTEM_TYPE_MASTER)) {
+			write_config_snapshot();
 		}
 	}
 
@@ -1218,6 +1251,161 @@ process_config_source( const char* file, int depth, const char* name,
 	}
 }
 
+// The config snapshot lets the condor_master hand the config that it has read
+// to the daemons that it starts, and to their children, so that they do not each
+// read and parse every config source (and run every config script) again.
+// The snapshot is an ordinary config file holding the raw value of each knob
+// that was set by a config source.  It begins with comment lines that list the
+// config sources and config directories along with their modification times.
+// A daemon uses the snapshot only if none of those have changed, otherwise it
+// reads its config as usual.  Config scripts are not checked, their output is
+// assumed not to change until the master is reconfigured.
+// No snapshot is written when the master's reading of the config depended on
+// its subsystem, see CONFIG_OPT_CONTEXT_DEPENDENT.
+//
+#define CONFIG_SNAPSHOT_BANNER "# HTCondor configuration snapshot written by the condor_master, do not edit."
+
+static void write_config_snapshot()
+{
+	const char * env_name = EnvGetName(ENV_CONFIG_SNAPSHOT);
+	std::string lock_dir;
+	if ( ! param_boolean("MASTER_CONFIG_SNAPSHOT", false) || ! param(lock_dir, "LOCK")) {
+		UnsetEnv(env_name);
+		return;
+	}
+	// the snapshot holds the values as the master read them, so it can only stand in for
+	// the config when reading it as another daemon would have given the same values.
+	if (ConfigMacroSet.options & CONFIG_OPT_CONTEXT_DEPENDENT) {
+		dprintf(D_ALWAYS, "Not writing a config snapshot, the config has if statements, "
+			"self references or includes that depend on which daemon reads them\n");
+		UnsetEnv(env_name);
+		return;
+	}
+
+	std::string snapshot(lock_dir);
+	snapshot += DIR_DELIM_CHAR;
+	snapshot += "config_snapshot";
+	std::string tmpfile(snapshot); tmpfile += ".tmp";
+
+	FILE * fh = safe_fopen_wrapper_follow(tmpfile.c_str(), "w");
+	if ( ! fh) {
+		dprintf(D_ALWAYS, "Failed to create config snapshot %s, errno=%d\n", tmpfile.c_str(), errno);
+		UnsetEnv(env_name);
+		return;
+	}
+
+	fprintf(fh, "%s\n#root %s\n", CONFIG_SNAPSHOT_BANNER, global_config_source.c_str());
+
+	// the first 4 sources are the internal ones (<Detected>, <Default>, etc)
+	struct stat si;
+	for (size_t ix = 4; ix < ConfigMacroSet.sources.size(); ++ix) {
+		const char * source = ConfigMacroSet.sources[ix];
+		if (is_piped_command(source)) {
+			fprintf(fh, "#command %s\n", source);
+		} else if (stat(source, &si) == 0) {
+			fprintf(fh, "#file %lld %lld %s\n", (long long)si.st_mtime, (long long)si.st_size, source);
+		} else {
+			fclose(fh);
+			unlink(tmpfile.c_str());
+			UnsetEnv(env_name);
+			return;
+		}
+	}
+	// the config directories, so that we notice files being added or removed.
+	auto_free_ptr dirlist(param("LOCAL_CONFIG_DIR"));
+	if (dirlist) {
+		StringTokenIterator dirs(dirlist);
+		const std::string * dir;
+		while ((dir = dirs.next_string())) {
+			if (stat(dir->c_str(), &si) == 0) {
+				fprintf(fh, "#dir %lld %s\n", (long long)si.st_mtime, dir->c_str());
+			}
+		}
+	}
+	fprintf(fh, "#end\n");
+
+	HASHITER it = hash_iter_begin(ConfigMacroSet, HASHITER_NO_DEFAULTS);
+	for ( ; ! hash_iter_done(it); hash_iter_next(it)) {
+		MACRO_META * pmeta = hash_iter_meta(it);
+		if (pmeta->inside || pmeta->param_table || pmeta->source_id == EnvMacro.id || pmeta->source_id == WireMacro.id) {
+			continue;
+		}
+		const char * name = hash_iter_key(it);
+		const char * rawval = hash_iter_value(it);
+		if ( ! rawval) rawval = "";
+		if (strchr(rawval, '\n')) {
+			fprintf(fh, "%s @=SnapshotEnd\n%s\n@SnapshotEnd\n", name, rawval);
+		} else {
+			fprintf(fh, "%s = %s\n", name, rawval);
+		}
+	}
+	hash_iter_delete(&it);
+
+	if (fclose(fh) != 0 || rename(tmpfile.c_str(), snapshot.c_str()) != 0) {
+		dprintf(D_ALWAYS, "Failed to write config snapshot %s, errno=%d\n", snapshot.c_str(), errno);
+		unlink(tmpfile.c_str());
+		UnsetEnv(env_name);
+		return;
+	}
+	SetEnv(env_name, snapshot.c_str());
+}
+
+// read the config snapshot, if it is still current. returns false if the snapshot cannot
+// be used, in which case nothing has been read.
+static bool read_config_snapshot(const char * snapshot, const char * root_config, const char * host)
+{
+	FILE * fh = safe_fopen_wrapper_follow(snapshot, "r");
+	if ( ! fh) {
+		return false;
+	}
+
+	bool current = false;
+	StringList sources;
+	MyString line;
+	struct stat si;
+	if (line.readLine(fh)) { line.chomp(); }
+	if (line == CONFIG_SNAPSHOT_BANNER) {
+		while (line.readLine(fh)) {
+			line.chomp();
+			const char * pline = line.Value();
+			long long mtime = 0, size = 0;
+			int pos = 0;
+			if (line == "#end") {
+				current = true;
+				break;
+			} else if (starts_with(pline, "#root ")) {
+				if (strcmp(pline + 6, root_config) != MATCH) break;
+			} else if (starts_with(pline, "#file ")) {
+				if (sscanf(pline + 6, "%lld %lld %n", &mtime, &size, &pos) < 2 || ! pos) break;
+				const char * file = pline + 6 + pos;
+				if (stat(file, &si) != 0 || si.st_mtime != mtime || si.st_size != size) break;
+				if (strcmp(file, root_config) != MATCH) { sources.append(file); }
+			} else if (starts_with(pline, "#dir ")) {
+				if (sscanf(pline + 5, "%lld %n", &mtime, &pos) < 1 || ! pos) break;
+				if (stat(pline + 5 + pos, &si) != 0 || si.st_mtime != mtime) break;
+			} else if (starts_with(pline, "#command ")) {
+				sources.append(pline + 9);
+			} else {
+				break;
+			}
+		}
+	}
+	fclose(fh);
+
+	if ( ! current) {
+		dprintf(D_CONFIG, "config: not using config snapshot %s, it is out of date\n", snapshot);
+		return false;
+	}
+
+	dprintf(D_CONFIG, "config: reading config snapshot %s\n", snapshot);
+	process_config_source(snapshot, 0, "config snapshot", host, true);
+	sources.rewind();
+	for (const char * source = sources.next(); source; source = sources.next()) {
+		local_config_sources.append(source);
+	}
+	return true;
+}
+
 const char * simulated_local_config = NULL;
 
 // Param for given name, read it in as a string list, and process each
@@ -1950,6 +2138,7 @@ param_insert(const char * name, const char * value)
 	MACRO_EVAL_CONTEXT ctx;
 	init_macro_eval_context(ctx);
 	insert_macro(name, value, ConfigMacroSet, WireMacro, ctx);
+	++config_generation;
 }
 
 // set the value of a param equal to the given pointer. if the param is
@@ -1976,6 +2165,7 @@ const char * set_live_param_value(const char * name, const char * live_value)
 	} else {
 		pitem->raw_value = live_value;
 	}
+	++config_generation;
 	return old_value;
 }
 
@@ -3040,6 +3230,7 @@ config_insert( const char* attrName, const char* attrValue )
 	MACRO_EVAL_CONTEXT ctx;
 	init_macro_eval_context(ctx);
 	insert_macro(attrName, attrValue, ConfigMacroSet, WireMacro, ctx);
+	++config_generation;
 }
 
 int macro_stats(MACRO_SET& set, struct _macro_stats &stats)
@@ -241,6 +241,12 @@ class ULogEvent {
 	*/
 	time_t GetEventclock() const { return eventclock; }
 
+	/** Set the time at which this event occurred, for an event that is
+		rebuilt from some other record of it rather than read from a log.
+		@param clock The time at which this event occurred.
+	*/
+	void SetEventclock( time_t clock ) { eventclock = clock; event_usec = 0; }
+
     /// The cluster field of the Condor ID for this event
     int                cluster;
     /// The proc    field of the Condor ID for this event
@@ -90,6 +90,8 @@ CondorQ(void)
 	owner[0] = '\0';
 	schedd[0] = '\0';
 	scheddBirthdate = 0;
+	wait_func = NULL;
+	wait_func_data = NULL;
 	useDefaultingOperator(false);
 }
 
@@ -501,6 +503,10 @@ CondorQ::fetchQueueFromHostAndProcessV2(const char *host,
 
 	int rval = 0;
 	do {
+		if (wait_func && ! sock->msgReady() && ! wait_func(wait_func_data, sock)) {
+			rval = Q_SCHEDD_COMMUNICATION_ERROR;
+			break;
+		}
 		ad = new ClassAd();
 		if ( ! getClassAd(sock, *ad) || ! sock->end_of_message()) {
 			rval = Q_SCHEDD_COMMUNICATION_ERROR;
@@ -24,6 +24,8 @@
 #include "generic_query.h"
 #include "CondorError.h"
 
+class Sock;
+
 #define MAXOWNERLEN 20
 #define MAXSCHEDDLEN 255
 
@@ -33,6 +35,12 @@
 // because the caller will normally delete the ad, but in fact has no more use for it.
 typedef bool (*condor_q_process_func)(void*, ClassAd *ad);
 
+// This callback is optional; if set, it is called with the query socket
+// whenever the next ad from the schedd has not yet arrived, so that the
+// caller can wait for it in its own way, e.g. without holding a lock.
+// It should return false to give up on the query.
+typedef bool (*condor_q_wait_func)(void*, Sock *sock);
+
 /* a list of all types of direct DB query defined here */
 enum CondorQQueryType
 {
@@ -103,6 +111,9 @@ class CondorQ
 
 	void useDefaultingOperator(bool enable);
 
+	// wait for the schedd's ads with wait_func, see condor_q_wait_func above
+	void setWaitFunc(condor_q_wait_func wait_func, void * wait_func_data) { this->wait_func = wait_func; this->wait_func_data = wait_func_data; }
+
 	// option flags for fetchQueueFromHost* functions, these can modify the meaning of attrs
 	// use only one of the choices < fetch_FromMask, optionally OR'd with one or more fetch flags
 	// currently only fetch_Jobs accepts flags.
@@ -142,6 +153,8 @@ class CondorQ
 	char schedd[MAXSCHEDDLEN];
 	bool defaulting_operator;
 	time_t scheddBirthdate;
+	condor_q_wait_func wait_func;
+	void * wait_func_data;
 	
 	// helper functions
 	int fetchQueueFromHostAndProcessV2 ( const char * host, const char * constraint, StringList &attrs, int fetch_opts, int match_limit, condor_q_process_func process_func, void * process_func_data, int connect_timeout, int useFastPath, CondorError* errstack = 0, ClassAd ** psummary_ad=NULL);
@@ -102,6 +102,8 @@ CondorQuery (AdTypes qType)
 {
 	genericQueryType = NULL;
 	resultLimit = 0;
+	waitFunc = NULL;
+	waitFuncData = NULL;
 	queryType = qType;
 	switch (qType)
 	{
@@ -436,6 +438,10 @@ processAds (bool (*callback)(void*, ClassAd *), void* pv, const char * poolName,
 	}
 
 	// get result
+	if (waitFunc && !waitFunc(waitFuncData, sock)) {
+		delete sock;
+		return Q_COMMUNICATION_ERROR;
+	}
 	sock->decode ();
 	int more = 1;
 	while (more)
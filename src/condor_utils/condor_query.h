@@ -162,6 +162,11 @@ class CondorQuery
 	// callback will return 'false' if it took ownership of the ad.
 	QueryResult processAds (bool (*callback)(void*, ClassAd *), void* pv, const char * pool, CondorError* errstack = NULL);
 
+	// if set, processAds calls wait_func with the query socket before it reads
+	// the collector's answer, so the caller can wait for the answer in its own
+	// way, e.g. without holding a lock.  wait_func returns false to give up.
+	void setWaitFunc(bool (*wait_func)(void*, Sock *), void * wait_func_data) { waitFunc = wait_func; waitFuncData = wait_func_data; }
+
 
 	// filter list of ads; arg1 is 'in', arg2 is 'out'
 	QueryResult filterAds (ClassAdList &, ClassAdList &);
@@ -201,6 +206,8 @@ class CondorQuery
 	GenericQuery query;
 	char*		genericQueryType;
 	int         resultLimit; // limit on number of desired results. collectors prior to 8.7.1 will ignore this.
+	bool      (*waitFunc)(void*, Sock *);
+	void*       waitFuncData;
 
  // Stores extra attributes other than reqs to send to server
 	ClassAd		extraAttrs;
@@ -138,6 +138,14 @@ BaseUserPolicy::checkAtExit( void )
 void
 BaseUserPolicy::checkPeriodic( void )
 {
+#ifdef USE_NON_MUTATING_USERPOLICY
+		// Most jobs have no periodic policy that could fire, in which
+		// case there is no need to touch the job ad at all.
+	if ( ! this->user_policy.HasPeriodicPolicy( *(this->job_ad) ) ) {
+		return;
+	}
+#endif
+
 	double old_run_time;
 	this->updateJobTime( &old_run_time );
 
@@ -211,6 +211,8 @@ getline_implementation( T & src, int requested_bufsize, int options, int & line_
 }
 #endif
 
+static bool self_ref_depends_on_context(const char * name, const char * rhs, MACRO_SET & macro_set);
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -1068,6 +1070,7 @@ int Parse_config_string(MACRO_SOURCE & source, int depth, const char * config, M
 
 		std::string errmsg;
 		if (ifstack.line_is_if(line, errmsg, macro_set, ctx)) {
+			macro_set.options |= CONFIG_OPT_CONTEXT_DEPENDENT;
 			if ( ! errmsg.empty()) {
 				dprintf(D_CONFIG | D_FAILURE, "Parse_config if error: '%s' line: %s\n", errmsg.c_str(), line);
 				return -1111;
@@ -1194,6 +1197,9 @@ int Parse_config_string(MACRO_SOURCE & source, int depth, const char * config, M
 			}
 
 			/* expand self references only */
+			if (self_ref_depends_on_context(name, rhs, macro_set)) {
+				macro_set.options |= CONFIG_OPT_CONTEXT_DEPENDENT;
+			}
 			char * value = expand_self_macro(rhs, name, macro_set, ctx);
 			if (value == NULL) {
 				return -1111;
@@ -1489,6 +1495,9 @@ Parse_macros(
 			if (name[0] == '@' && hereTag == name+1) {
 				/* expand self references only */
 				rhs = hereList.print_to_delimed_string("\n");
+				if (self_ref_depends_on_context(hereName.c_str(), rhs, macro_set)) {
+					macro_set.options |= CONFIG_OPT_CONTEXT_DEPENDENT;
+				}
 				value = expand_self_macro(rhs, hereName.c_str(), macro_set, *pctx);
 				if( value == NULL ) {
 					retval = -1;
@@ -1524,6 +1533,7 @@ Parse_macros(
 		// if the line is an if/elif/else/endif handle it here, updating the ifstack as needed.
 		std::string errmsg;
 		if (ifstack.line_is_if(name, errmsg, macro_set, *pctx)) {
+			macro_set.options |= CONFIG_OPT_CONTEXT_DEPENDENT;
 			if ( ! errmsg.empty()) {
 				dprintf(D_CONFIG | D_FAILURE, "Parse_config if error: '%s' line: %s\n", errmsg.c_str(), name);
 				config_errmsg = errmsg;
@@ -1727,6 +1737,10 @@ Parse_macros(
 		// this returns a strdup'd string even if there are no macros to expand.
 		// bool use_default_param_table = (macro_set.options & CONFIG_OPT_DEFAULTS_ARE_PARAM_INFO) != 0;
 		char * line = name; // in case we need to get back to pre-expanded state (for submit)
+		if ((is_meta || is_include) && strstr(name, "$(")) {
+			// the file, command or metaknob to use is chosen by a macro
+			macro_set.options |= CONFIG_OPT_CONTEXT_DEPENDENT;
+		}
 		name = expand_macro(name, macro_set, *pctx);
 		if( name == NULL ) {
 			retval = -1;
@@ -1866,6 +1880,9 @@ Parse_macros(
 				}
 			} else  {
 				/* expand self references only */
+				if (self_ref_depends_on_context(name, rhs, macro_set)) {
+					macro_set.options |= CONFIG_OPT_CONTEXT_DEPENDENT;
+				}
 				value = expand_self_macro(rhs, name, macro_set, *pctx);
 				if( value == NULL ) {
 					retval = -1;
@@ -4785,6 +4802,37 @@ protected:
 	int selflen2;
 };
 
+// returns true if the value being assigned to name refers to the name itself in a way
+// that expand_self_macro resolves differently depending on the subsys or localname of the
+// process reading the config. i.e. PREFIX.NAME = $(NAME) ..., which is only a self reference
+// for the PREFIX subsys, or NAME = $(NAME) ... when PREFIX.NAME is already defined.
+static bool self_ref_depends_on_context(const char * name, const char * rhs, MACRO_SET & macro_set)
+{
+	if ( ! rhs || ! strstr(rhs, "$(")) {
+		return false;
+	}
+	const char * dot = strrchr(name, '.');
+	const char * selfless = dot ? dot+1 : name;
+	int selflen = (int)strlen(selfless);
+
+	SelfOnlyBody only_self(selfless, selflen);
+	MACRO_POSITION pos;
+	if ( ! next_config_macro(is_config_macro, only_self, rhs, 0, pos)) {
+		return false;
+	}
+	if (dot) {
+		return true;
+	}
+	for (int ix = 0; ix < macro_set.size; ++ix) {
+		const char * key = macro_set.table[ix].key;
+		int keylen = (int)strlen(key);
+		if (keylen > selflen+1 && key[keylen-selflen-1] == '.' && MATCH == strcasecmp(key+keylen-selflen, selfless)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 /*
 ** Special version of expand_macro that only expands 'self' references. i.e. it only
 ** expands the macro whose name is specified in the self argument.
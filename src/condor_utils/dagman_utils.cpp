@@ -918,6 +918,10 @@ DagmanUtils::ensureOutputFilesExist(const SubmitDagDeepOptions &deepOpts,
 		tolerant_unlink(shallowOpts.strSchedLog.Value());
 		tolerant_unlink(shallowOpts.strLibOut.Value());
 		tolerant_unlink(shallowOpts.strLibErr.Value());
+			// DAGMan's node state journal, if the node log has the default name
+		MyString journalFile( shallowOpts.primaryDagFile );
+		journalFile += ".nodes.log.journal";
+		tolerant_unlink(journalFile.Value());
 		RenameRescueDagsAfter(shallowOpts.primaryDagFile.Value(),
 					shallowOpts.dagFiles.size() > 1, 0, maxRescueDagNum);
 	}
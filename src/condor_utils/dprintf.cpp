@@ -71,6 +71,12 @@
 
 #include <sstream>
 
+#if !defined(WIN32) && defined(HAVE_PTHREADS)
+// asynchronous (writer thread) dprintf is only supported where we have pthreads
+#define DPRINTF_ASYNC_SUPPORTED 1
+#include <atomic>
+#endif
+
 // call when you want to insure that dprintfs are thread safe on Linux regardless of
 // wether daemon core threads are enabled. thread safety cannot be disabled once enabled
 #ifdef WIN32
@@ -97,6 +103,10 @@ static void debug_close_all_files(void);
 static void debug_open_lock(void);
 static void debug_close_lock(void);
 static FILE *preserve_log_file(struct DebugFileInfo* it, bool dont_panic, time_t tt);
+#ifdef DPRINTF_ASYNC_SUPPORTED
+static bool DebugAsyncRunning = false;
+static void _dprintf_async_enqueue(int cat_and_flags, int hdr_flags, DebugHeaderInfo &info, const char* message, int ixOutput, DebugFileInfo* it);
+#endif
 
 FILE *open_debug_file( int debug_level, const char flags[] );
 
@@ -999,6 +1009,13 @@ _condor_dprintf_va( int cat_and_flags, DPF_IDENT ident, const char* fmt, va_list
 				case SYSLOG: break;
 				default:
 				case FILE_OUT:
+#ifdef DPRINTF_ASYNC_SUPPORTED
+					// hand the message to the writer thread rather than doing the file I/O here
+					if (DebugAsyncRunning && it->dprintfFunc == _dprintf_global_func) {
+						_dprintf_async_enqueue(cat_and_flags, hdr_flags, info, message_buffer, ixOutput, &(*it));
+						continue;
+					}
+#endif
 					debug_lock_it(&(*it), NULL, 0, it->dont_panic);
 					funlock_it = true;
 					break;
@@ -1012,6 +1029,13 @@ _condor_dprintf_va( int cat_and_flags, DPF_IDENT ident, const char* fmt, va_list
 			}
 		}
 
+#ifdef DPRINTF_ASYNC_SUPPORTED
+			// failure messages (EXCEPT, etc) must be on disk before we return
+		if (DebugAsyncRunning && (cat_and_flags & D_FAILURE)) {
+			dprintf_async_flush();
+		}
+#endif
+
 			/* restore privileges */
 		_set_priv(priv, __FILE__, __LINE__, 0);
 
@@ -1039,6 +1063,425 @@ _condor_dprintf_va( int cat_and_flags, DPF_IDENT ident, const char* fmt, va_list
 #endif
 }
 
+/*
+** Asynchronous dprintf.
+**
+** When DEBUG_ASYNC is enabled, messages bound for log files are formatted
+** on the calling thread as usual, but instead of locking, seeking and
+** writing the log file we copy the formatted record into a ring buffer
+** owned by the calling thread.  A single writer thread drains the rings,
+** batches the records for each log file into one write() and checks the
+** log length once per batch.
+**
+** Each ring has exactly one producer (the thread that owns it) and one
+** consumer (whoever holds DebugAsyncIoMutex, normally the writer thread),
+** so the ring itself needs no lock. When a ring is full the message is
+** dropped and counted rather than blocking the daemon.
+**
+** The writer thread never changes priv state, since seteuid() is process
+** wide. Opening and rotating log files is still done by debug_lock_it() on
+** the dprintf'ing thread, which already runs in PRIV_CONDOR.  The writer just
+** sets a flag when it sees that a log needs to be rotated.
+*/
+#ifdef DPRINTF_ASYNC_SUPPORTED
+
+// record header in the ring, followed by len bytes of formatted message
+struct DprintfAsyncRecord {
+	unsigned int   len;
+	unsigned short ixOutput;
+	unsigned short gen;
+};
+
+struct DprintfAsyncRing {
+	char *  buf;
+	size_t  size;       // always a power of 2
+	int     gen;        // async generation this ring was created for
+	std::atomic<size_t> head; // bytes written by the producer (never wraps)
+	std::atomic<size_t> tail; // bytes consumed by the writer (never wraps)
+	std::atomic<bool>   orphaned; // owning thread has exited or moved on to a new ring
+	DprintfAsyncRing *  next;
+
+	DprintfAsyncRing(size_t cb, int g) : buf(NULL), size(cb), gen(g), head(0), tail(0), orphaned(false), next(NULL) {
+		buf = (char*)malloc(size);
+	}
+	~DprintfAsyncRing() { if (buf) free(buf); }
+
+	size_t used() const { return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire); }
+	void put(size_t pos, const void * data, size_t cb) {
+		size_t off = pos & (size-1);
+		size_t cb1 = MIN(cb, size - off);
+		memcpy(buf + off, data, cb1);
+		if (cb1 < cb) memcpy(buf, (const char*)data + cb1, cb - cb1);
+	}
+	void get(size_t pos, void * data, size_t cb) const {
+		size_t off = pos & (size-1);
+		size_t cb1 = MIN(cb, size - off);
+		memcpy(data, buf + off, cb1);
+		if (cb1 < cb) memcpy((char*)data + cb1, buf, cb - cb1);
+	}
+};
+
+// these are set by dprintf_config and take effect at the next dprintf_set_outputs
+static bool   DebugAsyncWanted = false;
+static size_t DebugAsyncBufferSize = 1024*1024;
+static int    DebugAsyncFlushInterval = 100; // milliseconds
+
+static pthread_t DebugAsyncThread;
+static int       DebugAsyncGeneration = 0;
+static pthread_mutex_t DebugAsyncIoMutex = PTHREAD_MUTEX_INITIALIZER;   // held while doing async log file I/O
+static pthread_mutex_t DebugAsyncWakeMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  DebugAsyncWakeCond = PTHREAD_COND_INITIALIZER;
+static std::atomic<bool> DebugAsyncQuit(false);
+static std::atomic<DprintfAsyncRing*> DebugAsyncRings(NULL); // producers push at the head, only the consumer unlinks
+static std::atomic<long long> DebugAsyncDropped(0);
+static long long DebugAsyncDroppedReported = 0;   // protected by DebugAsyncIoMutex
+static std::atomic<unsigned char> * DebugAsyncReopen = NULL; // per-output, non-zero when debug_lock_it must be called
+static std::vector<std::string> * DebugAsyncBatches = NULL;  // per-output write batches, protected by DebugAsyncIoMutex
+static pthread_key_t  DebugAsyncRingKey;
+static pthread_once_t DebugAsyncKeyOnce = PTHREAD_ONCE_INIT;
+
+static void _dprintf_async_orphan_ring(void * pv)
+{
+	DprintfAsyncRing * ring = (DprintfAsyncRing*)pv;
+	if (ring) { ring->orphaned.store(true, std::memory_order_release); }
+}
+
+static void _dprintf_async_make_key()
+{
+	pthread_key_create(&DebugAsyncRingKey, _dprintf_async_orphan_ring);
+}
+
+static DprintfAsyncRing * _dprintf_async_thread_ring()
+{
+	pthread_once(&DebugAsyncKeyOnce, _dprintf_async_make_key);
+	DprintfAsyncRing * ring = (DprintfAsyncRing*)pthread_getspecific(DebugAsyncRingKey);
+	if (ring && ring->gen == DebugAsyncGeneration) {
+		return ring;
+	}
+	// first message from this thread, or the buffer size changed since this ring was made.
+	if (ring) { _dprintf_async_orphan_ring(ring); }
+
+	size_t cb = 4096;
+	while (cb < DebugAsyncBufferSize) cb *= 2;
+	ring = new DprintfAsyncRing(cb, DebugAsyncGeneration);
+	if ( ! ring->buf) {
+		delete ring;
+		pthread_setspecific(DebugAsyncRingKey, NULL);
+		return NULL;
+	}
+	ring->next = DebugAsyncRings.load(std::memory_order_relaxed);
+	while ( ! DebugAsyncRings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {}
+	pthread_setspecific(DebugAsyncRingKey, ring);
+	return ring;
+}
+
+static void _dprintf_async_wake_writer()
+{
+	pthread_mutex_lock(&DebugAsyncWakeMutex);
+	pthread_cond_signal(&DebugAsyncWakeCond);
+	pthread_mutex_unlock(&DebugAsyncWakeMutex);
+}
+
+// write a batch to the log file, the caller must hold DebugAsyncIoMutex
+// returns false if the write failed.
+static bool _dprintf_async_write_locked(DebugFileInfo * it, const char * data, size_t cb)
+{
+	if ( ! it->debugFP) return false;
+	int fd = fileno(it->debugFP);
+	size_t pos = 0;
+	while (pos < cb) {
+		ssize_t rc = write(fd, data + pos, cb - pos);
+		if (rc > 0) {
+			pos += rc;
+		} else if (errno != EINTR) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// move all queued records into the log files. The caller must hold DebugAsyncIoMutex.
+// This is called by the writer thread, and by dprintf'ing threads that need to
+// rotate a log or flush before exit.
+static void _dprintf_async_drain_locked()
+{
+	if ( ! DebugLogs || ! DebugAsyncBatches) return;
+	std::vector<std::string> & batches = *DebugAsyncBatches;
+	const unsigned short gen = (unsigned short)DebugAsyncGeneration;
+
+	DprintfAsyncRing * prev = NULL;
+	DprintfAsyncRing * ring = DebugAsyncRings.load(std::memory_order_acquire);
+	while (ring) {
+		bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+		size_t tail = ring->tail.load(std::memory_order_relaxed);
+		size_t head = ring->head.load(std::memory_order_acquire);
+		while (head - tail >= sizeof(DprintfAsyncRecord)) {
+			DprintfAsyncRecord rec;
+			ring->get(tail, &rec, sizeof(rec));
+			tail += sizeof(rec);
+			if (rec.gen == gen && rec.ixOutput < batches.size()) {
+				std::string & batch = batches[rec.ixOutput];
+				size_t cur = batch.size();
+				batch.resize(cur + rec.len);
+				ring->get(tail, &batch[cur], rec.len);
+			}
+			tail += rec.len;
+		}
+		ring->tail.store(tail, std::memory_order_release);
+
+		DprintfAsyncRing * next = ring->next;
+		// we can only unlink rings that are not at the head of the list, since
+		// producers may be pushing new rings onto the head right now.
+		if (orphaned && prev && ring->used() == 0) {
+			prev->next = next;
+			delete ring;
+		} else {
+			prev = ring;
+		}
+		ring = next;
+	}
+
+	long long dropped = DebugAsyncDropped.load(std::memory_order_relaxed);
+	if (dropped != DebugAsyncDroppedReported && ! batches.empty()) {
+		formatstr_cat(batches[0], "dprintf: %lld messages were dropped because the DEBUG_ASYNC buffer was full\n",
+			dropped - DebugAsyncDroppedReported);
+		DebugAsyncDroppedReported = dropped;
+	}
+
+	time_t now = 0;
+	for (size_t ix = 0; ix < batches.size() && ix < DebugLogs->size(); ++ix) {
+		if (batches[ix].empty()) continue;
+		DebugFileInfo * it = &(*DebugLogs)[ix];
+		if ( ! _dprintf_async_write_locked(it, batches[ix].data(), batches[ix].size())) {
+			// let the next dprintf reopen the file via debug_lock_it, which knows how to complain.
+			DebugAsyncReopen[ix].store(1, std::memory_order_relaxed);
+		}
+		batches[ix].clear();
+
+		// check once per batch if the log needs to be rotated.  we can't do the
+		// rotation here because it needs PRIV_CONDOR, so we flag it for the producer.
+		if (DebugRotateLog && it->maxLog && it->debugFP) {
+			bool rotate = false;
+			if (it->rotate_by_time) {
+				if ( ! now) now = time(NULL);
+				rotate = it->logZero && quantizeTimestamp(now, it->maxLog) > quantizeTimestamp((time_t)it->logZero, it->maxLog);
+			} else {
+				rotate = lseek(fileno(it->debugFP), 0, SEEK_END) >= it->maxLog;
+			}
+			if (rotate) { DebugAsyncReopen[ix].store(1, std::memory_order_relaxed); }
+		}
+	}
+}
+
+static void * _dprintf_async_writer(void *)
+{
+	// signals should be handled by the daemon's main thread, never by this one.
+	sigset_t mask;
+	sigfillset(&mask);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+	for (;;) {
+		bool quit = DebugAsyncQuit.load(std::memory_order_acquire);
+		if ( ! quit) {
+			struct timeval now;
+			gettimeofday(&now, NULL);
+			long long usec = (long long)now.tv_usec + (long long)DebugAsyncFlushInterval * 1000;
+			struct timespec deadline;
+			deadline.tv_sec = now.tv_sec + (time_t)(usec / 1000000);
+			deadline.tv_nsec = (long)(usec % 1000000) * 1000;
+
+			pthread_mutex_lock(&DebugAsyncWakeMutex);
+			if ( ! DebugAsyncQuit.load(std::memory_order_acquire)) {
+				pthread_cond_timedwait(&DebugAsyncWakeCond, &DebugAsyncWakeMutex, &deadline);
+			}
+			pthread_mutex_unlock(&DebugAsyncWakeMutex);
+		}
+
+		pthread_mutex_lock(&DebugAsyncIoMutex);
+		_dprintf_async_drain_locked();
+		pthread_mutex_unlock(&DebugAsyncIoMutex);
+
+		if (quit) break;
+	}
+	return NULL;
+}
+
+// called by a dprintf'ing thread in place of debug_lock_it/dprintfFunc/debug_unlock_it
+static void
+_dprintf_async_enqueue(int cat_and_flags, int hdr_flags, DebugHeaderInfo &info, const char* message, int ixOutput, DebugFileInfo* it)
+{
+	// open the log, or rotate it if the writer thread told us to. we drain first
+	// so that everything queued so far ends up in the old log.
+	if ( ! it->debugFP || DebugAsyncReopen[ixOutput].load(std::memory_order_relaxed)) {
+		pthread_mutex_lock(&DebugAsyncIoMutex);
+		_dprintf_async_drain_locked();
+		DebugAsyncReopen[ixOutput].store(0, std::memory_order_relaxed);
+		FILE * fp = debug_lock_it(it, NULL, 0, it->dont_panic);
+		pthread_mutex_unlock(&DebugAsyncIoMutex);
+		if ( ! fp) return;
+	}
+
+	// the backtrace is formatted by _dprintf_global_func, so messages that carry
+	// one are written directly, after everything already queued.
+	if (((hdr_flags | it->headerOpts) & D_BACKTRACE) && info.num_backtrace && info.backtrace) {
+		pthread_mutex_lock(&DebugAsyncIoMutex);
+		_dprintf_async_drain_locked();
+		_dprintf_global_func(cat_and_flags, hdr_flags, info, message, it);
+		pthread_mutex_unlock(&DebugAsyncIoMutex);
+		return;
+	}
+
+	const char * header = _format_global_header(cat_and_flags, hdr_flags | it->headerOpts, info);
+	size_t cchHeader = header ? strlen(header) : 0;
+	size_t cchMessage = strlen(message);
+
+	DprintfAsyncRecord rec;
+	rec.len = (unsigned int)(cchHeader + cchMessage);
+	rec.ixOutput = (unsigned short)ixOutput;
+	rec.gen = (unsigned short)DebugAsyncGeneration;
+	size_t cbRecord = sizeof(rec) + rec.len;
+
+	DprintfAsyncRing * ring = _dprintf_async_thread_ring();
+	if ( ! ring || cbRecord > ring->size / 4) {
+		// messages that are too big to queue are written directly, after
+		// everything already queued, so that log order is preserved.
+		pthread_mutex_lock(&DebugAsyncIoMutex);
+		_dprintf_async_drain_locked();
+		std::string & batch = (*DebugAsyncBatches)[ixOutput];
+		if (header) batch.append(header, cchHeader);
+		batch.append(message, cchMessage);
+		if ( ! _dprintf_async_write_locked(it, batch.data(), batch.size())) {
+			DebugAsyncReopen[ixOutput].store(1, std::memory_order_relaxed);
+		}
+		batch.clear();
+		pthread_mutex_unlock(&DebugAsyncIoMutex);
+		return;
+	}
+
+	size_t used = ring->used();
+	if (used + cbRecord > ring->size) {
+		DebugAsyncDropped.fetch_add(1, std::memory_order_relaxed);
+		_dprintf_async_wake_writer();
+		return;
+	}
+
+	size_t head = ring->head.load(std::memory_order_relaxed);
+	ring->put(head, &rec, sizeof(rec));
+	if (header) ring->put(head + sizeof(rec), header, cchHeader);
+	ring->put(head + sizeof(rec) + cchHeader, message, cchMessage);
+	ring->head.store(head + cbRecord, std::memory_order_release);
+
+	// don't wait for the flush interval if the ring is getting full
+	if (used < ring->size/2 && used + cbRecord >= ring->size/2) {
+		_dprintf_async_wake_writer();
+	}
+}
+
+void dprintf_async_config(bool enable, long long buffer_size, int flush_interval_ms)
+{
+	DebugAsyncWanted = enable;
+	if (buffer_size > 0) DebugAsyncBufferSize = (size_t)buffer_size;
+	if (flush_interval_ms > 0) DebugAsyncFlushInterval = flush_interval_ms;
+}
+
+static void _dprintf_async_atexit()
+{
+	_dprintf_async_stop();
+}
+
+void _dprintf_async_start()
+{
+	if (DebugAsyncRunning || ! DebugAsyncWanted || ! DebugLogs) return;
+
+	// the debug lock is taken and released around every write, which
+	// defeats the purpose of batching, so we don't do async logging with a lock.
+	if (DebugLock || DebugShouldLockToAppend) return;
+
+	bool any_files = false;
+	for (size_t ix = 0; ix < DebugLogs->size(); ++ix) {
+		if ((*DebugLogs)[ix].outputTarget == FILE_OUT) any_files = true;
+	}
+	if ( ! any_files) return;
+
+	DebugAsyncGeneration = (DebugAsyncGeneration + 1) & 0xFFFF;
+	DebugAsyncReopen = new std::atomic<unsigned char>[DebugLogs->size()];
+	for (size_t ix = 0; ix < DebugLogs->size(); ++ix) {
+		DebugAsyncReopen[ix].store(0);
+	}
+	DebugAsyncBatches = new std::vector<std::string>(DebugLogs->size());
+	DebugAsyncQuit.store(false);
+
+	if (pthread_create(&DebugAsyncThread, NULL, _dprintf_async_writer, NULL) != 0) {
+		delete [] DebugAsyncReopen; DebugAsyncReopen = NULL;
+		delete DebugAsyncBatches; DebugAsyncBatches = NULL;
+		return;
+	}
+
+	static bool registered_atexit = false;
+	if ( ! registered_atexit) {
+		atexit(_dprintf_async_atexit);
+		registered_atexit = true;
+	}
+	DebugAsyncRunning = true;
+}
+
+void _dprintf_async_stop()
+{
+	if ( ! DebugAsyncRunning) return;
+
+	DebugAsyncQuit.store(true, std::memory_order_release);
+	_dprintf_async_wake_writer();
+	pthread_join(DebugAsyncThread, NULL);
+	DebugAsyncRunning = false;
+
+	// the writer drains before it exits, but a message may have been queued after that.
+	pthread_mutex_lock(&DebugAsyncIoMutex);
+	_dprintf_async_drain_locked();
+	pthread_mutex_unlock(&DebugAsyncIoMutex);
+
+	delete [] DebugAsyncReopen; DebugAsyncReopen = NULL;
+	delete DebugAsyncBatches; DebugAsyncBatches = NULL;
+
+	// the writer held the log files open, close them if we normally would.
+	if (DebugLogs && ! log_keep_open) {
+		for (size_t ix = 0; ix < DebugLogs->size(); ++ix) {
+			DebugFileInfo & dfi = (*DebugLogs)[ix];
+			if (dfi.outputTarget == FILE_OUT && dfi.debugFP) {
+				debug_unlock_it(&dfi);
+			}
+		}
+	}
+}
+
+void dprintf_async_flush()
+{
+	if ( ! DebugAsyncRunning) return;
+	pthread_mutex_lock(&DebugAsyncIoMutex);
+	_dprintf_async_drain_locked();
+	pthread_mutex_unlock(&DebugAsyncIoMutex);
+}
+
+void dprintf_async_shutdown()
+{
+	_dprintf_async_stop();
+}
+
+long long dprintf_async_dropped()
+{
+	return DebugAsyncDropped.load(std::memory_order_relaxed);
+}
+
+#else // ! DPRINTF_ASYNC_SUPPORTED
+
+void dprintf_async_config(bool /*enable*/, long long /*buffer_size*/, int /*flush_interval_ms*/) {}
+void _dprintf_async_start() {}
+void _dprintf_async_stop() {}
+void dprintf_async_flush() {}
+void dprintf_async_shutdown() {}
+long long dprintf_async_dropped() { return 0; }
+
+#endif // DPRINTF_ASYNC_SUPPORTED
+
 int
 _condor_open_lock_file(const char *filename,int flags, mode_t perm)
 {
@@ -1805,6 +2248,12 @@ _condor_dprintf_exit( int error_code, const char* msg )
 			   dprintf during the rest of this */
 		DprintfBroken = 1;
 
+#ifdef DPRINTF_ASYNC_SUPPORTED
+			/* We may be holding the async I/O mutex, so don't try to
+			   join the writer thread on the way out. */
+		DebugAsyncRunning = false;
+#endif
+
 			/* Don't forget to unlock the log file, if possible! */
 		debug_close_lock();
 		debug_close_all_files();
@@ -2422,17 +2871,26 @@ dprintf_dump_stack(void) {
 // after the child exec()s or exits.
 static int ParentLockFd = -1;
 static bool ParentDebugRotateLog = true;
+#ifdef DPRINTF_ASYNC_SUPPORTED
+static bool ParentDebugAsyncRunning = false;
+#endif
 
 void
 dprintf_before_shared_mem_clone() {
 	ParentLockFd = LockFd;
 	ParentDebugRotateLog = DebugRotateLog;
+#ifdef DPRINTF_ASYNC_SUPPORTED
+	ParentDebugAsyncRunning = DebugAsyncRunning;
+#endif
 }
 
 void
 dprintf_after_shared_mem_clone() {
 	LockFd = ParentLockFd;
 	DebugRotateLog = ParentDebugRotateLog;
+#ifdef DPRINTF_ASYNC_SUPPORTED
+	DebugAsyncRunning = ParentDebugAsyncRunning;
+#endif
 }
 
 void
@@ -2450,6 +2908,12 @@ dprintf_init_fork_child( bool cloned ) {
 	// and child that can result in the parent writing to a rotated log
 	// file.
 	DebugRotateLog = false;
+#ifdef DPRINTF_ASYNC_SUPPORTED
+	// The writer thread does not exist in the child, so the child
+	// writes synchronously. Anything the parent had queued is
+	// written by the parent.
+	DebugAsyncRunning = false;
+#endif
 	if ( !cloned ) {
 		log_keep_open = 0;
 		std::vector<DebugFileInfo>::iterator it;
@@ -380,6 +380,13 @@ dprintf_config( const char *subsys, struct dprintf_output_settings *p_info /* =
 		}
 	}
 
+	/*
+	 * Optionally hand log file writes off to a writer thread.
+	 */
+	dprintf_async_config(param_boolean("DEBUG_ASYNC", false),
+		param_integer("DEBUG_ASYNC_BUFFER_SIZE", 1024*1024, 4096),
+		param_integer("DEBUG_ASYNC_FLUSH_INTERVAL", 100, 1));
+
 	/*
 	 * Allow the configuration to override all logs to syslog.
 	 */
@@ -44,6 +44,9 @@ void dprintf_set_outputs(const struct dprintf_output_settings *p_info, int c_inf
 {
 	static int first_time = 1;
 
+	// the writer thread refers to the current outputs, so drain and stop it before we replace them.
+	_dprintf_async_stop();
+
 	std::vector<DebugFileInfo> *debugLogsOld = DebugLogs;
 	DebugLogs = new std::vector<DebugFileInfo>();
 
@@ -206,6 +209,8 @@ void dprintf_set_outputs(const struct dprintf_output_settings *p_info, int c_inf
 		delete debugLogsOld;
 	}
 
+	_dprintf_async_start();
+
 	_condor_dprintf_saved_lines();
 }
 
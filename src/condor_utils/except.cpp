@@ -90,6 +90,9 @@ _EXCEPT_(const char *fmt, ...)
 
 	va_end(pvar);
 
+		/* make sure the log has everything before we abort */
+	dprintf_async_flush();
+
 	if( _condor_except_should_dump_core ) {
 		abort();
 	}
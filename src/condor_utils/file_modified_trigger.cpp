@@ -28,6 +28,8 @@
 #if defined( LINUX )
 #include <sys/inotify.h>
 #include <poll.h>
+
+#define FMT_INOTIFY_MASK (IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF)
 #endif /* defined( LINUX ) */
 
 #include "utc_time.h"
@@ -60,7 +62,9 @@ FileModifiedTrigger::FileModifiedTrigger( const std::string & f ) :
 		return;
 	}
 
-	int wd = inotify_add_watch( inotify_fd, filename.c_str(), IN_MODIFY );
+	// Besides appends, wake up for anything that might mean that the
+	// log was rotated or removed, so that the reader notices promptly.
+	int wd = inotify_add_watch( inotify_fd, filename.c_str(), FMT_INOTIFY_MASK );
 	if( wd == -1 ) {
 		dprintf( D_ALWAYS, "FileModifiedTrigger( %s ): inotify_add_watch() failed: %s (%d).\n", filename.c_str(), strerror( errno ), errno );
 		return;
@@ -125,16 +129,18 @@ FileModifiedTrigger::read_inotify_events( void ) {
 		char * ptr = buf;
 		for( ; ptr < buf + len; ptr += sizeof(struct inotify_event) + ((struct inotify_event *)ptr)->len ) {
 			const struct inotify_event * event = (struct inotify_event *)ptr;
-			if(! (event->mask & IN_MODIFY) ) {
+			// The kernel sends IN_IGNORED when the watch goes away (e.g.,
+			// the file was deleted), and IN_Q_OVERFLOW regardless of mask.
+			if(! (event->mask & (FMT_INOTIFY_MASK | IN_IGNORED | IN_Q_OVERFLOW)) ) {
 				dprintf( D_ALWAYS, "FileModifiedTrigger::read_inotify_events(%s): inotify gave me an event I didn't ask for.\n", filename.c_str() );
 				return -1;
 			}
 		}
 
 		// We don't worry about partial reads because we're only watching
-		// one file for one event type, and the kernel will coalesce
-		// identical events, so we should only ever see one. Nonetheless,
-		// we'll verify here that we read only complete events.
+		// one file, the kernel will coalesce identical events, and the
+		// buffer holds at least one event. Nonetheless, we'll verify here
+		// that we read only complete events.
 		if( ptr != buf + len ) {
 			dprintf( D_ALWAYS, "FileModifiedTrigger::read_inotify_events(%s): partial inotify read.\n", filename.c_str() );
 			return -1;
@@ -216,7 +222,14 @@ FileModifiedTrigger::wait( int timeout_in_ms ) {
 
 		bool changed = statbuf.st_size != lastSize;
 		lastSize = statbuf.st_size;
-		if( changed ) { return 1; }
+		if( changed ) {
+#if defined( LINUX )
+			// Any queued notifications are for the change we're reporting;
+			// drain them so that the next wait() doesn't wake up for nothing.
+			if( read_inotify_events() == -1 ) { return -1; }
+#endif /* defined( LINUX ) */
+			return 1;
+		}
 
 		int waitfor = 5000;
 		if( timeout_in_ms >= 0 ) {
@@ -232,9 +245,35 @@ FileModifiedTrigger::wait( int timeout_in_ms ) {
 		}
 
 		int events = notify_or_sleep( waitfor );
-		if( events == 1 ) { return 1; }
+		if( events == 1 ) {
+			// Remember the size we're reporting, or the next wait() would
+			// return at once for the same change.
+			if( fstat( statfd, & statbuf ) == 0 ) { lastSize = statbuf.st_size; }
+			return 1;
+		}
 		if( events == 0 ) { continue; }
 		return -1;
 	}
 
 }
+
+int
+FileModifiedTrigger::read_notifications( void ) {
+	if(! initialized) {
+		return -1;
+	}
+
+#if defined( LINUX )
+	if( read_inotify_events() == -1 ) { return -1; }
+#endif /* defined( LINUX ) */
+
+	struct stat statbuf;
+	if( fstat( statfd, & statbuf ) != 0 ) {
+		dprintf( D_ALWAYS, "FileModifiedTrigger::read_notifications(): fstat() failure on previously-valid fd: %s (%d).\n", strerror(errno), errno );
+		return -1;
+	}
+
+	bool changed = statbuf.st_size != lastSize;
+	lastSize = statbuf.st_size;
+	return changed ? 1 : 0;
+}
@@ -31,6 +31,23 @@ class FileModifiedTrigger {
 		// Returns -1 if invalid, 0 if timed out, 1 if file has changed.
 		int wait( int timeout_in_ms = -1 );
 
+		// Returns an fd which becomes readable when the file may have
+		// changed, for callers with their own poll() loop, or -1 if there
+		// isn't one on this platform.  Call read_notifications() once it
+		// becomes readable; that clears it.
+		int notify_fd( void ) const {
+#if defined( LINUX )
+			return inotify_fd;
+#else
+			return -1;
+#endif
+		}
+
+		// Clears notify_fd() without waiting.  Returns -1 if invalid,
+		// 0 if the file's size hasn't changed since the last call to
+		// this or wait(), and 1 if it has.
+		int read_notifications( void );
+
 	private:
 		// Only needed for better log messages.
 		std::string filename;
@@ -1075,7 +1075,7 @@ void StatisticsPool::InsertProbe (
    FN_STATS_ENTRY_SETRECENTMAX fnsrm,
    FN_STATS_ENTRY_DELETE  fndel) // Destructor
 {
-   pubitem item = { unit, flags, fOwned, false, 0, probe, pattr, fnpub, fnunp };
+   pubitem item = { unit, flags, fOwned, false, 0, probe, pattr, fnpub, fnunp, false };
    pub.insert(name, item, true);
 
    poolitem pi = { unit, fOwned, fnadv, fnclr, fnsrm, fndel };
@@ -1092,7 +1092,7 @@ void StatisticsPool::InsertPublish (
    FN_STATS_ENTRY_PUBLISH fnpub, // publish method
    FN_STATS_ENTRY_UNPUBLISH fnunp) // unpublish method
 {
-   pubitem item = { unit, flags, fOwned, false, 0, probe, pattr, fnpub, fnunp };
+   pubitem item = { unit, flags, fOwned, false, 0, probe, pattr, fnpub, fnunp, true };
    pub.insert(name, item, true);
 }
 
@@ -1289,6 +1289,152 @@ void StatisticsPool::Publish(ClassAd & ad, const char * prefix, int flags) const
       }
 }
 
+// helpers for StatisticsPool::PublishMetrics
+//
+static void metrics_value(std::string & buf, const std::string & name, const char * suffix, double val)
+{
+   formatstr_cat(buf, "%s%s %.17g\n", name.c_str(), suffix, val);
+}
+
+template <class T>
+static void metrics_histogram(std::string & buf, const std::string & name, const stats_histogram<T> & hist)
+{
+   if (hist.cLevels <= 0) return;
+   formatstr_cat(buf, "# TYPE %s histogram\n", name.c_str());
+   long long total = 0;
+   for (int ix = 0; ix < hist.cLevels; ++ix) {
+      total += hist.data[ix];
+      formatstr_cat(buf, "%s_bucket{le=\"%.17g\"} %lld\n", name.c_str(), (double)hist.levels[ix], total);
+   }
+   total += hist.data[hist.cLevels];
+   formatstr_cat(buf, "%s_bucket{le=\"+Inf\"} %lld\n", name.c_str(), total);
+   formatstr_cat(buf, "%s_count %lld\n", name.c_str(), total);
+}
+
+// Publish the lifetime values of the probes in OpenMetrics text format.
+// Recent (windowed) values are left out, since the scraper can compute
+// rates over whatever window it likes from the lifetime counters.
+// This works from the probe unit codes rather than the probe Publish
+// methods, so no ClassAd is built.
+//
+void StatisticsPool::PublishMetrics(std::string & buf, const char * prefix, int flags) const
+{
+   pubitem item;
+   MyString name;
+
+   StatisticsPool * pthis = const_cast<StatisticsPool*>(this);
+   pthis->pub.startIterations();
+   while (pthis->pub.iterate(name,item))
+      {
+      if (item.fPublishOnly) continue;
+      if (!(flags & IF_DEBUGPUB) && (item.flags & IF_DEBUGPUB)) continue;
+      if ((item.flags & IF_PUBLEVEL) > (flags & IF_PUBLEVEL)) continue;
+
+      std::string metric(prefix ? prefix : "");
+      metric += (item.pattr ? item.pattr : name.Value());
+
+      void * pv = item.pitem;
+      switch (item.units & (IS_CLASS_MASK | AS_FUNDAMENTAL_TYPE_MASK)) {
+         case IS_CLS_COUNT | STATS_ENTRY_TYPE_INT32:
+         case IS_CLS_ABS | STATS_ENTRY_TYPE_INT32:
+            formatstr_cat(buf, "# TYPE %s gauge\n", metric.c_str());
+            metrics_value(buf, metric, "", ((stats_entry_count<int>*)pv)->value);
+            break;
+         case IS_CLS_COUNT | STATS_ENTRY_TYPE_INT64:
+         case IS_CLS_ABS | STATS_ENTRY_TYPE_INT64:
+            formatstr_cat(buf, "# TYPE %s gauge\n", metric.c_str());
+            metrics_value(buf, metric, "", (double)((stats_entry_count<int64_t>*)pv)->value);
+            break;
+         case IS_CLS_COUNT | STATS_ENTRY_TYPE_DOUBLE:
+         case IS_CLS_ABS | STATS_ENTRY_TYPE_DOUBLE:
+            formatstr_cat(buf, "# TYPE %s gauge\n", metric.c_str());
+            metrics_value(buf, metric, "", ((stats_entry_count<double>*)pv)->value);
+            break;
+
+         // moving averages keep the latest sample in the base count, rates keep the running sum
+         case IS_CLS_EMA | STATS_ENTRY_TYPE_INT32:
+            formatstr_cat(buf, "# TYPE %s gauge\n", metric.c_str());
+            metrics_value(buf, metric, "", ((stats_entry_count<int>*)pv)->value);
+            break;
+         case IS_CLS_EMA | STATS_ENTRY_TYPE_DOUBLE:
+            formatstr_cat(buf, "# TYPE %s gauge\n", metric.c_str());
+            metrics_value(buf, metric, "", ((stats_entry_count<double>*)pv)->value);
+            break;
+         case IS_CLS_SUM_EMA_RATE | STATS_ENTRY_TYPE_INT32:
+            formatstr_cat(buf, "# TYPE %s counter\n", metric.c_str());
+            metrics_value(buf, metric, "_total", ((stats_entry_count<int>*)pv)->value);
+            break;
+         case IS_CLS_SUM_EMA_RATE | STATS_ENTRY_TYPE_DOUBLE:
+            formatstr_cat(buf, "# TYPE %s counter\n", metric.c_str());
+            metrics_value(buf, metric, "_total", ((stats_entry_count<double>*)pv)->value);
+            break;
+
+         // stats_entry_recent only ever accumulates its lifetime value
+         case IS_RECENT | STATS_ENTRY_TYPE_INT32:
+            formatstr_cat(buf, "# TYPE %s counter\n", metric.c_str());
+            metrics_value(buf, metric, "_total", ((stats_entry_recent<int>*)pv)->value);
+            break;
+         case IS_RECENT | STATS_ENTRY_TYPE_INT64:
+            formatstr_cat(buf, "# TYPE %s counter\n", metric.c_str());
+            metrics_value(buf, metric, "_total", (double)((stats_entry_recent<int64_t>*)pv)->value);
+            break;
+         case IS_RECENT | STATS_ENTRY_TYPE_DOUBLE:
+            formatstr_cat(buf, "# TYPE %s counter\n", metric.c_str());
+            metrics_value(buf, metric, "_total", ((stats_entry_recent<double>*)pv)->value);
+            break;
+         case IS_RECENT: // stats_entry_recent<Probe>
+            {
+            const Probe & probe = ((stats_entry_recent<Probe>*)pv)->value;
+            formatstr_cat(buf, "# TYPE %s summary\n", metric.c_str());
+            metrics_value(buf, metric, "_count", probe.Count);
+            metrics_value(buf, metric, "_sum", probe.Sum);
+            }
+            break;
+
+         case IS_CLS_PROBE | STATS_ENTRY_TYPE_DOUBLE:
+            {
+            stats_entry_probe<double> * probe = (stats_entry_probe<double>*)pv;
+            formatstr_cat(buf, "# TYPE %s summary\n", metric.c_str());
+            metrics_value(buf, metric, "_count", probe->Count());
+            metrics_value(buf, metric, "_sum", probe->Total());
+            }
+            break;
+
+         case IS_RCT | STATS_ENTRY_TYPE_INT32:
+            {
+            stats_recent_counter_timer * probe = (stats_recent_counter_timer*)pv;
+            formatstr_cat(buf, "# TYPE %s summary\n", metric.c_str());
+            metrics_value(buf, metric, "_count", probe->Count());
+            metrics_value(buf, metric, "_sum", probe->Runtime());
+            }
+            break;
+
+         case IS_HISTOGRAM | IS_RECENT | STATS_ENTRY_TYPE_INT32:
+            metrics_histogram(buf, metric, ((stats_entry_recent_histogram<int>*)pv)->value);
+            break;
+         case IS_HISTOGRAM | IS_RECENT | STATS_ENTRY_TYPE_INT64:
+            metrics_histogram(buf, metric, ((stats_entry_recent_histogram<int64_t>*)pv)->value);
+            break;
+         case IS_HISTOGRAM | IS_RECENT | STATS_ENTRY_TYPE_DOUBLE:
+            metrics_histogram(buf, metric, ((stats_entry_recent_histogram<double>*)pv)->value);
+            break;
+         case IS_HISTOGRAM | STATS_ENTRY_TYPE_INT32:
+            metrics_histogram(buf, metric, *(stats_histogram<int>*)pv);
+            break;
+         case IS_HISTOGRAM | STATS_ENTRY_TYPE_INT64:
+            metrics_histogram(buf, metric, *(stats_histogram<int64_t>*)pv);
+            break;
+         case IS_HISTOGRAM | STATS_ENTRY_TYPE_DOUBLE:
+            metrics_histogram(buf, metric, *(stats_histogram<double>*)pv);
+            break;
+
+         default:
+            // timed queues and other probe kinds have no natural OpenMetrics type
+            break;
+      }
+      }
+}
+
 void StatisticsPool::Unpublish(ClassAd & ad) const
 {
    pubitem item;
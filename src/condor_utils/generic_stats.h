@@ -1492,6 +1492,8 @@ public:
    void AdvanceBy(int cSlots) { count.AdvanceBy(cSlots); runtime.AdvanceBy(cSlots); }
    void SetRecentMax(int cMax)    { count.SetRecentMax(cMax); runtime.SetRecentMax(cMax); }
    double operator+=(double val)    { return Add(val); }
+   int Count() const          { return count.value; }
+   double Runtime() const     { return runtime.value; }
 
    static const int PubValue = 1;     // publish overall count and runtime
    static const int PubRecent = 2;    // publish recnet count and runtime
@@ -1693,6 +1695,9 @@ public:
    void Publish(ClassAd & ad, int flags) const;
    void Publish(ClassAd & ad, const char * prefix, int flags) const;
    void Unpublish(ClassAd & ad) const;
+   // append the probes to buf in OpenMetrics text format, without the # EOF trailer.
+   // metric names are the publish attribute names prefixed by prefix.
+   void PublishMetrics(std::string & buf, const char * prefix, int flags) const;
    void Unpublish(ClassAd & ad, const char * prefix) const;
 
 private:
@@ -1706,6 +1711,7 @@ private:
       const char * pattr; // if non-null passed to Publish, if null name is passed.
       FN_STATS_ENTRY_PUBLISH Publish;
       FN_STATS_ENTRY_UNPUBLISH Unpublish;
+      bool   fPublishOnly; // an extra publish entry for a probe that has its own entry
    };
    struct poolitem {
       int units;
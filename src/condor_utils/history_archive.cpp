@@ -0,0 +1,868 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_debug.h"
+#include "safe_fopen.h"
+#include "basename.h"
+#include "stl_string_utils.h"
+#include "compat_classad.h"
+#include "history_archive.h"
+#include "classad/classadCache.h"
+
+#if defined(HAVE_ZLIB_H)
+#include <zlib.h>
+#endif
+
+#define HISTORY_ARCHIVE_MAGIC "HCOLAR01"
+#define HISTORY_ARCHIVE_END_MAGIC "HCOLEND1"
+#define HISTORY_ARCHIVE_MAGIC_LEN 8
+
+// type tags of the cells in a column
+enum {
+	CELL_ABSENT = 0,
+	CELL_INT,
+	CELL_REAL,
+	CELL_STRING,
+	CELL_FALSE,
+	CELL_TRUE,
+	CELL_UNDEFINED,
+	CELL_EXPR,       // anything else, stored as an unparsed expression
+};
+
+// bits in the kinds byte of a column, one per kind of value present
+enum {
+	KIND_INT    = 0x01,
+	KIND_REAL   = 0x02,
+	KIND_STRING = 0x04,
+	KIND_OTHER  = 0x08,
+	KIND_ABSENT = 0x10,
+};
+
+enum {
+	CODEC_NONE = 0,
+	CODEC_ZLIB = 1,
+};
+
+// --------------------------------------------------------------------------
+// encoding helpers
+// --------------------------------------------------------------------------
+
+static void put_u8(std::string & buf, unsigned char val) { buf += (char)val; }
+
+static void put_u32(std::string & buf, unsigned int val)
+{
+	for (int ix = 0; ix < 4; ++ix) { buf += (char)((val >> (8*ix)) & 0xFF); }
+}
+
+static void put_u64(std::string & buf, unsigned long long val)
+{
+	for (int ix = 0; ix < 8; ++ix) { buf += (char)((val >> (8*ix)) & 0xFF); }
+}
+
+static void put_f64(std::string & buf, double val)
+{
+	unsigned long long bits;
+	memcpy(&bits, &val, sizeof(bits));
+	put_u64(buf, bits);
+}
+
+static void put_varint(std::string & buf, unsigned long long val)
+{
+	while (val >= 0x80) {
+		buf += (char)((val & 0x7F) | 0x80);
+		val >>= 7;
+	}
+	buf += (char)val;
+}
+
+static void put_str(std::string & buf, const std::string & str)
+{
+	put_varint(buf, str.size());
+	buf += str;
+}
+
+// a cursor over a buffer, decoding stops (and ok becomes false) at the end.
+struct ArchiveCursor {
+	const unsigned char * p;
+	const unsigned char * end;
+	bool ok;
+
+	ArchiveCursor(const char * data, size_t cb) : p((const unsigned char *)data), end((const unsigned char *)data + cb), ok(true) {}
+
+	bool need(size_t cb) { if ((size_t)(end - p) < cb) { ok = false; } return ok; }
+	unsigned char u8() { if ( ! need(1)) return 0; return *p++; }
+	unsigned int u32() {
+		if ( ! need(4)) return 0;
+		unsigned int val = 0;
+		for (int ix = 0; ix < 4; ++ix) { val |= (unsigned int)(*p++) << (8*ix); }
+		return val;
+	}
+	unsigned long long u64() {
+		if ( ! need(8)) return 0;
+		unsigned long long val = 0;
+		for (int ix = 0; ix < 8; ++ix) { val |= (unsigned long long)(*p++) << (8*ix); }
+		return val;
+	}
+	double f64() { unsigned long long bits = u64(); double val; memcpy(&val, &bits, sizeof(val)); return val; }
+	unsigned long long varint() {
+		unsigned long long val = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if ( ! need(1)) return 0;
+			unsigned char b = *p++;
+			val |= (unsigned long long)(b & 0x7F) << shift;
+			if ( ! (b & 0x80)) return val;
+		}
+		ok = false;
+		return 0;
+	}
+	const char * str(size_t & cb) {
+		cb = (size_t)varint();
+		if ( ! ok || ! need(cb)) return NULL;
+		const char * s = (const char *)p;
+		p += cb;
+		return s;
+	}
+};
+
+static bool write_buf(FILE * fp, const std::string & buf, std::string & errmsg)
+{
+	if (buf.empty()) return true;
+	if (fwrite(buf.data(), 1, buf.size(), fp) != buf.size()) {
+		formatstr(errmsg, "write failed: %s", strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+static bool read_buf(FILE * fp, std::string & buf, size_t cb, std::string & errmsg)
+{
+	buf.resize(cb);
+	if (cb > 0 && fread(&buf[0], 1, cb, fp) != cb) {
+		formatstr(errmsg, "read failed: %s", ferror(fp) ? strerror(errno) : "unexpected end of file");
+		return false;
+	}
+	return true;
+}
+
+// --------------------------------------------------------------------------
+// HistoryArchiveWriter
+// --------------------------------------------------------------------------
+
+struct HistoryArchiveWriter::Column {
+	std::string name;
+	std::string data;
+	int rows;
+	unsigned char kinds;
+	double nmin, nmax;
+	std::string smin, smax;
+
+	Column(const std::string & attr) : name(attr), rows(0), kinds(0), nmin(0), nmax(0) {}
+
+	void pad_to(int row) {
+		if (rows < row) { kinds |= KIND_ABSENT; }
+		while (rows < row) { put_u8(data, CELL_ABSENT); ++rows; }
+	}
+	void add_number(double val) {
+		if ( ! (kinds & (KIND_INT | KIND_REAL))) { nmin = nmax = val; }
+		else if (val < nmin) { nmin = val; }
+		else if (val > nmax) { nmax = val; }
+	}
+	void add_string(const std::string & val) {
+		if ( ! (kinds & KIND_STRING)) { smin = smax = val; }
+		else if (strcasecmp(val.c_str(), smin.c_str()) < 0) { smin = val; }
+		else if (strcasecmp(val.c_str(), smax.c_str()) > 0) { smax = val; }
+	}
+};
+
+HistoryArchiveWriter::HistoryArchiveWriter(int rows_per_group)
+	: m_fp(NULL)
+	, m_rows_per_group(rows_per_group > 0 ? rows_per_group : 2048)
+	, m_rows(0)
+{
+	m_unparser.SetOldClassAd(true, true);
+}
+
+HistoryArchiveWriter::~HistoryArchiveWriter()
+{
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) { delete *it; }
+	if (m_fp) { fclose(m_fp); }
+}
+
+bool HistoryArchiveWriter::Open(const char * filename, std::string & errmsg)
+{
+	m_fp = safe_fcreate_replace_if_exists(filename, "wb", 0644);
+	if ( ! m_fp) {
+		formatstr(errmsg, "cannot create %s: %s", filename, strerror(errno));
+		return false;
+	}
+	std::string magic(HISTORY_ARCHIVE_MAGIC);
+	return write_buf(m_fp, magic, errmsg);
+}
+
+bool HistoryArchiveWriter::Append(const classad::ClassAd & ad, std::string & errmsg)
+{
+	for (auto it = ad.begin(); it != ad.end(); ++it) {
+		Column * col = NULL;
+		auto found = m_column_map.find(it->first);
+		if (found != m_column_map.end()) {
+			col = found->second;
+		} else {
+			col = new Column(it->first);
+			m_columns.push_back(col);
+			m_column_map[col->name] = col;
+		}
+		if (col->rows > m_rows) {
+			continue; // duplicate attribute names differing only in case, keep the first
+		}
+		col->pad_to(m_rows);
+
+		classad::ExprTree * tree = it->second;
+		if (tree && tree->GetKind() == classad::ExprTree::EXPR_ENVELOPE) {
+			tree = ((classad::CachedExprEnvelope*)tree)->get();
+		}
+		classad::Value val;
+		classad::Value::NumberFactor factor = classad::Value::NO_FACTOR;
+		bool is_literal = tree && tree->GetKind() == classad::ExprTree::LITERAL_NODE;
+		if (is_literal) {
+			((classad::Literal*)tree)->GetComponents(val, factor);
+		}
+
+		long long ival;
+		double rval;
+		bool bval;
+		std::string sval;
+		if (is_literal && factor == classad::Value::NO_FACTOR && val.IsIntegerValue(ival)) {
+			put_u8(col->data, CELL_INT);
+			// zigzag encoding so that small negative numbers are small
+			put_varint(col->data, ((unsigned long long)ival << 1) ^ (unsigned long long)(ival >> 63));
+			col->add_number((double)ival);
+			col->kinds |= KIND_INT;
+		} else if (is_literal && factor == classad::Value::NO_FACTOR && val.IsRealValue(rval)) {
+			put_u8(col->data, CELL_REAL);
+			put_f64(col->data, rval);
+			col->add_number(rval);
+			col->kinds |= KIND_REAL;
+		} else if (is_literal && val.IsStringValue(sval)) {
+			put_u8(col->data, CELL_STRING);
+			put_str(col->data, sval);
+			col->add_string(sval);
+			col->kinds |= KIND_STRING;
+		} else if (is_literal && val.IsBooleanValue(bval)) {
+			put_u8(col->data, bval ? CELL_TRUE : CELL_FALSE);
+			col->kinds |= KIND_OTHER;
+		} else if (is_literal && val.IsUndefinedValue()) {
+			put_u8(col->data, CELL_UNDEFINED);
+			col->kinds |= KIND_OTHER;
+		} else {
+			sval.clear();
+			m_unparser.Unparse(sval, it->second);
+			put_u8(col->data, CELL_EXPR);
+			put_str(col->data, sval);
+			col->kinds |= KIND_OTHER;
+		}
+		col->rows = m_rows + 1;
+	}
+
+	++m_rows;
+	if (m_rows >= m_rows_per_group) {
+		return flushGroup(errmsg);
+	}
+	return true;
+}
+
+bool HistoryArchiveWriter::flushGroup(std::string & errmsg)
+{
+	if (m_rows <= 0) {
+		return true;
+	}
+
+	m_group_offsets.push_back((unsigned long long)ftell(m_fp));
+
+	std::string header;
+	std::vector<std::string> chunks(m_columns.size());
+	put_u32(header, m_rows);
+	put_u32(header, (unsigned int)m_columns.size());
+	for (size_t ix = 0; ix < m_columns.size(); ++ix) {
+		Column * col = m_columns[ix];
+		col->pad_to(m_rows);
+
+		unsigned char codec = CODEC_NONE;
+		std::string & chunk = chunks[ix];
+	#if defined(HAVE_ZLIB_H)
+		uLongf cb = compressBound(col->data.size());
+		chunk.resize(cb);
+		if (compress2((Bytef*)&chunk[0], &cb, (const Bytef*)col->data.data(), col->data.size(), Z_DEFAULT_COMPRESSION) == Z_OK
+			&& cb < col->data.size()) {
+			chunk.resize(cb);
+			codec = CODEC_ZLIB;
+		}
+	#endif
+		if (codec == CODEC_NONE) {
+			chunk = col->data;
+		}
+
+		put_str(header, col->name);
+		put_u8(header, col->kinds);
+		put_f64(header, col->nmin);
+		put_f64(header, col->nmax);
+		put_str(header, col->smin);
+		put_str(header, col->smax);
+		put_u8(header, codec);
+		put_u32(header, (unsigned int)chunk.size());
+		put_u32(header, (unsigned int)col->data.size());
+	}
+	if ( ! write_buf(m_fp, header, errmsg)) {
+		return false;
+	}
+	for (size_t ix = 0; ix < chunks.size(); ++ix) {
+		if ( ! write_buf(m_fp, chunks[ix], errmsg)) {
+			return false;
+		}
+	}
+
+	// the next row group starts with no columns, so attributes that are
+	// no longer in use don't take up space in every later row group.
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) { delete *it; }
+	m_columns.clear();
+	m_column_map.clear();
+	m_rows = 0;
+	return true;
+}
+
+bool HistoryArchiveWriter::Close(std::string & errmsg)
+{
+	if ( ! m_fp) {
+		return true;
+	}
+	bool ok = flushGroup(errmsg);
+	if (ok) {
+		std::string footer;
+		for (auto it = m_group_offsets.begin(); it != m_group_offsets.end(); ++it) {
+			put_u64(footer, *it);
+		}
+		put_u32(footer, (unsigned int)m_group_offsets.size());
+		footer += HISTORY_ARCHIVE_END_MAGIC;
+		ok = write_buf(m_fp, footer, errmsg);
+	}
+	if (fclose(m_fp) != 0 && ok) {
+		formatstr(errmsg, "close failed: %s", strerror(errno));
+		ok = false;
+	}
+	m_fp = NULL;
+	return ok;
+}
+
+// --------------------------------------------------------------------------
+// HistoryArchiveReader
+// --------------------------------------------------------------------------
+
+struct HistoryArchiveReader::Column {
+	std::string name;
+	unsigned char kinds;
+	double nmin, nmax;
+	std::string smin, smax;
+	unsigned char codec;
+	unsigned int stored_size;
+	unsigned int raw_size;
+	long long offset;     // file offset of the column data
+	bool loaded;
+	std::string data;     // the decompressed column data, when loaded
+	std::vector<unsigned int> cells; // offset of each row's cell in data
+};
+
+HistoryArchiveReader::HistoryArchiveReader()
+	: m_fp(NULL)
+	, m_rows(0)
+	, m_data_offset(0)
+{
+}
+
+HistoryArchiveReader::~HistoryArchiveReader()
+{
+	Close();
+}
+
+void HistoryArchiveReader::Close()
+{
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) { delete *it; }
+	m_columns.clear();
+	m_group_offsets.clear();
+	m_rows = 0;
+	if (m_fp) {
+		fclose(m_fp);
+		m_fp = NULL;
+	}
+}
+
+bool HistoryArchiveReader::Open(const char * filename, std::string & errmsg)
+{
+	Close();
+	m_fp = safe_fopen_wrapper_follow(filename, "rb");
+	if ( ! m_fp) {
+		formatstr(errmsg, "cannot open %s: %s", filename, strerror(errno));
+		return false;
+	}
+
+	std::string buf;
+	if ( ! read_buf(m_fp, buf, HISTORY_ARCHIVE_MAGIC_LEN, errmsg) || buf != HISTORY_ARCHIVE_MAGIC) {
+		formatstr(errmsg, "%s is not a history archive", filename);
+		Close();
+		return false;
+	}
+
+	// the footer is the list of row group offsets, followed by their count and the end magic
+	const long tail = 4 + HISTORY_ARCHIVE_MAGIC_LEN;
+	if (fseek(m_fp, -tail, SEEK_END) != 0 || ! read_buf(m_fp, buf, tail, errmsg) ||
+		buf.compare(4, HISTORY_ARCHIVE_MAGIC_LEN, HISTORY_ARCHIVE_END_MAGIC) != 0) {
+		formatstr(errmsg, "%s is incomplete or corrupt", filename);
+		Close();
+		return false;
+	}
+	ArchiveCursor cur(buf.data(), 4);
+	unsigned int num_groups = cur.u32();
+	long footer_size = tail + 8 * (long)num_groups;
+	if (fseek(m_fp, -footer_size, SEEK_END) != 0 || ! read_buf(m_fp, buf, 8 * (size_t)num_groups, errmsg)) {
+		formatstr(errmsg, "%s is incomplete or corrupt", filename);
+		Close();
+		return false;
+	}
+	ArchiveCursor groups(buf.data(), buf.size());
+	for (unsigned int ix = 0; ix < num_groups; ++ix) {
+		m_group_offsets.push_back(groups.u64());
+	}
+	return true;
+}
+
+bool HistoryArchiveReader::ReadGroupHeader(int group, std::string & errmsg)
+{
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) { delete *it; }
+	m_columns.clear();
+	m_rows = 0;
+
+	if ( ! m_fp || group < 0 || group >= NumGroups()) {
+		errmsg = "invalid row group";
+		return false;
+	}
+	if (fseek(m_fp, (long)m_group_offsets[group], SEEK_SET) != 0) {
+		formatstr(errmsg, "seek failed: %s", strerror(errno));
+		return false;
+	}
+
+	// the header is small but variable length, read it in pieces as needed.
+	std::string buf;
+	if ( ! read_buf(m_fp, buf, 8, errmsg)) {
+		return false;
+	}
+	ArchiveCursor cur(buf.data(), buf.size());
+	int rows = (int)cur.u32();
+	unsigned int num_cols = cur.u32();
+
+	long long data_offset = 0;
+	for (unsigned int ix = 0; ix < num_cols; ++ix) {
+		Column * col = new Column();
+		m_columns.push_back(col);
+
+		std::string * strs[] = { &col->name, NULL, &col->smin, &col->smax };
+		for (int jj = 0; jj < (int)COUNTOF(strs); ++jj) {
+			if ( ! strs[jj]) {
+				// kinds, min and max
+				if ( ! read_buf(m_fp, buf, 17, errmsg)) return false;
+				ArchiveCursor nums(buf.data(), buf.size());
+				col->kinds = nums.u8();
+				col->nmin = nums.f64();
+				col->nmax = nums.f64();
+				continue;
+			}
+			// strings are a varint length followed by the bytes
+			unsigned long long cb = 0;
+			for (int shift = 0; ; shift += 7) {
+				int ch = fgetc(m_fp);
+				if (ch == EOF || shift >= 64) {
+					errmsg = "unexpected end of file in row group header";
+					return false;
+				}
+				cb |= (unsigned long long)(ch & 0x7F) << shift;
+				if ( ! (ch & 0x80)) break;
+			}
+			if ( ! read_buf(m_fp, *strs[jj], (size_t)cb, errmsg)) return false;
+		}
+		if ( ! read_buf(m_fp, buf, 9, errmsg)) return false;
+		ArchiveCursor sizes(buf.data(), buf.size());
+		col->codec = sizes.u8();
+		col->stored_size = sizes.u32();
+		col->raw_size = sizes.u32();
+		col->offset = data_offset;
+		col->loaded = false;
+		data_offset += col->stored_size;
+	}
+
+	// column offsets were relative to the end of the header
+	long long header_end = ftell(m_fp);
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) {
+		(*it)->offset += header_end;
+	}
+	m_data_offset = header_end;
+	m_rows = rows;
+	return true;
+}
+
+const HistoryArchiveReader::Column * HistoryArchiveReader::findColumn(const std::string & attr) const
+{
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) {
+		if (strcasecmp((*it)->name.c_str(), attr.c_str()) == 0) {
+			return *it;
+		}
+	}
+	return NULL;
+}
+
+// check a single conjunct of the form <attr> <op> <literal> against the
+// statistics of the column for attr. returns false only if no row can match.
+bool HistoryArchiveReader::GroupMightMatch(const std::vector<classad::ExprTree*> & conjuncts) const
+{
+	for (auto it = conjuncts.begin(); it != conjuncts.end(); ++it) {
+		classad::ExprTree * tree = *it;
+		while (tree && tree->GetKind() == classad::ExprTree::OP_NODE) {
+			classad::Operation::OpKind op;
+			classad::ExprTree *t1, *t2, *t3;
+			((classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+			if (op != classad::Operation::PARENTHESES_OP) break;
+			tree = t1;
+		}
+		if ( ! tree || tree->GetKind() != classad::ExprTree::OP_NODE) {
+			continue;
+		}
+
+		classad::Operation::OpKind op;
+		classad::ExprTree *t1, *t2, *t3;
+		((classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+		switch (op) {
+		case classad::Operation::LESS_THAN_OP:
+		case classad::Operation::LESS_OR_EQUAL_OP:
+		case classad::Operation::EQUAL_OP:
+		case classad::Operation::GREATER_OR_EQUAL_OP:
+		case classad::Operation::GREATER_THAN_OP:
+			break;
+		default:
+			continue;
+		}
+
+		// normalize to <attr> <op> <literal>
+		classad::ExprTree * attr_tree = t1;
+		classad::ExprTree * lit_tree = t2;
+		if (t1 && t1->GetKind() == classad::ExprTree::LITERAL_NODE) {
+			attr_tree = t2;
+			lit_tree = t1;
+			switch (op) {
+			case classad::Operation::LESS_THAN_OP: op = classad::Operation::GREATER_THAN_OP; break;
+			case classad::Operation::LESS_OR_EQUAL_OP: op = classad::Operation::GREATER_OR_EQUAL_OP; break;
+			case classad::Operation::GREATER_OR_EQUAL_OP: op = classad::Operation::LESS_OR_EQUAL_OP; break;
+			case classad::Operation::GREATER_THAN_OP: op = classad::Operation::LESS_THAN_OP; break;
+			default: break;
+			}
+		}
+		if ( ! attr_tree || attr_tree->GetKind() != classad::ExprTree::ATTRREF_NODE ||
+			 ! lit_tree || lit_tree->GetKind() != classad::ExprTree::LITERAL_NODE) {
+			continue;
+		}
+		classad::ExprTree * scope = NULL;
+		std::string attr;
+		bool absolute = false;
+		((classad::AttributeReference*)attr_tree)->GetComponents(scope, attr, absolute);
+		if (scope || absolute) {
+			continue;
+		}
+		classad::Value lit;
+		((classad::Literal*)lit_tree)->GetValue(lit);
+
+		double num;
+		std::string str;
+		bool lit_is_num = lit.IsNumber(num) && ! lit.IsBooleanValue();
+		bool lit_is_str = lit.IsStringValue(str);
+		if ( ! lit_is_num && ! lit_is_str) {
+			continue;
+		}
+
+		const Column * col = findColumn(attr);
+		if ( ! col) {
+			// the attribute is undefined in every row, so the comparison is never true
+			return false;
+		}
+		unsigned char kinds = col->kinds & ~KIND_ABSENT;
+		if (lit_is_num && kinds && ! (kinds & ~(KIND_INT | KIND_REAL))) {
+			bool possible = true;
+			switch (op) {
+			case classad::Operation::LESS_THAN_OP: possible = col->nmin < num; break;
+			case classad::Operation::LESS_OR_EQUAL_OP: possible = col->nmin <= num; break;
+			case classad::Operation::EQUAL_OP: possible = col->nmin <= num && num <= col->nmax; break;
+			case classad::Operation::GREATER_OR_EQUAL_OP: possible = col->nmax >= num; break;
+			case classad::Operation::GREATER_THAN_OP: possible = col->nmax > num; break;
+			default: break;
+			}
+			if ( ! possible) return false;
+		} else if (lit_is_str && kinds == KIND_STRING && op == classad::Operation::EQUAL_OP) {
+			// == on strings is case insensitive, and so are the string statistics
+			if (strcasecmp(str.c_str(), col->smin.c_str()) < 0 || strcasecmp(str.c_str(), col->smax.c_str()) > 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool HistoryArchiveReader::LoadGroup(const classad::References * attrs, std::string & errmsg)
+{
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) {
+		(*it)->loaded = false;
+	}
+
+	// attributes that hold expressions are evaluated against the rest of the ad,
+	// so we also need the columns that those expressions refer to, and so on.
+	classad::References wanted;
+	if (attrs) { wanted = *attrs; }
+
+	std::string stored;
+	bool more = true;
+	while (more) {
+		more = false;
+		for (auto it = m_columns.begin(); it != m_columns.end(); ++it) {
+			Column * col = *it;
+			if (col->loaded || (attrs && wanted.find(col->name) == wanted.end())) {
+				continue;
+			}
+			if ( ! loadColumn(col, stored, errmsg)) {
+				return false;
+			}
+			if (attrs && (col->kinds & KIND_OTHER) && addExprReferences(col, wanted)) {
+				more = true;
+			}
+		}
+	}
+	return true;
+}
+
+bool HistoryArchiveReader::loadColumn(Column * col, std::string & stored, std::string & errmsg)
+{
+	if (fseek(m_fp, (long)col->offset, SEEK_SET) != 0) {
+		formatstr(errmsg, "seek failed: %s", strerror(errno));
+		return false;
+	}
+	if (col->codec == CODEC_NONE) {
+		if ( ! read_buf(m_fp, col->data, col->stored_size, errmsg)) return false;
+	} else if (col->codec == CODEC_ZLIB) {
+	#if defined(HAVE_ZLIB_H)
+		if ( ! read_buf(m_fp, stored, col->stored_size, errmsg)) return false;
+		col->data.resize(col->raw_size);
+		uLongf cb = col->raw_size;
+		if (uncompress((Bytef*)&col->data[0], &cb, (const Bytef*)stored.data(), stored.size()) != Z_OK || cb != col->raw_size) {
+			formatstr(errmsg, "column %s is corrupt", col->name.c_str());
+			return false;
+		}
+	#else
+		errmsg = "history archive is compressed, but this build has no zlib support";
+		return false;
+	#endif
+	} else {
+		formatstr(errmsg, "column %s uses unknown compression %d", col->name.c_str(), col->codec);
+		return false;
+	}
+
+	// index the cells
+	col->cells.clear();
+	col->cells.reserve(m_rows);
+	ArchiveCursor cur(col->data.data(), col->data.size());
+	for (int row = 0; row < m_rows && cur.ok; ++row) {
+		col->cells.push_back((unsigned int)(cur.p - (const unsigned char *)col->data.data()));
+		size_t cb;
+		switch (cur.u8()) {
+		case CELL_INT: cur.varint(); break;
+		case CELL_REAL: cur.f64(); break;
+		case CELL_STRING: case CELL_EXPR: cur.str(cb); break;
+		case CELL_ABSENT: case CELL_FALSE: case CELL_TRUE: case CELL_UNDEFINED: break;
+		default: cur.ok = false; break;
+		}
+	}
+	if ( ! cur.ok || (int)col->cells.size() != m_rows) {
+		formatstr(errmsg, "column %s is corrupt", col->name.c_str());
+		return false;
+	}
+	col->loaded = true;
+	return true;
+}
+
+bool HistoryArchiveReader::addExprReferences(const Column * col, classad::References & refs) const
+{
+	size_t num_refs = refs.size();
+	std::set<std::string> seen;
+	classad::ClassAd empty;
+	for (int row = 0; row < m_rows; ++row) {
+		unsigned int off = col->cells[row];
+		ArchiveCursor cur(col->data.data() + off, col->data.size() - off);
+		if (cur.u8() != CELL_EXPR) {
+			continue;
+		}
+		size_t cb;
+		const char * s = cur.str(cb);
+		if ( ! s) {
+			continue;
+		}
+		// the rows of a column usually share a handful of expressions
+		std::string expr(s, cb);
+		if ( ! seen.insert(expr).second) {
+			continue;
+		}
+		GetExprReferences(expr.c_str(), empty, &refs, &refs);
+	}
+	return refs.size() > num_refs;
+}
+
+bool HistoryArchiveReader::GetRow(int row, classad::ClassAd & ad) const
+{
+	ad.Clear();
+	if (row < 0 || row >= m_rows) {
+		return false;
+	}
+	bool ok = true;
+	for (auto it = m_columns.begin(); it != m_columns.end(); ++it) {
+		const Column * col = *it;
+		if ( ! col->loaded) {
+			continue;
+		}
+		unsigned int off = col->cells[row];
+		ArchiveCursor cur(col->data.data() + off, col->data.size() - off);
+		size_t cb;
+		const char * s;
+		unsigned long long zz;
+		switch (cur.u8()) {
+		case CELL_INT:
+			zz = cur.varint();
+			ad.InsertAttr(col->name, (long long)((zz >> 1) ^ (~(zz & 1) + 1)));
+			break;
+		case CELL_REAL:
+			ad.InsertAttr(col->name, cur.f64());
+			break;
+		case CELL_STRING:
+			s = cur.str(cb);
+			if (s) ad.InsertAttr(col->name, std::string(s, cb));
+			break;
+		case CELL_FALSE:
+			ad.InsertAttr(col->name, false);
+			break;
+		case CELL_TRUE:
+			ad.InsertAttr(col->name, true);
+			break;
+		case CELL_UNDEFINED:
+			ad.AssignExpr(col->name, "undefined");
+			break;
+		case CELL_EXPR: {
+			s = cur.str(cb);
+			std::string attr(col->name);
+			if ( ! s || ! ad.InsertViaCache(attr, std::string(s, cb))) {
+				ok = false;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	return ok;
+}
+
+// --------------------------------------------------------------------------
+// conversion from a plain text history file
+// --------------------------------------------------------------------------
+
+bool IsHistoryArchive(const char * filename)
+{
+	FILE * fp = safe_fopen_wrapper_follow(filename, "rb");
+	if ( ! fp) {
+		return false;
+	}
+	char magic[HISTORY_ARCHIVE_MAGIC_LEN];
+	bool is_archive = fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+		memcmp(magic, HISTORY_ARCHIVE_MAGIC, sizeof(magic)) == 0;
+	fclose(fp);
+	return is_archive;
+}
+
+bool ConvertHistoryToArchive(const char * history_file, const char * archive_file, std::string & errmsg)
+{
+	FILE * fp = safe_fopen_wrapper_follow(history_file, "r");
+	if ( ! fp) {
+		formatstr(errmsg, "cannot open %s: %s", history_file, strerror(errno));
+		return false;
+	}
+
+	// write to a hidden temporary file, so that nobody reads a partial archive
+	std::string tmp_file(archive_file, condor_basename(archive_file) - archive_file);
+	tmp_file += '.';
+	tmp_file += condor_basename(archive_file);
+	tmp_file += ".tmp";
+
+	HistoryArchiveWriter writer;
+	bool ok = writer.Open(tmp_file.c_str(), errmsg);
+
+	classad::ClassAd ad;
+	std::string line;
+	int ads = 0, bad = 0;
+	bool bad_ad = false;
+	while (ok && readLine(line, fp)) {
+		if (line.compare(0, 4, "*** ") == 0) {
+			// the banner ends each ad
+			if (bad_ad) {
+				++bad;
+			} else if (ad.size() > 0) {
+				ok = writer.Append(ad, errmsg);
+				++ads;
+			}
+			ad.Clear();
+			bad_ad = false;
+			continue;
+		}
+		chomp(line);
+		const char * p = line.c_str();
+		while (*p == ' ' || *p == '\t') ++p;
+		if ( ! *p || *p == '#') {
+			continue;
+		}
+		if ( ! ad.Insert(line)) {
+			bad_ad = true;
+		}
+	}
+	fclose(fp);
+	if (ok && ! writer.Close(errmsg)) {
+		ok = false;
+	}
+
+	if (ok && rename(tmp_file.c_str(), archive_file) != 0) {
+		formatstr(errmsg, "cannot rename %s to %s: %s", tmp_file.c_str(), archive_file, strerror(errno));
+		ok = false;
+	}
+	if ( ! ok) {
+		unlink(tmp_file.c_str());
+		return false;
+	}
+	if (bad) {
+		dprintf(D_ALWAYS, "Skipped %d malformed ads converting %s to a history archive\n", bad, history_file);
+	}
+	dprintf(D_FULLDEBUG, "Converted %d ads from %s to history archive %s\n", ads, history_file, archive_file);
+	return true;
+}
@@ -0,0 +1,125 @@
+/***************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _HISTORY_ARCHIVE_H_
+#define _HISTORY_ARCHIVE_H_
+
+// A columnar archive of job history ads, used for rotated history files.
+//
+// The archive is a sequence of row groups, each holding up to a few thousand
+// ads. Within a row group each attribute is stored as a separate column chunk,
+// compressed with zlib when it is available. Each chunk records which kinds of
+// values it holds and their min/max, so that a reader can skip row groups that
+// cannot match a constraint without decompressing them, and decompress only
+// the columns that it needs for a projection.
+//
+// File layout (all integers little endian):
+//
+//   header:    "HCOLAR01"
+//   row group: u32 rows, u32 columns, then per column
+//                name, u8 kinds, f64 min, f64 max, string min, string max,
+//                u8 codec, u32 stored size, u32 raw size
+//              followed by the column data in the same order
+//   footer:    u64 offset of each row group, u32 row group count, "HCOLEND1"
+//
+// Column data has one cell per row: a type tag followed by the value.
+
+#include "classad/classad_distribution.h"
+#include <string>
+#include <vector>
+#include <map>
+
+#define HISTORY_ARCHIVE_SUFFIX ".hca"
+
+// returns true if the file starts with the history archive magic
+bool IsHistoryArchive(const char * filename);
+
+// Convert a plain text history file into a history archive.
+// The archive is written to a temporary file and renamed into place.
+bool ConvertHistoryToArchive(const char * history_file, const char * archive_file, std::string & errmsg);
+
+class HistoryArchiveWriter
+{
+public:
+	HistoryArchiveWriter(int rows_per_group = 2048);
+	~HistoryArchiveWriter();
+
+	bool Open(const char * filename, std::string & errmsg);
+	bool Append(const classad::ClassAd & ad, std::string & errmsg);
+	// flush the last row group and write the footer.
+	bool Close(std::string & errmsg);
+
+	struct Column;
+
+private:
+	bool flushGroup(std::string & errmsg);
+
+	FILE * m_fp;
+	int m_rows_per_group;
+	int m_rows;
+	std::vector<Column*> m_columns;
+	std::map<std::string, Column*, classad::CaseIgnLTStr> m_column_map;
+	std::vector<unsigned long long> m_group_offsets;
+	classad::ClassAdUnParser m_unparser;
+};
+
+class HistoryArchiveReader
+{
+public:
+	HistoryArchiveReader();
+	~HistoryArchiveReader();
+
+	bool Open(const char * filename, std::string & errmsg);
+	void Close();
+
+	int NumGroups() const { return (int)m_group_offsets.size(); }
+
+	// read the column directory and statistics of a row group.
+	bool ReadGroupHeader(int group, std::string & errmsg);
+
+	// returns false if the statistics of the current row group show that
+	// one of the given conjuncts cannot be true for any of its rows.
+	bool GroupMightMatch(const std::vector<classad::ExprTree*> & conjuncts) const;
+
+	// decompress the columns for the given attributes, or all columns when attrs is NULL.
+	// columns that the expressions in those columns refer to are also decompressed.
+	bool LoadGroup(const classad::References * attrs, std::string & errmsg);
+
+	int GroupRows() const { return m_rows; }
+
+	// fill ad with the loaded columns of the given row of the current row group
+	bool GetRow(int row, classad::ClassAd & ad) const;
+
+	struct Column;
+
+private:
+	const Column * findColumn(const std::string & attr) const;
+	bool loadColumn(Column * col, std::string & stored, std::string & errmsg);
+	// add the attributes referred to by the expression cells of a loaded column,
+	// returns true if that added any.
+	bool addExprReferences(const Column * col, classad::References & refs) const;
+
+	FILE * m_fp;
+	std::vector<unsigned long long> m_group_offsets;
+	int m_rows;
+	long long m_data_offset;
+	std::vector<Column*> m_columns;
+};
+
+#endif // _HISTORY_ARCHIVE_H_
@@ -745,6 +745,110 @@ ReadMultipleUserLogs::monitorLogFile( MyString logfile,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool
+ReadMultipleUserLogs::monitorLogFile( MyString logfile,
+			const ReadUserLog::FileState &state, CondorError &errstack )
+{
+	dprintf( D_LOG_FILES, "ReadMultipleUserLogs::monitorLogFile(%s, "
+				"<saved state>)\n", logfile.Value() );
+
+	MyString fileID;
+	if ( !GetFileID( logfile, fileID, errstack ) ) {
+		errstack.push( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Error getting file ID in monitorLogFile()" );
+		return false;
+	}
+
+	LogFileMonitor *monitor;
+	if ( allLogFiles.lookup( fileID, monitor ) == 0 ) {
+		errstack.pushf( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Log file %s (%s) is already known; can't restore "
+					"saved state", logfile.Value(), fileID.Value() );
+		return false;
+	}
+
+	monitor = new LogFileMonitor( logfile );
+	ASSERT( monitor );
+	monitor->state = new ReadUserLog::FileState();
+	if ( !ReadUserLog::InitFileState( *(monitor->state) ) ||
+				monitor->state->size != state.size ) {
+		errstack.pushf( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Saved state for log file %s is not valid",
+					logfile.Value() );
+		delete monitor;
+		return false;
+	}
+	memcpy( monitor->state->buf, state.buf, state.size );
+
+	monitor->readUserLog = new ReadUserLog( *(monitor->state) );
+	if ( !monitor->readUserLog->isInitialized() ) {
+		errstack.pushf( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Unable to restore saved state for log file %s",
+					logfile.Value() );
+		delete monitor;
+		return false;
+	}
+
+	if ( allLogFiles.insert( fileID, monitor ) != 0 ) {
+		errstack.pushf( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Error inserting %s into allLogFiles",
+					logfile.Value() );
+		delete monitor;
+		return false;
+	}
+
+	if ( activeLogFiles.insert( fileID, monitor ) != 0 ) {
+		errstack.pushf( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Error inserting %s (%s) into activeLogFiles",
+					logfile.Value(), fileID.Value() );
+		allLogFiles.remove( fileID );
+		delete monitor;
+		return false;
+	}
+
+	dprintf( D_LOG_FILES, "ReadMultipleUserLogs: added log file %s (%s) "
+				"to active list from saved state\n", logfile.Value(),
+				fileID.Value() );
+
+	monitor->refCount++;
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool
+ReadMultipleUserLogs::getFileState( MyString logfile,
+			ReadUserLog::FileState &state, CondorError &errstack )
+{
+	MyString fileID;
+	if ( !GetFileID( logfile, fileID, errstack ) ) {
+		errstack.push( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Error getting file ID in getFileState()" );
+		return false;
+	}
+
+	LogFileMonitor *monitor;
+	if ( activeLogFiles.lookup( fileID, monitor ) != 0 ||
+				!monitor->readUserLog ) {
+		errstack.pushf( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Log file %s (%s) is not being monitored",
+					logfile.Value(), fileID.Value() );
+		return false;
+	}
+
+	if ( !monitor->readUserLog->GetFileState( state ) ) {
+		errstack.pushf( "ReadMultipleUserLogs", UTIL_ERR_LOG_FILE,
+					"Error getting state for log file %s",
+					logfile.Value() );
+		return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 // Note: logfile is not passed as a reference because we need a local
 // copy to modify anyhow.
 bool
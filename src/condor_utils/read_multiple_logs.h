@@ -188,6 +188,28 @@ public:
 	bool monitorLogFile(MyString logfile, bool truncateIfFirst,
 				CondorError &errstack);
 
+		/** Monitor the given log file, starting at a position saved
+			earlier with getFileState() rather than at the beginning
+			of the file.  The file must not already be known to this
+			object.
+			@param the log file to monitor
+			@param the saved reader state
+			@param a CondorError object to hold any error information
+			@return true if successful, false if failed
+		*/
+	bool monitorLogFile(MyString logfile,
+				const ReadUserLog::FileState &state, CondorError &errstack);
+
+		/** Save the current reader state of an actively monitored log
+			file, so that a later reader can pick up from this point.
+			@param the log file
+			@param a state buffer set up with ReadUserLog::InitFileState()
+			@param a CondorError object to hold any error information
+			@return true if successful, false if failed
+		*/
+	bool getFileState(MyString logfile, ReadUserLog::FileState &state,
+				CondorError &errstack);
+
 		/** Unmonitor the given log file
 			@param the log file to unmonitor
 			@param a CondorError object to hold any error information
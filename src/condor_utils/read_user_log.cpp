@@ -161,6 +161,7 @@ ReadUserLog::ReadUserLog ( FILE *fp, int log_type, bool enable_close )
 	}
 	m_fp = fp;
 	m_fd = fileno( fp );
+	m_complete_end = 0;
 	m_enable_close = enable_close;
 
 	m_lock = new FakeFileLock( );
@@ -449,6 +450,7 @@ ReadUserLog::CloseLogFile( bool force )
 				close(m_fd);
 				m_fd = -1;
 			}
+			m_complete_end = 0;
 		}
 	}
 
@@ -1107,6 +1109,14 @@ ReadUserLog::readEventNormal( ULogEvent *& event, FileLockBase *lock )
 		return ULOG_UNK_ERROR;
 	}
 
+	// If the writer hasn't finished the next event yet, there's nothing
+	// to parse; don't go through the error recovery (and sleep) below.
+	if ( ! haveCompleteEvent( filepos ) ) {
+		clearerr( m_fp );
+		Unlock(lock, true);
+		return ULOG_NO_EVENT;
+	}
+
 	retval1 = fscanf (m_fp, "%d", &eventnumber);
 
 	// so we don't dump core if the above fscanf failed
@@ -1364,6 +1374,99 @@ ReadUserLog::synchronize ( void )
     return false;
 }
 
+// Writers only ever append whole events, so once we've seen a synch line
+// we know that everything before it is complete.  We remember how far that
+// is, and only look at the file again when the reader has consumed all of
+// it; a reader tailing a quiet log then costs one fstat() per poll rather
+// than a failed parse, and a partially written event is reported as
+// ULOG_NO_EVENT right away instead of after a one second retry.
+//
+// The tail is read with pread() from the end backwards, which normally
+// finds a synch line in the first block.  (We don't mmap() the file: a log
+// truncated underneath us would turn into a SIGBUS.)
+bool
+ReadUserLog::haveCompleteEvent( long filepos )
+{
+#if defined(WIN32)
+	(void) filepos;
+	return true;
+#else
+	if ( (filesize_t)filepos < m_complete_end ) {
+		return true;
+	}
+
+	StatWrapper	statwrap;
+	if ( statwrap.Stat( m_fd ) ) {
+		// let the parser find out what's wrong
+		return true;
+	}
+	filesize_t	size = statwrap.GetBuf()->st_size;
+	if ( size <= (filesize_t)filepos ) {
+		return false;
+	}
+
+	// Give up and let the parser decide once we've looked at this much
+	// without finding the end of an event.
+	const filesize_t max_scan = 4 * 1024 * 1024;
+	const int block_size = 64 * 1024;
+	// Long enough to hold "\n...\r\n" so that a synch line split across
+	// two blocks is found in the second one.
+	const int overlap = 8;
+
+	char *buf = (char *) malloc( block_size );
+	if ( ! buf ) {
+		return true;
+	}
+
+	bool		found = false;
+	filesize_t	hi = size;
+	while ( ! found && hi > (filesize_t)filepos && size - hi < max_scan ) {
+		filesize_t lo = hi - block_size;
+		if ( lo < (filesize_t)filepos ) {
+			lo = filepos;
+		}
+		ssize_t len = pread( m_fd, buf, (size_t)(hi - lo), (off_t)lo );
+		if ( len != (ssize_t)(hi - lo) ) {
+			free( buf );
+			return true;
+		}
+
+		for ( int nl = (int)len - 1; nl >= 0; --nl ) {
+			if ( buf[nl] != '\n' ) {
+				continue;
+			}
+			int dots = nl;
+			if ( dots > 0 && buf[dots-1] == '\r' ) {
+				dots--;
+			}
+			dots -= 3;
+			if ( dots < 0 ||
+				 buf[dots] != '.' || buf[dots+1] != '.' || buf[dots+2] != '.' ) {
+				continue;
+			}
+			if ( lo + dots == (filesize_t)filepos ||
+				 ( dots > 0 && buf[dots-1] == '\n' ) ) {
+				m_complete_end = lo + nl + 1;
+				found = true;
+				break;
+			}
+		}
+
+		if ( lo == (filesize_t)filepos ) {
+			break;
+		}
+		hi = lo + overlap;
+	}
+	free( buf );
+
+	if ( found ) {
+		return true;
+	}
+	// Didn't look at all of it; let the parser decide.
+	return size - (filesize_t)filepos > max_scan;
+#endif
+}
+
 void
 ReadUserLog::outputFilePos( const char *pszWhereAmI )
 {
@@ -1413,6 +1516,7 @@ ReadUserLog::clear( void )
 	m_match = NULL;
     m_fd = -1;
 	m_fp = NULL;
+	m_complete_end = 0;
 	m_lock = NULL;
 	m_lock_rot = -1;
 
@@ -418,6 +418,13 @@ class ReadUserLog
     */
     ULogEventOutcome readEventNormal (ULogEvent * & event, FileLockBase *lock);
 
+	/** Check, without parsing, whether a complete old style event
+		(one terminated by a synch line) starts at or after filepos.
+		@param the current file position
+		@return false if the log holds only a partial event there
+	*/
+	bool haveCompleteEvent( long filepos );
+
 	/** Reopen the log file
 		@param Restore from state?
 		@return the outcome of the re-open attempt
@@ -463,6 +470,7 @@ class ReadUserLog
 
     int    				 m_fd;			  /** The log's file descriptor */
     FILE				*m_fp;			  /** The log's file pointer */
+	filesize_t			 m_complete_end;  /** Log holds complete events up to here */
 
 	bool				 m_close_file;	  /** Close file between operations? */
 	bool				 m_enable_close;  /** enable close operations? */
@@ -161,6 +161,10 @@ int ActualScheddQ::set_AttributeInt(int cluster, int proc, const char *attr, int
 	return SetAttributeInt(cluster, proc, attr, value, flags);
 }
 
+int ActualScheddQ::set_JobAttributes(int cluster, int proc, const std::vector<std::pair<std::string, std::string> > & attrs, SetAttributeFlags_t flags, int * failed_index) {
+	return SetJobAttributes(cluster, proc, attrs, flags, failed_index);
+}
+
 int ActualScheddQ::set_Factory(int cluster, int qnum, const char * filename, const char * text) {
 	return SetJobFactory(cluster, qnum, filename, text);
 }
@@ -12,6 +12,7 @@ public:
 	virtual int get_Capabilities(ClassAd& reply) = 0;
 	virtual int set_Attribute(int cluster, int proc, const char *attr, const char *value, SetAttributeFlags_t flags=0 ) = 0;
 	virtual int set_AttributeInt(int cluster, int proc, const char *attr, int value, SetAttributeFlags_t flags = 0 ) = 0;
+	virtual int set_JobAttributes(int cluster, int proc, const std::vector<std::pair<std::string, std::string> > & attrs, SetAttributeFlags_t flags = 0, int * failed_index = NULL ) = 0;
 	virtual int send_SpoolFile(char const *filename) = 0;
 	virtual int send_SpoolFileBytes(char const *filename) = 0;
 	virtual bool disconnect(bool commit_transaction, CondorError & errstack) = 0;
@@ -47,6 +48,7 @@ public:
 	virtual int get_Capabilities(ClassAd& reply);
 	virtual int set_Attribute(int cluster, int proc, const char *attr, const char *value, SetAttributeFlags_t flags=0 );
 	virtual int set_AttributeInt(int cluster, int proc, const char *attr, int value, SetAttributeFlags_t flags = 0 );
+	virtual int set_JobAttributes(int cluster, int proc, const std::vector<std::pair<std::string, std::string> > & attrs, SetAttributeFlags_t flags = 0, int * failed_index = NULL );
 	virtual int send_SpoolFile(char const *filename);
 	virtual int send_SpoolFileBytes(char const *filename);
 	virtual bool disconnect(bool commit_transaction, CondorError & errstack);
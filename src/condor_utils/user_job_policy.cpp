@@ -341,6 +341,8 @@ UserPolicy::UserPolicy()
 	: m_sys_periodic_hold(NULL)
 	, m_sys_periodic_release(NULL)
 	, m_sys_periodic_remove(NULL)
+	, m_sys_periodic_subcode()
+	, m_sys_periodic_reason()
 	, m_fire_subcode(0)
 #else
 	: m_ad(NULL)
@@ -374,6 +376,10 @@ void UserPolicy::ClearConfig()
 	delete m_sys_periodic_hold; m_sys_periodic_hold = NULL;
 	delete m_sys_periodic_release; m_sys_periodic_release = NULL;
 	delete m_sys_periodic_remove; m_sys_periodic_remove = NULL;
+	for (int ii = 0; ii <= SYS_POLICY_PERIODIC_REMOVE; ++ii) {
+		delete m_sys_periodic_subcode[ii]; m_sys_periodic_subcode[ii] = NULL;
+		delete m_sys_periodic_reason[ii]; m_sys_periodic_reason[ii] = NULL;
+	}
 }
 
 
@@ -406,6 +412,64 @@ void UserPolicy::Config()
 			delete m_sys_periodic_remove; m_sys_periodic_remove = NULL;
 		}
 	}
+
+	// parse the _SUBCODE and _REASON expressions for the system policies now
+	// rather than each time one of the policies fires.
+	const char * policy_names[SYS_POLICY_PERIODIC_REMOVE+1] = {
+		NULL, PARAM_SYSTEM_PERIODIC_HOLD, PARAM_SYSTEM_PERIODIC_RELEASE, PARAM_SYSTEM_PERIODIC_REMOVE
+	};
+	std::string param_name;
+	for (int ii = SYS_POLICY_PERIODIC_HOLD; ii <= SYS_POLICY_PERIODIC_REMOVE; ++ii) {
+		param_name = policy_names[ii]; param_name += "_SUBCODE";
+		expr_string.set(param(param_name.c_str()));
+		if (expr_string) {
+			ParseClassAdRvalExpr(expr_string, m_sys_periodic_subcode[ii]);
+		}
+		param_name = policy_names[ii]; param_name += "_REASON";
+		expr_string.set(param(param_name.c_str()));
+		if (expr_string) {
+			ParseClassAdRvalExpr(expr_string, m_sys_periodic_reason[ii]);
+		}
+	}
+}
+
+// returns true if the given job policy attribute exists and is not
+// a literal that AnalyzeSinglePeriodicPolicy would treat as false.
+static bool PolicyExprCanFire(ClassAd & ad, const char * attrname)
+{
+	ExprTree * expr = ad.Lookup(attrname);
+	if ( ! expr) {
+		return false;
+	}
+	classad::Value val;
+	long long ival = 1;
+	if (ExprTreeIsLiteral(expr, val)) {
+		if (val.IsUndefinedValue() || (val.IsNumber(ival) && ! ival)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool UserPolicy::HasPeriodicPolicy(ClassAd & ad)
+{
+	int state;
+	if ( ! ad.LookupInteger(ATTR_JOB_STATUS, state)) {
+		return true; // AnalyzePolicy will return UNDEFINED_EVAL
+	}
+	if (ad.Lookup(ATTR_TIMER_REMOVE_CHECK)) {
+		return true;
+	}
+	if (state != HELD) {
+		if (m_sys_periodic_hold || PolicyExprCanFire(ad, ATTR_PERIODIC_HOLD_CHECK)) {
+			return true;
+		}
+	} else {
+		if (m_sys_periodic_release || PolicyExprCanFire(ad, ATTR_PERIODIC_RELEASE_CHECK)) {
+			return true;
+		}
+	}
+	return m_sys_periodic_remove || PolicyExprCanFire(ad, ATTR_PERIODIC_REMOVE_CHECK);
 }
 
 void UserPolicy::ResetTriggers()
@@ -752,23 +816,18 @@ bool UserPolicy::AnalyzeSinglePeriodicPolicy(ClassAd & ad, const char * attrname
 			// fetch the unparsed value of the expression that fired.
 			ExprTreeToString(expr, m_fire_unparsed_expr);
 
-			// temp buffer for building _SUBCODE and _REASON param names.
-			char param_sub[sizeof("SYSTEM_PERIODIC_RELEASE_SUBCODE")+10];
-
-			std::string expr_string;
-			strcpy(param_sub, policy_name); strcat(param_sub, "_SUBCODE");
-			if (param(expr_string, param_sub, "") && ! expr_string.empty()) {
+			// evaluate the _SUBCODE and _REASON expressions parsed by Config()
+			if (m_sys_periodic_subcode[sys_policy]) {
 				long long ival;
 				classad::Value val;
-				if (ad.EvaluateExpr(expr_string, val) && val.IsNumber(ival)) {
+				if (ad.EvaluateExpr(m_sys_periodic_subcode[sys_policy], val) && val.IsNumber(ival)) {
 					m_fire_subcode = (int)ival;
 				}
 			}
 
-			strcpy(param_sub, policy_name); strcat(param_sub, "_REASON");
-			if (param(expr_string, param_sub, "") && ! expr_string.empty()) {
+			if (m_sys_periodic_reason[sys_policy]) {
 				classad::Value val;
-				if (ad.EvaluateExpr(expr_string, val) && val.IsStringValue(m_fire_reason)) {
+				if (ad.EvaluateExpr(m_sys_periodic_reason[sys_policy], val) && val.IsStringValue(m_fire_reason)) {
 					// val.IsStringValue will have already set m_fire_reason
 				}
 			}
@@ -232,6 +232,15 @@ class UserPolicy
 		   occurred, then false is returned. */
 		bool FiringReason(MyString &reason,int &reason_code,int &reason_subcode);
 
+	#ifdef USE_NON_MUTATING_USERPOLICY
+		/* Returns false if none of the expressions that AnalyzePolicy()
+			would evaluate in PERIODIC_ONLY mode can fire for this job,
+			i.e. they are all missing or literal false/undefined and there
+			is no system periodic policy.  Callers can then skip the periodic
+			evaluation altogether. This only does a few lookups in the ad. */
+		bool HasPeriodicPolicy(ClassAd & ad);
+	#endif
+
 	private: /* functions */
 		/* This function inserts the five of the six (all but TimerRemove) user
 			job policy expressions with default values into the classad if they
@@ -281,6 +290,9 @@ class UserPolicy
 		ExprTree * m_sys_periodic_hold;
 		ExprTree * m_sys_periodic_release;
 		ExprTree * m_sys_periodic_remove;
+		// parsed SYSTEM_PERIODIC_<policy>_SUBCODE and _REASON, indexed by SysPolicyId
+		ExprTree * m_sys_periodic_subcode[SYS_POLICY_PERIODIC_REMOVE+1];
+		ExprTree * m_sys_periodic_reason[SYS_POLICY_PERIODIC_REMOVE+1];
 		int m_fire_subcode;
 		std::string m_fire_reason;
 		std::string m_fire_unparsed_expr;
@@ -15,6 +15,7 @@
 #include "module_lock.h"
 #include "htcondor.h"
 #include "daemon_location.h"
+#include "columnar_query.h"
 
 using namespace boost::python;
 
@@ -174,6 +175,25 @@ struct Collector {
     }
 
 
+    boost::python::dict query_columns(AdTypes ad_type, boost::python::object constraint_obj, boost::python::list attrs, const std::string &statistics="")
+    {
+        ColumnarQueryResult columns(attrs);
+
+            // append each ad to the columns as it arrives, rather than
+            // collecting them all in a ClassAdList first.
+        columnar_query_helper helper;
+        helper.columns = &columns;
+        helper.ml = NULL;
+        fetch_internal(ad_type, constraint_obj, attrs, statistics, "", columnar_query_callback, &helper, &helper.ml);
+
+        if (PyErr_Occurred())
+        {
+            throw_error_already_set();
+        }
+        return columns.result();
+    }
+
+
     object locateAll(daemon_t d_type)
     {
         AdTypes ad_type = convert_to_ad_type(d_type);
@@ -345,7 +365,11 @@ struct Collector {
 
 private:
 
-    object query_internal(AdTypes ad_type, boost::python::object constraint_obj, boost::python::list attrs, const std::string &statistics, std::string locationName)
+    // Query the collectors, handing each ad to callback.  If held_lock is
+    // not NULL, it is pointed at the module lock held during the query, so
+    // that the callback can release it.
+    void fetch_internal(AdTypes ad_type, boost::python::object constraint_obj, boost::python::list attrs, const std::string &statistics, std::string locationName,
+        bool (*callback)(void*, ClassAd *), void *pv, condor::ModuleLock **held_lock = NULL)
     {
         std::string constraint;
         if ( ! convert_python_to_constraint(constraint_obj, constraint, true, NULL)) {
@@ -381,11 +405,13 @@ private:
             query.setDesiredAttrs(attrs_str);
         }
 
-        ClassAdList adList;
         QueryResult result;
         {
         condor::ModuleLock ml;
-        result = m_collectors->query(query, adList, NULL);
+        if (held_lock) { *held_lock = &ml; }
+        query.setWaitFunc(condor::ModuleLock::waitForReadable, &ml);
+        result = m_collectors->query(query, callback, pv, NULL);
+        if (held_lock) { *held_lock = NULL; }
         }
 
         switch (result)
@@ -408,6 +434,12 @@ private:
         default:
             THROW_EX(HTCondorInternalError, "Unknown error from collector query.");
         }
+    }
+
+    object query_internal(AdTypes ad_type, boost::python::object constraint_obj, boost::python::list attrs, const std::string &statistics, std::string locationName)
+    {
+        ClassAdList adList;
+        fetch_internal(ad_type, constraint_obj, attrs, statistics, locationName, CollectorList::fetchAds_callback, &adList);
 
         list retval;
         ClassAd * ad;
@@ -429,6 +461,7 @@ private:
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(advertise_overloads, advertise, 1, 3);
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(query_overloads, query, 0, 4);
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(query_columns_overloads, query_columns, 3, 4);
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(directquery_overloads, directquery, 1, 4);
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(locate_overloads, locate, 1, 2);
 
@@ -478,6 +511,37 @@ void export_collector()
             (boost::python::arg("ad_type")=ANY_AD, boost::python::arg("constraint")="", boost::python::arg("projection")=boost::python::list(), boost::python::arg("statistics")="")
 #else
             (boost::python::arg("self"), boost::python::arg("ad_type")=ANY_AD, boost::python::arg("constraint")="", boost::python::arg("projection")=boost::python::list(), boost::python::arg("statistics")="")
+#endif
+             ))
+        .def("query_columns", &Collector::query_columns, query_columns_overloads(
+            R"C0ND0R(
+            Query the contents of a condor_collector daemon, returning the results as columns.
+            Instead of a :class:`~classad.ClassAd` for each matching ad, this returns a
+            dictionary with one column per attribute of the projection, so that
+            the results can be passed directly to, for example, ``pandas.DataFrame``.
+
+            :param ad_type: The type of ClassAd to return.
+            :type ad_type: :class:`AdTypes`
+            :param constraint: A constraint for the collector query; only ads matching this constraint are returned.
+            :type constraint: str or :class:`~classad.ExprTree`
+            :param projection: The attributes to return; this may not be empty.
+                Each value is evaluated in the context of its ad, so an attribute
+                whose value is an expression comes back as the result of that
+                expression, where :meth:`query` would return the expression itself.
+                A column whose values are all integers is returned as an :class:`array.array`
+                of type ``'q'``, and one whose values are all numbers as an :class:`array.array`
+                of type ``'d'``, with ``NaN`` where a value is missing or evaluates to ``Undefined``.
+                Any other column is returned as a list, with ``None`` for missing values.
+            :type projection: list[str]
+            :param list[str] statistics: Statistics attributes to include, if they exist for the specified daemon.
+            :return: A dictionary mapping each attribute of the projection to its values,
+                one per matching ad.
+            :rtype: dict[str, array.array or list]
+            )C0ND0R",
+#if BOOST_VERSION < 103400
+            (boost::python::arg("ad_type"), boost::python::arg("constraint"), boost::python::arg("projection"), boost::python::arg("statistics")="")
+#else
+            (boost::python::arg("self"), boost::python::arg("ad_type"), boost::python::arg("constraint"), boost::python::arg("projection"), boost::python::arg("statistics")="")
 #endif
              ))
         .def("directQuery", &Collector::directquery, directquery_overloads(
@@ -0,0 +1,247 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "python_bindings_common.h"
+#include "condor_common.h"
+#include "condor_classad.h"
+#include "string_list.h"
+#include "old_boost.h"
+#include "htcondor.h"
+#include "module_lock.h"
+#include "columnar_query.h"
+
+#include <math.h>
+
+// from classad.cpp
+extern boost::python::object
+convert_value_to_python( const classad::Value & value );
+
+ColumnarQueryResult::ColumnarQueryResult(boost::python::list projection)
+{
+	int len_attrs = py_len(projection);
+	if ( ! len_attrs) {
+		THROW_EX(HTCondorValueError, "A projection is required for a columnar query.");
+	}
+	m_attrs.reserve(len_attrs);
+	m_columns.resize(len_attrs);
+	for (int i = 0; i < len_attrs; i++) {
+		std::string attr = boost::python::extract<std::string>(projection[i]);
+		m_attrs.push_back(attr);
+	}
+}
+
+void
+ColumnarQueryResult::projection(StringList & attrs) const
+{
+	for (size_t i = 0; i < m_attrs.size(); i++) {
+		attrs.append(m_attrs[i].c_str());
+	}
+}
+
+void
+ColumnarQueryResult::append(const classad::ClassAd & ad)
+{
+	classad::Value val;
+	long long ival;
+	double rval;
+	for (size_t i = 0; i < m_attrs.size(); i++) {
+		Column & column = m_columns[i];
+		if ( ! ad.EvaluateAttr(m_attrs[i], val) || val.IsUndefinedValue()) {
+			column.append_missing();
+		} else if (column.kind != Column::OBJECT && val.IsIntegerValue(ival)) {
+			column.append_integer(ival);
+		} else if (column.kind != Column::OBJECT && val.IsRealValue(rval)) {
+			column.append_real(rval);
+		} else {
+			column.append_object(convert_value_to_python(val));
+		}
+	}
+}
+
+boost::python::dict
+ColumnarQueryResult::result() const
+{
+	boost::python::dict columns;
+	for (size_t i = 0; i < m_attrs.size(); i++) {
+		columns[m_attrs[i]] = m_columns[i].result();
+	}
+	return columns;
+}
+
+void
+ColumnarQueryResult::Column::append_missing()
+{
+	switch (kind) {
+	case EMPTY:
+		break;
+	case INTEGER:
+		// there is no integer for missing, so the column becomes doubles and NaN
+		to_real();
+		// fall through
+	case REAL:
+		reals.push_back(NAN);
+		present.push_back(false);
+		break;
+	case OBJECT:
+		objects.append(boost::python::object());
+		break;
+	}
+	++rows;
+}
+
+void
+ColumnarQueryResult::Column::append_integer(long long val)
+{
+	if (kind == EMPTY) {
+		if (rows) {
+			// preceded by missing values, which only a column of doubles can hold
+			to_real();
+		} else {
+			kind = INTEGER;
+		}
+	}
+	if (kind == INTEGER) {
+		ints.push_back(val);
+	} else {
+		reals.push_back((double)val);
+		present.push_back(true);
+	}
+	++rows;
+}
+
+void
+ColumnarQueryResult::Column::append_real(double val)
+{
+	if (kind != REAL) {
+		to_real();
+	}
+	reals.push_back(val);
+	present.push_back(true);
+	++rows;
+}
+
+void
+ColumnarQueryResult::Column::append_object(const boost::python::object & obj)
+{
+	if (kind != OBJECT) {
+		to_object();
+	}
+	objects.append(obj);
+	++rows;
+}
+
+// convert the column, which is EMPTY or INTEGER, to doubles.
+void
+ColumnarQueryResult::Column::to_real()
+{
+	reals.reserve(rows + 1);
+	if (kind == INTEGER) {
+		for (size_t i = 0; i < ints.size(); i++) {
+			reals.push_back((double)ints[i]);
+		}
+		present.assign(rows, true);
+		std::vector<long long>().swap(ints);
+	} else if (kind == EMPTY) {
+		reals.assign(rows, NAN);
+		present.assign(rows, false);
+	}
+	kind = REAL;
+}
+
+// convert the values collected so far to python objects.
+void
+ColumnarQueryResult::Column::to_object()
+{
+	if (kind == INTEGER) {
+		for (size_t i = 0; i < ints.size(); i++) {
+			objects.append(ints[i]);
+		}
+		std::vector<long long>().swap(ints);
+	} else if (kind == REAL) {
+		for (size_t i = 0; i < reals.size(); i++) {
+			if (present[i]) {
+				objects.append(reals[i]);
+			} else {
+				objects.append(boost::python::object());
+			}
+		}
+		std::vector<double>().swap(reals);
+		std::vector<bool>().swap(present);
+	} else if (kind == EMPTY) {
+		for (size_t i = 0; i < rows; i++) {
+			objects.append(boost::python::object());
+		}
+	}
+	kind = OBJECT;
+}
+
+// returns an array.array for a column of numbers, and a list otherwise.
+static boost::python::object
+make_array(const char * typecode, const void * data, size_t size)
+{
+	boost::python::object array = boost::python::import("array").attr("array")(typecode);
+	boost::python::object bytes(boost::python::handle<>(PyBytes_FromStringAndSize((const char *)data, size)));
+#if PY_MAJOR_VERSION >= 3
+	array.attr("frombytes")(bytes);
+#else
+	array.attr("fromstring")(bytes);
+#endif
+	return array;
+}
+
+boost::python::object
+ColumnarQueryResult::Column::result() const
+{
+	switch (kind) {
+	case INTEGER:
+		return make_array("q", ints.data(), ints.size() * sizeof(ints[0]));
+	case REAL:
+		return make_array("d", reals.data(), reals.size() * sizeof(reals[0]));
+	case OBJECT:
+		return objects;
+	case EMPTY:
+		break;
+	}
+	boost::python::list missing;
+	for (size_t i = 0; i < rows; i++) {
+		missing.append(boost::python::object());
+	}
+	return missing;
+}
+
+bool
+columnar_query_callback(void * data, ClassAd * ad)
+{
+	columnar_query_helper *helper = static_cast<columnar_query_helper *>(data);
+	helper->ml->release();
+	if (PyErr_Occurred()) {
+		helper->ml->acquire();
+		return true;
+	}
+
+	try {
+		helper->columns->append(*ad);
+	} catch (boost::python::error_already_set &) {
+		// Suppress the C++ exception; PyErr_Occurred will be set and we will stop appending.
+	} catch (...) {
+		PyErr_SetString(PyExc_HTCondorInternalError, "Uncaught C++ exception encountered.");
+	}
+	helper->ml->acquire();
+	return true;
+}
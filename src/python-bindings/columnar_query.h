@@ -0,0 +1,93 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2021, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef _PYTHON_BINDINGS_COLUMNAR_QUERY_H
+#define _PYTHON_BINDINGS_COLUMNAR_QUERY_H
+
+#include <string>
+#include <vector>
+
+// Collects the results of a query as columns, one per attribute of the
+// projection, rather than as a list of ClassAd objects.  Each value is
+// evaluated in the context of its ad.  A column whose values are all integers
+// is kept in a vector of 64 bit integers, and one whose values are all numbers
+// in a vector of doubles, with NaN where the attribute is missing or undefined;
+// these are returned as python array.array objects, which support the buffer
+// protocol.  Any other column is converted to a python list, with None for
+// missing or undefined values.  The result can be passed directly to e.g.
+// pandas.DataFrame.
+class ColumnarQueryResult {
+	public:
+		// throws HTCondorValueError if the projection is empty
+		ColumnarQueryResult(boost::python::list projection);
+
+		// the projection as a StringList, for CondorQ
+		void projection(StringList & attrs) const;
+		// the projection as a vector, for CondorQuery
+		const std::vector<std::string> & projection() const { return m_attrs; }
+
+		// append one row from the given ad, the python GIL must be held.
+		void append(const classad::ClassAd & ad);
+
+		// returns a dict of attribute name -> array.array or list of values
+		boost::python::dict result() const;
+
+	private:
+		struct Column {
+			enum Kind { EMPTY, INTEGER, REAL, OBJECT };
+			Column() : kind(EMPTY), rows(0) {}
+			Kind kind;
+			size_t rows;                  // values appended so far
+			std::vector<long long> ints;  // the values, while kind is INTEGER
+			std::vector<double> reals;    // the values, while kind is REAL
+			std::vector<bool> present;    // which reals are values rather than missing
+			boost::python::list objects;  // the values, once kind is OBJECT
+
+			void append_missing();
+			void append_integer(long long val);
+			void append_real(double val);
+			void append_object(const boost::python::object & obj);
+			void to_real();
+			void to_object();
+			boost::python::object result() const;
+		};
+
+		std::vector<std::string> m_attrs;
+		std::vector<Column> m_columns;
+};
+
+namespace condor {
+class ModuleLock;
+}
+
+// For queries that hand each ad to a callback as it arrives: the columns to
+// append to, and the module lock held for the query, which the callback
+// releases while it touches python objects.
+struct columnar_query_helper
+{
+	ColumnarQueryResult *columns;
+	condor::ModuleLock *ml;
+};
+
+// The callback for CondorQ::fetchQueueFromHostAndProcess and
+// CollectorList::query; data is a columnar_query_helper.  Errors are left
+// set as the python exception, which the caller must check.
+bool columnar_query_callback(void * data, ClassAd * ad);
+
+#endif // _PYTHON_BINDINGS_COLUMNAR_QUERY_H
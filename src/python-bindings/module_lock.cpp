@@ -15,6 +15,7 @@
 #include "secman.h" // python bindings secman wrapper.
 
 #include "condor_config.h" // so we can do param mutation (ick)
+#include "selector.h"
 
 
 void ConfigOverrides::reset()
@@ -150,6 +151,29 @@ void ModuleLock::useFamilySession(const std::string & sess)
 	}
 }
 
+bool
+ModuleLock::waitForReadable(Sock * sock)
+{
+    Selector selector;
+    selector.add_fd(sock->get_file_desc(), Selector::IO_READ);
+    int timeout = sock->timeout(0); sock->timeout(timeout);
+    timeout = timeout ? timeout : 20;
+    selector.set_timeout(timeout);
+
+    release();
+    Py_BEGIN_ALLOW_THREADS
+    selector.execute();
+    Py_END_ALLOW_THREADS
+    acquire();
+    return !selector.timed_out() && !selector.failed();
+}
+
+bool
+ModuleLock::waitForReadable(void * lock, Sock * sock)
+{
+    return static_cast<ModuleLock *>(lock)->waitForReadable(sock);
+}
+
 void
 ModuleLock::release()
 {
@@ -44,6 +44,8 @@ private:
 	bool auto_free;
 };
 
+class Sock;
+
 namespace condor {
 
 class ModuleLock {
@@ -57,6 +59,13 @@ public:
     static void initialize();
     void useFamilySession(const std::string & sess);
 
+    // Wait until sock is readable, holding neither the lock nor the GIL
+    // meanwhile, so that other threads can use the bindings.  Returns false
+    // on timeout or error.  The static version, with the lock as data, is
+    // for the wait callbacks of CondorQ and CondorQuery.
+    bool waitForReadable(Sock * sock);
+    static bool waitForReadable(void * lock, Sock * sock);
+
 private:
 
     bool m_release_gil;
@@ -38,6 +38,7 @@
 #include "condor_arglist.h"
 #include "my_popen.h"
 #include "history_iterator.h"
+#include "columnar_query.h"
 
 #include <algorithm>
 #include <string>
@@ -1467,6 +1468,7 @@ struct Schedd {
         {
             condor::ModuleLock ml;
             helper.ml = &ml;
+            q.setWaitFunc(condor::ModuleLock::waitForReadable, &ml);
             fetchResult = q.fetchQueueFromHostAndProcess(m_addr.c_str(), attrs_list, fetch_opts, match_limit, query_process_callback, helper_ptr, 2, &errstack, p_summary_ad);
 			if (summary_ad) {
 				query_process_callback(helper_ptr,summary_ad);
@@ -1501,6 +1503,59 @@ struct Schedd {
         return retval;
     }
 
+    boost::python::dict query_columns(boost::python::object constraint_obj, list attrs, int match_limit=-1, CondorQ::QueryFetchOpts fetch_opts=CondorQ::fetch_Jobs)
+    {
+        std::string constraint;
+        if ( ! convert_python_to_constraint(constraint_obj, constraint, true, NULL)) {
+            THROW_EX(HTCondorValueError, "Invalid constraint.");
+        }
+
+        ColumnarQueryResult columns(attrs);
+
+        CondorQ q;
+
+        if (constraint.size())
+            q.addAND(constraint.c_str());
+
+        StringList attrs_list(NULL, "\n");
+        columns.projection(attrs_list);
+
+        int fetchResult;
+        CondorError errstack;
+        {
+            columnar_query_helper helper;
+            helper.columns = &columns;
+            condor::ModuleLock ml;
+            helper.ml = &ml;
+            q.setWaitFunc(condor::ModuleLock::waitForReadable, &ml);
+            fetchResult = q.fetchQueueFromHostAndProcess(m_addr.c_str(), attrs_list, fetch_opts, match_limit, columnar_query_callback, &helper, 2, &errstack, NULL);
+        }
+
+        if (PyErr_Occurred())
+        {
+            throw_error_already_set();
+        }
+
+        switch (fetchResult)
+        {
+        case Q_OK:
+            break;
+        case Q_PARSE_ERROR:
+        case Q_INVALID_CATEGORY:
+            THROW_EX(ClassAdParseError, "Parse error in constraint.");
+            break;
+        case Q_UNSUPPORTED_OPTION_ERROR:
+            THROW_EX(HTCondorIOError, "Query fetch option unsupported by this schedd.");
+            break;
+        default:
+            std::string errmsg = "Failed to fetch ads from schedd, errmsg=" + errstack.getFullText();
+            THROW_EX(HTCondorIOError, errmsg.c_str());
+            break;
+        }
+
+        return columns.result();
+    }
+
     void reschedule()
     {
         DCSchedd schedd(m_addr.c_str());
@@ -3800,6 +3855,7 @@ boost::python::object Schedd::submit(boost::python::object submitObj, int count/
 MACRO_SOURCE Submit::EmptyMacroSrc = { false, false, 3, -2, -1, -2 };
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(query_overloads, query, 0, 5);
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(query_columns_overloads, query_columns, 2, 4);
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(submit_overloads, submit, 1, 5);
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(transaction_overloads, transaction, 0, 2);
 
@@ -4015,6 +4071,43 @@ void export_schedd()
             (boost::python::arg("constraint")="true", boost::python::arg("projection")=boost::python::list(), boost::python::arg("callback")=boost::python::object(), boost::python::arg("limit")=-1, boost::python::arg("opts")=CondorQ::fetch_Jobs)
 #else
             (boost::python::arg("self"), boost::python::arg("constraint")="true", boost::python::arg("projection")=boost::python::list(), boost::python::arg("callback")=boost::python::object(), boost::python::arg("limit")=-1, boost::python::arg("opts")=CondorQ::fetch_Jobs)
+#endif
+            ))
+        .def("query_columns", &Schedd::query_columns, query_columns_overloads(
+            R"C0ND0R(
+            Query the *condor_schedd* daemon for job ads, returning the results as columns.
+
+            Instead of a :class:`~classad.ClassAd` for each job, this returns a
+            dictionary with one column per attribute of the projection, so that
+            the results can be passed directly to, for example, ``pandas.DataFrame``.
+            No :class:`~classad.ClassAd` is created for each job, and a column of
+            numbers is returned as an :class:`array.array` rather than as a list
+            of Python objects, which makes this much cheaper than :meth:`query`
+            for queries that return many jobs.
+
+            :param constraint: A query constraint.
+                Only jobs matching this constraint will be returned.
+            :type constraint: str or :class:`~classad.ExprTree`
+            :param projection: The attributes to return; this may not be empty.
+                Each value is evaluated in the context of its job ad, so an attribute
+                whose value is an expression comes back as the result of that
+                expression, where :meth:`query` would return the expression itself.
+                A column whose values are all integers is returned as an :class:`array.array`
+                of type ``'q'``, and one whose values are all numbers as an :class:`array.array`
+                of type ``'d'``, with ``NaN`` where a value is missing or evaluates to ``Undefined``.
+                Any other column is returned as a list, with ``None`` for missing values.
+            :type projection: list[str]
+            :param int limit: The maximum number of jobs to return; the default (``-1``) is to return all jobs.
+            :param opts: Additional flags for the query; these may affect the behavior of the *condor_schedd*.
+            :type opts: :class:`QueryOpts`.
+            :return: A dictionary mapping each attribute of the projection to its values,
+                one per matching job.
+            :rtype: dict[str, array.array or list]
+            )C0ND0R",
+#if BOOST_VERSION < 103400
+            (boost::python::arg("constraint"), boost::python::arg("projection"), boost::python::arg("limit")=-1, boost::python::arg("opts")=CondorQ::fetch_Jobs)
+#else
+            (boost::python::arg("self"), boost::python::arg("constraint"), boost::python::arg("projection"), boost::python::arg("limit")=-1, boost::python::arg("opts")=CondorQ::fetch_Jobs)
 #endif
             ))
         .def("xquery", &Schedd::xquery,